@@ -20,9 +20,13 @@ if( C_COMPILER_NAME MATCHES "gcc" OR C_COMPILER_NAME MATCHES "clang" )
   set( CMAKE_C_FLAGS_PROFILE "-g -gp" )
   
   
+  # HOST_OPT overrules SSE42, as for icc:
   if(WANT_SSE42 )
     set( SSE_FLAGS "-msse4.2" )
   endif(WANT_SSE42 )
+  if(WANT_HOST_OPT)
+    set( SSE_FLAGS "-march=native" )
+  endif(WANT_HOST_OPT)
   
   if( WANT_OPENMP )
     set( OPENMP_FLAGS "-fopenmp" )
@@ -142,6 +146,16 @@ endif( C_COMPILER_NAME MATCHES "gcc" OR C_COMPILER_NAME MATCHES "clang" )
 #  Put everything together:
 ######################################################################################################################################################
 
+# Compiler-independent checks:  count heap allocations in the likelihood (see heapAllocations() in SPINspiral_routines.c):
+if( WANT_CHECKS )
+  set( CHECK_FLAGS "${CHECK_FLAGS} -DSPINSPIRAL_CHECKS" )
+endif( WANT_CHECKS )
+
+# Compiler-independent:  flag the LAL waveforms thread safe if LAL was built with pthread locks (see FindLAL.cmake and SPINspiral_templates.c):
+if( LAL_THREAD_SAFE )
+  set( PACKAGE_FLAGS "${PACKAGE_FLAGS} -DSPINSPIRAL_LAL_THREADSAFE" )
+endif( LAL_THREAD_SAFE )
+
 set( USER_FLAGS "${OPT_FLAGS} ${LIB_FLAGS} ${CHECK_FLAGS} ${WARN_FLAGS} ${SSE_FLAGS} ${IPO_FLAGS} ${OPENMP_FLAGS} ${STATIC_FLAGS} ${INCLUDE_FLAGS} ${PACKAGE_FLAGS}" )
 
 set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS_ALL} ${CMAKE_C_FLAGS} ${USER_FLAGS}" )
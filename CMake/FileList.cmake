@@ -5,6 +5,7 @@ set(SPINspiral_src_files
   src/SPINspiral_main.c  
   src/SPINspiral_mcmc.c  
   src/SPINspiral_parameters.c  
+  src/SPINspiral_roq.c  
   src/SPINspiral_routines.c  
   src/SPINspiral_signal.c  
   src/SPINspiral_templates.c
@@ -5,7 +5,7 @@
 # This CMake module defines the following variables:
 #  FFTW3_FOUND        =  Libraries and headers found; TRUE/FALSE
 #  FFTW3_INCLUDES     =  Path to the FFTW3 header files
-#  FFTW3_LIBRARIES    =  Path to all parts of the FFTW3 libraries
+#  FFTW3_LIBRARIES    =  Path to all parts of the FFTW3 libraries (double and single precision)
 #  FFTW3_LIBRARY_DIR  =  Path to the directory containing the FFTW3 libraries
 
 
@@ -34,13 +34,20 @@ find_library( FFTW3_LIBRARY
   NO_DEFAULT_PATH
   )
 
+find_library( FFTW3F_LIBRARY
+  NAMES fftw3f
+  PATHS ${lib_locations}
+  #PATH_SUFFIXES 
+  NO_DEFAULT_PATH
+  )
+
 # Libraries found?
-if( FFTW3_LIBRARY )
+if( FFTW3_LIBRARY AND FFTW3F_LIBRARY )
   
-  list( APPEND FFTW3_LIBRARIES ${FFTW3_LIBRARY} )
+  list( APPEND FFTW3_LIBRARIES ${FFTW3_LIBRARY} ${FFTW3F_LIBRARY} )
   get_filename_component( FFTW3_LIBRARY_DIR ${FFTW3_LIBRARY} PATH )
   
-endif( FFTW3_LIBRARY )
+endif( FFTW3_LIBRARY AND FFTW3F_LIBRARY )
 
 
 
@@ -95,6 +102,7 @@ mark_as_advanced(
   FFTW3_INCLUDES
   FFTW3_LIBRARIES
   FFTW3_LIBRARY
+  FFTW3F_LIBRARY
   FFTW3_LIBRARY_DIR
   )
 
@@ -7,6 +7,7 @@
 #  LAL_INCLUDES     =  Path to the LAL header files
 #  LAL_LIBRARIES    =  Path to all parts of the LAL libraries
 #  LAL_LIBRARY_DIR  =  Path to the directory containing the LAL libraries
+#  LAL_THREAD_SAFE  =  LAL was configured with --enable-pthread-lock (LAL_PTHREAD_LOCK in LALConfig.h); TRUE/FALSE
 
 
 
@@ -73,11 +74,22 @@ endif( LAL_INCLUDES AND LAL_LIBRARIES )
 # Headers AND libraries found!
 if( LAL_FOUND )
   
+  # Was LAL built thread safe, i.e. with its memory bookkeeping and XLAL error state protected by pthread locks?
+  include( CheckSymbolExists )
+  set( CMAKE_REQUIRED_INCLUDES ${LAL_INCLUDES} ${LAL_INCLUDES}/.. )
+  check_symbol_exists( LAL_PTHREAD_LOCK "lal/LALConfig.h" LAL_THREAD_SAFE )
+  unset( CMAKE_REQUIRED_INCLUDES )
+  
   if( NOT LAL_FIND_QUIETLY )
     message( STATUS "" )
     message( STATUS "Found components for LAL:" )
     message( STATUS "* LAL_INCLUDES  = ${LAL_INCLUDES}" )
     message( STATUS "* LAL_LIBRARIES = ${LAL_LIBRARIES}" )
+    if( LAL_THREAD_SAFE )
+      message( STATUS "* LAL is thread safe (LAL_PTHREAD_LOCK):  the LAL waveforms can be computed on several threads" )
+    else( LAL_THREAD_SAFE )
+      message( STATUS "* LAL is not thread safe (configure LAL with --enable-pthread-lock):  the LAL waveforms run on a single thread" )
+    endif( LAL_THREAD_SAFE )
   endif( NOT LAL_FIND_QUIETLY )
   
 else( LAL_FOUND )
@@ -96,5 +108,6 @@ mark_as_advanced(
   LAL_LIBRARIES
   LAL_LIBRARY
   LAL_LIBRARY_DIR
+  LAL_THREAD_SAFE
   )
 
@@ -45,13 +45,19 @@
 #include <remez.h>   // FIR-filter design routine:  www.janovetz.com/jake              
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
+#include <gsl/gsl_sf_bessel.h>
 #include <sys/time.h>
 #include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <lal/LALStdlib.h>
 #include <lal/LALInspiral.h>
 #include <lal/GeneratePPNInspiral.h>
 #include <lal/GenerateInspiral.h>
+#include <lal/SimulateCoherentGW.h>
+#include <lal/LALDetectors.h>
 #include <lal/LALFrameL.h>
 #include <lal/LALConstants.h>
 
@@ -66,6 +72,37 @@
 #define c3rd  0.3333333333333333333  // 1/3
 #define M0 4.926e-6 //Solar mass in seconds
 
+#define apoBlockSize 64  // Number of samples per block in templateApostolatos()
+#define taperCacheSize 8  // Number of template lengths in the per-IFO cache of taper windows, see taperTemplate()
+#define bandFFTmaxSplit 64  // Largest number of sub-transforms tried for the pruned template FFT, see setBandFFT()
+#define singlePrecisionTestSize 100  // Number of parameter sets in compareSinglePrecision()
+#define scratchAlign 64  // Blocks in the per-IFO scratch arena are multiples of this many bytes, see scratchAlloc()
+#define threadTestSize 1000  // Number of parameter sets in compareThreadedLikelihood()
+#define overlapBenchmarkSize 1000  // Number of repetitions in benchmarkOverlaps()
+#define extrinsicTestSize 1000  // Number of parameter sets in compareExtrinsicLikelihood()
+#define apostolatosTestSize 100  // Number of parameter sets in compareApostolatosTemplates()
+#define nUpdateTypes 5  // MCMC update types:  single-parameter, block, correlated, multiple-try correlated and differential evolution, see updateChain()
+#define deHistorySize 1000  // Number of past states per chain in the ring buffer for differential-evolution updates, see storeDEhistory()
+#define deHistoryThin 10  // Store every deHistoryThin-th state of a chain in that buffer
+
+// Capabilities of a waveform backend (struct waveformBackend), which the likelihood code uses to choose how to evaluate it:
+#define wfFrequencyDomain  1  // computed in the frequency domain, for the band only:  no time-domain template or FFT
+#define wfDistanceScaling  2  // the amplitude scales as 1/d_L:  <d|h> and <h|h> can be rescaled for distance-only proposals
+#define wfThreadSafe       4  // templates can be computed on several threads at once, each with its own copy of the network
+#define wfSupport          8  // records the support of the time-domain template in FTin (see setTemplateSupport())
+#define wfPolarisations   16  // h_+,h_x do not depend on the detector and can be computed once for the network
+#define wfTaper           32  // the time-domain template must be windowed by taperTemplate()
+#define wfMultirate       64  // can be computed at a reduced sampling rate far from coalescence
+#define wfExtrinsic      128  // h(f) = u(f) E exp(-2 pi i f t_c):  a cached intrinsic template u serves all extrinsic proposals, see extrinsicLogLikelihood()
+#define wfPhaseFactor    256  // phi_c enters as an overall factor exp(i m phi_c) of h(f>0):  the likelihood can be marginalised over phi_c
+
+// The LAL waveforms are thread safe only if LAL was built with pthread locks (LAL_PTHREAD_LOCK, see CMake/FindLAL.cmake):
+#ifdef SPINSPIRAL_LAL_THREADSAFE
+#define wfLALThreadSafe  wfThreadSafe
+#else
+#define wfLALThreadSafe  0
+#endif
+
 #define max(A,B) ((A)>(B)?(A):(B))
 #define min(A,B) ((A)<(B)?(A):(B))
 
@@ -112,8 +149,18 @@ example: ./lalapps_spinspiral -i ./pipeline/SPINspiral.input --mChirp 1.7 --eta
 
 
 
-// Global constants, assigned in setConstants()
-extern double Ms,Mpc,G,c,Mpcs,pi,tpi,mtpi;
+// Global constants.  These are compile-time constants, so that the compiler can fold them into the template loops:
+// Mathematical constants:
+static const double pi        = 3.141592653589793;   // pi
+static const double tpi       = 6.283185307179586;   // 2 pi
+static const double mtpi      = 6.283185307179586e6; // Large multiple of 2 pi (2 megapi)
+
+// Physical constants:
+static const double gravConst = 6.67259e-11;         // 6.674215e-11; */ /* gravity constant (SI)
+static const double cLight    = 299792458.0;         // speed of light (m/s)
+static const double Ms        = 1.9889194662e30;     // solar mass (kg)
+static const double Mpc       = 3.08568025e22;       // metres in a Mpc  (LAL: 3.0856775807e22)
+static const double Mpcs      = 1.029272137e14;      // seconds in a Mpc  (Mpc/c)
 // *** PLEASE DON'T ADD ANY NEW ONES, BUT USE THE STRUCTS BELOW INSTEAD (e.g. runPar or MCMCvariables) ***
 
 
@@ -131,6 +178,34 @@ extern double Ms,Mpc,G,c,Mpcs,pi,tpi,mtpi;
 
 
 
+// Structure with the (read-only) run parameters needed to compute templates and likelihoods.
+// This is a small subset of runPar, set up once in setLikelihoodPar(), and passed by pointer through the likelihood and
+// template routines, so that the large runPar struct does not have to be copied for every template.
+struct likelihoodPar{
+  int nMCMCpar;                   // Number of parameters in the MCMC template
+  int nInjectPar;                 // Number of parameters in the injection template
+  double mcmcPNorder;             // pN order of the MCMC waveform
+  double injectionPNorder;        // pN order of the injection waveform
+  double tukey1;                  // alpha1, the 1st parameter of the template Tukey window
+  double tukey2;                  // alpha2, the 2nd parameter of the template Tukey window
+  int marginaliseTime;            // Marginalise (1) or maximise (2) the likelihood over t_c with an inverse FFT, rather than sampling t_c (0)
+  double tMargLow, tMargUp;       // Prior range of t_c for that marginalisation
+  int marginalisePhaseDist;       // Marginalise the likelihood analytically over phi_c (1), d_L (2) or both (3), rather than sampling them (0)
+  int distMargN;                  // Number of distances in the lookup table for the distance marginalisation
+  double *distMargD;              // Distances (Mpc) in that table, evenly spaced in log(d_L) over the prior range
+  double *distMargLogW;           // Log of the prior weights of those distances, normalised to a sum of 1
+  double multirateAccuracy;       // Relative accuracy of the multirate Apostolatos template;  0: compute all samples
+  double multirateCycles;         // Distance between the multirate knots in GW cycles, set by setMultirateTemplate();  0: compute all samples
+  
+  int parRevID[200];              // Reverse MCMC parameter identifier
+  int injRevID[200];              // Reverse injection parameter identifier
+  int mcmcParUse[200];            // Indicates whether a parameter is being used (1) or not (0) for MCMC
+  int injParUse[200];             // Indicates whether a parameter is being used (1) or not (0) for the injection
+};  // End struct likelihoodPar
+
+
+
+
 // Structure with run parameters.  
 // This should eventually include all variables in the input files and replace many of the global variables.
 // That also means that this struct must be passed throughout much of the code.
@@ -157,6 +232,7 @@ struct runPar{
   
   int correlatedUpdates;          // Switch to do correlated update proposals
   int nCorr;                      // Number of iterations for which the covariance matrix is calculated
+  int corrRefresh;                // Number of iterations between updates of the proposal matrix from the running covariance matrix
   int prMatrixInfo;               // Print information to screen on proposed matrix updates
   
   double annealTemp0;             // Starting temperature of the annealed chain
@@ -167,9 +243,28 @@ struct runPar{
   double maxTemp;                 // Maximum temperature in automatic parallel-tempering ladder
   int saveHotChains;              // Save hot (T>1) parallel-tempering chains
   int prParTempInfo;              // Print information on the temperature chains
+  int nThreads;                   // Number of threads to update the temperature chains on (0: one per chain, up to the number of processors)
+  
+  int likelihoodCache;            // Reuse <d|h> and <h|h> for distance-only proposals and the intrinsic template for extrinsic proposals: 0-no, 1-yes, 2-yes and verify
+  int relativeBinning;            // Use the relative-binning likelihood (frequency-domain templates only): 0-no, 1-yes
+  double relBinEpsilon;           // Maximum phase difference (rad) of the relative-binning bins
+  int relBinCheck;                // Check the relative-binning likelihood against the full likelihood every relBinCheck iterations (0: never)
+  double relBinTolerance;         // Recompute the summary data around the best parameters if the check differs by more than this in log(L)
+  int likelihoodROQ;              // Use the reduced-order-quadrature likelihood: 0-no, 1-yes, read the basis from roqFilename, 2-build the basis and save it to roqFilename
+  char roqFilename[99];           // Binary file with the ROQ basis
+  int roqTrainingSize;            // Number of random templates drawn from the prior ranges to build the ROQ basis
+  double roqTolerance;            // Build the ROQ basis until the maximum squared projection error of the training templates is below this value
+  int marginaliseTime;            // Marginalise (1) or maximise (2) the likelihood over t_c with an inverse FFT, rather than sampling t_c (0)
+  double tMargLow, tMargUp;       // Prior range of t_c for that marginalisation
+  int marginalisePhaseDist;       // Marginalise the likelihood analytically over phi_c (1), d_L (2) or both (3), rather than sampling them (0)
+  double multirateAccuracy;       // Relative accuracy of the multirate Apostolatos template;  0: compute all samples
+  int singlePrecision;            // FFT and overlaps of time-domain templates in single precision: 0-no, 1-yes, 2-compare with double precision and quit
 
   double blockFrac;               // Fraction of non-correlated updates that is a block update
   double corrFrac;                // Fraction of MCMC updates that used the correlation matrix
+  double deFrac;                  // Fraction of uncorrelated MCMC updates that is a differential-evolution update
+  double mtmFrac;                 // Fraction of correlated updates that is a multiple-try Metropolis update
+  int mtmCandidates;              // Number of candidates K of a multiple-try Metropolis update
   double matAccFr;                // The fraction of diagonal elements that must improve in order to accept a new covariance matrix
   
   double netsnr;                  // Total SNR of the network
@@ -271,7 +366,8 @@ struct runPar{
   double PSDstart;                // GPS start of the PSD
 	
   char channelname[3][99];        // Name of the channels from command line
-	
+  
+  struct likelihoodPar likePar;   // Read-only copy of the run parameters needed for templates and likelihoods, set in setLikelihoodPar()
 };  // End struct runpar
 
 
@@ -284,7 +380,6 @@ struct MCMCvariables{
   int iIter;                      // State/iteration number
   int nParFit;                    // Number of parameters in the MCMC that is fitted for
   int nTemps;                     // Number of chains in the temperature ladder
-  int iTemp;                      // The current temperature index
   int networkSize;                // Number of IFOs in the detector network
   int mcmcWaveform;               // Waveform used as the MCMC template
   double mcmcPNorder;             // pN order of the MCMC waveform
@@ -304,6 +399,7 @@ struct MCMCvariables{
   
   int correlatedUpdates;          // Switch to do correlated update proposals
   int nCorr;                      // Number of iterations for which the covariance matrix is calculated
+  int corrRefresh;                // Number of iterations between updates of the proposal matrix from the running covariance matrix
   int prMatrixInfo;               // Print information to screen on proposed matrix updates
   
   double annealTemp0;             // Starting temperature of the annealed chain
@@ -314,13 +410,29 @@ struct MCMCvariables{
   double maxTemp;                 // Maximum temperature in automatic parallel-tempering ladder
   int saveHotChains;              // Save hot (T>1) parallel-tempering chains
   int prParTempInfo;              // Print information on the temperature chains
+  int nThreads;                   // Number of threads to update the temperature chains on (0: one per chain, up to the number of processors)
+  
+  int likelihoodCache;            // Reuse <d|h> and <h|h> for distance-only proposals and the intrinsic template for extrinsic proposals: 0-no, 1-yes, 2-yes and verify
+  int distParIndex;               // Index of the distance parameter in param[][] for which the overlaps can be rescaled (-1: none)
+  int distParID;                  // Parameter ID of that distance parameter: 21 (d_L^3) or 22 (log d_L)
+  int extrinsicCache;             // Compute proposals that change extrinsic parameters only from a cached intrinsic template (see extrinsicLogLikelihood())
+  int parExtrinsic[20];           // 1 for the extrinsic parameters in param[], see extrinsicParameter()
+  int intrinsicBins;              // Frequency bins in the bands of all IFOs, i.e. the size of a cached intrinsic template (in complex numbers)
+  int relativeBinning;            // Use the relative-binning likelihood (frequency-domain templates only): 0-no, 1-yes
+  int relBinCheck;                // Check the relative-binning likelihood against the full likelihood every relBinCheck iterations (0: never)
+  double relBinTolerance;         // Recompute the summary data around the best parameters if the check differs by more than this in log(L)
+  int marginaliseTime;            // Marginalise (1) or maximise (2) the likelihood over t_c with an inverse FFT, rather than sampling t_c (0)
+  double *tMargPost;              // Sum over the saved T=1 states of the conditional posterior of the t_c shifts (see accumulateTimePosterior())
+  int tMargPostLow, tMargPostN;   // Index of the first time shift in tMargPost, and number of shifts
+  int tMargPostCount;             // Number of states in tMargPost
+  int marginalisePhaseDist;       // Marginalise the likelihood analytically over phi_c (1), d_L (2) or both (3), rather than sampling them (0)
   
-  
-  
-  double chTemp;                  // The current chain temperature
   double tempOverlap;             // Overlap between sinusoidal chain temperatures
   double blockFrac;               // Fraction of non-correlated updates that is a block update
   double corrFrac;                // Fraction of MCMC updates that used the correlation matrix
+  double deFrac;                  // Fraction of uncorrelated MCMC updates that is a differential-evolution update
+  double mtmFrac;                 // Fraction of correlated updates that is a multiple-try Metropolis update
+  int mtmCandidates;              // Number of candidates K of a multiple-try Metropolis update
   double matAccFr;                // The fraction of diagonal elements that must improve in order to accept a new covariance matrix
   double baseTime;                // Base of time measurement, get rid of long GPS time format
   
@@ -336,6 +448,7 @@ struct MCMCvariables{
   int injID[20];                  // Unique parameter identifier
   double parBestVal[20];          // Best known value for each parameter
   int parFix[20];                 // Fix an MCMC parameter or not
+  int parFree[20];                // Indices of the nParFit free (non-fixed) parameters in param[];  see allocateMCMCvariables()
   int parStartMCMC[20];           // Method of choosing starting value for Markov chains
   double injParVal[20];           // Injection value for each parameter
   double parSigma[20];            // Width of Gaussian distribution for offset start and first correlation matrix
@@ -357,40 +470,17 @@ struct MCMCvariables{
   int beVerbose;                  // Be verbose: 0-print progress only; 1-add basic details (default), 2-add a lot of details
   
   
-  double *histMean;               // Mean of hist block of iterations, used to get the covariance matrix
-  double *histDev;                // Standard deviation of hist block of iterations, used to get the covariance matrix
-  
-  int *corrUpdate;                // Switch (per chain) to do correlated (1) or uncorrelated (0) updates
-  int *acceptElems;               // Count 'improved' elements of diagonal of new corr matrix, to determine whether to accept it
-  
   double tempLadder[99];          // Array of temperatures in the temperature ladder
   double *tempAmpl;               // Temperature amplitudes for sinusoid T in parallel tempering
-  double *logL;                   // Current log(L)
-  double *nlogL;                  // New log(L)
-  double *dlogL;                  // log(L)-log(Lo)
-  double *maxdlogL;               // Remember the maximum dlog(L)
-  
-  
-  double *corrSig;                // Sigma for correlated update proposals
   int *swapTs1;                   // Totals for the columns in the chain-swap matrix
   int *swapTs2;                   // Totals for the rows in the chain-swap matrix                                               
-  int *acceptPrior;               // Check boundary conditions and choose to accept (1) or not(0)
-  int *iHist;                     // Count the iteration number in the current history block to calculate the covar matrix from
-  
-  int **accepted;                 // Count accepted proposals
   int **swapTss;                  // Count swaps between chains
-  double **param;                 // The current parameters for all chains
-  double **nParam;                // The new parameters for all chains
-  double **maxLparam;             // The best parameters for all chains (max logL)
-  double **adaptSigma;            // The standard deviation of the gaussian to draw the jump size from
-  double **adaptSigmaOut;         // The sigma that gets written to output
-  double **adaptScale;            // The rate of adaptation
+  int mtmThreads;                 // Number of threads to compute the likelihoods of the multiple-try candidates on
   
-  double ***hist;                 // Store a block of iterations, to calculate the covariance matrix
-  double ***covar;                // The Cholesky-decomposed covariance matrix
+  struct MCMCchain *chain;        // The state of the nTemps (temperature) chains, see struct MCMCchain
   
   int seed;                       // MCMC seed
-  gsl_rng *ran;                   // GSL random-number seed
+  gsl_rng *ran;                   // GSL random-number seed;  the random-number stream of the T=1 chain
   
   FILE *fout;                     // Output-file pointer
   FILE **fouts;                   // Output-file pointer array
@@ -398,6 +488,66 @@ struct MCMCvariables{
 
 
 
+//Structure for the state of a single (temperature) Markov chain.  The settings in struct MCMCvariables are shared by all chains, and 
+//  are read only while the chains are updated (see updateChain()), so that the chains can be updated on separate threads
+struct MCMCchain{
+  int iTemp;                      // Index of the chain in the temperature ladder
+  double chTemp;                  // The current chain temperature
+  gsl_rng *ran;                   // Random-number stream of the chain
+  
+  double *param;                  // The current parameters
+  double *nParam;                 // The new parameters
+  double *maxLparam;              // The best parameters (max logL)
+  double logL;                    // Current log(L)
+  double nlogL;                   // New log(L)
+  double dlogL;                   // log(L)-log(Lo)
+  double maxdlogL;                // Remember the maximum dlog(L)
+  int acceptPrior;                // Check boundary conditions and choose to accept (1) or not(0)
+  int *accepted;                  // Count accepted proposals
+  
+  double *adaptSigma;             // The standard deviation of the gaussian to draw the jump size from
+  double *adaptSigmaOut;          // The sigma that gets written to output
+  double *adaptScale;             // The rate of adaptation
+  double corrSig;                 // Sigma for correlated update proposals
+  
+  int corrUpdate;                 // Switch to do correlated (1) or uncorrelated (0) updates
+  int acceptElems;                // Count 'improved' elements of diagonal of new corr matrix, to determine whether to accept it
+  int iHist;                      // Count the iterations since the latest covariance-matrix update
+  double *histMean;               // Running mean of the chain, at the latest covariance-matrix update
+  double *histDev;                // Running standard deviation of the chain, at the latest covariance-matrix update
+  int covN;                       // Number of states in the running covariance matrix
+  double *covMean;                // Running mean of the states
+  double **covChol;               // The Cholesky-decomposed running covariance matrix of the states, see accumulateCovariance()
+  double **covar;                 // The Cholesky-decomposed covariance matrix
+  
+  int deN;                        // Number of states in the differential-evolution history (at most deHistorySize)
+  int deNext;                     // Position in the ring buffer where the next state is stored
+  double *deHist;                 // Ring buffer of past states, deHist[i*nParFit+k] for free parameter k of state i
+  
+  int cacheValid;                 // 1 if cacheHD, cacheHH and cachePar below describe the current state
+  double cacheHD;                 // Network <d|h> of the current state
+  double cacheHH;                 // Network <h|h> of the current state
+  double *cachePar;               // Parameter values for which cacheHD and cacheHH were computed
+  double nOverlapHD;              // Network <d|h> of the latest proposal
+  double nOverlapHH;              // Network <h|h> of the latest proposal
+  
+  int intrinsicCacheCur;          // Slot (0,1) of the intrinsic template of the current state;  the other slot holds that of a recent proposal
+  int intrinsicCacheValid[2];     // 1 if the slot holds the intrinsic template for the intrinsic parameters in its intrinsicCachePar
+  double *intrinsicCachePar;      // Parameter values of the two cached intrinsic templates, [slot*nMCMCpar+i];  only the intrinsic ones matter
+  double *intrinsicCacheDH;       // d* u per IFO over the band, as (re,im) pairs at [slot*2*intrinsicBins], and <u|u> per IFO at
+  double *intrinsicCacheHH;       //   [slot*networkSize], of the cached intrinsic templates u;  see intrinsicTemplateCache()
+  
+  long likelihoodAllocations;     // Heap allocations during the likelihood of the proposals (counted with SPINSPIRAL_CHECKS only)
+  struct interferometer **threadIfo;  // Copy of the network for each thread:  threadIfo[thread*networkSize+ifonr], see IFOthreadInit()
+  
+  long updateProposed[nUpdateTypes];  // Per update type (see updateChain()):  number of proposals,
+  long updateAccepted[nUpdateTypes];  //   number of accepted proposals,
+  double updateTime[nUpdateTypes];    //   wall-clock time (s)
+  double updateJump[nUpdateTypes];    //   and summed squared jump distance, in units of parSigma
+}; // End struct MCMCchain
+
+
+
 
 
 // Structure for waveform parameter set with up to 20 parameters
@@ -469,7 +619,70 @@ fftw_complex *raw_dataTrafo;
       double *noisePSD;               // noise PSD interpolated for the above set of frequencies            
 fftw_complex *dataTrafo;              // copy of the dataFT stretch corresponding to above frequencies      
          int lowIndex, highIndex, indexRange;
-  
+      double *noiseWeight;            // 4/(noisePSD*deltaFT*samplerate^2), stored twice per frequency (re,im) to match the FTout layout
+      double *weightedData;           // dataTrafo*samplerate*noiseWeight as (re,im) pairs, for the fused overlap in templateLogLikelihood()
+      double *bandFreq;               // the above set of frequencies, for frequency-domain templates
+
+      // Relative-binning likelihood (see setRelativeBins() and relativeBinningSummaryData()):
+         int relBinN;                 // number of bins;  0 if relative binning is not used
+         int relBinUse;               // 1 when the summary data have been computed around a fiducial template
+         int *relBinEdge;             // Fourier indices of the relBinN+1 bin edges
+      double *relBinFreq;             // frequencies of the bin edges
+fftw_complex *relBinH0;               // fiducial template at the bin edges
+fftw_complex *relBinH;                // template at the bin edges (work space)
+fftw_complex *relBinA0, *relBinA1;    // summary data for <d|h>, per bin
+      double *relBinB0, *relBinB1, *relBinB2;  // summary data for <h|h>, per bin
+
+      // Reduced-order-quadrature likelihood (see readROQbasis()):
+         int roqNlin, roqNquad;       // number of linear and quadratic interpolation nodes;  0 if ROQ is not used
+      double *roqLinFreq;             // frequencies of the linear nodes
+      double *roqQuadFreq;            // frequencies of the quadratic nodes
+fftw_complex *roqLinWeight;           // <d|h> = Re sum roqLinWeight h(roqLinFreq)*
+      double *roqQuadWeight;          // <h|h> = sum roqQuadWeight |h(roqQuadFreq)|^2
+fftw_complex *roqH;                   // template at the nodes (work space)
+
+      // Time-marginalised likelihood, for the whole network in ifo[0] (see setTimeMarginalisation()):
+         int tMargN;                  // length of the inverse FFT;  0 if not used
+fftw_complex *tMargIn;                // network cross-correlation d h* per Fourier index
+fftw_complex *tMargOut;               // <d|h> for all time shifts of the template by deltaFT/tMargN (real part)
+   fftw_plan tMargPlan;               // inverse Fourier transform plan
+
+      // Support of the template in FTin and cache of taper windows (see setTemplateSupport() and taperTemplate()):
+         int tStart, tEnd;            // first and last sample of FTin that can be non-zero;  tStart<0: unknown, tEnd<tStart: empty
+         int taperN[taperCacheSize];  // template lengths (tEnd-tStart) of the cached windows;  -1: empty slot
+         int taperRise[taperCacheSize], taperFall[taperCacheSize];  // number of samples in the rising and falling edges of the window
+      double *taperWin[taperCacheSize];  // window over the rising edge, followed by the falling edge;  the window is 1 in between
+         int taperCap[taperCacheSize];  // number of doubles allocated for taperWin
+         int taperNext;               // cache slot to replace next
+      double taperTukey1, taperTukey2;  // parameters of the cached windows
+
+      // Pruned FFT of the templates, for the bins lowIndex..highIndex only (see setBandFFT() and templateFFT()):
+         int bandFFTn1, bandFFTn2;    // samplesize = n1*n2:  n2 real FFTs of length n1;  bandFFTn2=0: use the full FFTplan
+   fftw_plan bandFFTplan;             // plan for the n2 FFTs of length n1
+fftw_complex *bandFFTout;             // output of these FFTs, n1/2+1 bins each
+      double *bandFFTtwiddle;         // exp(-2 pi i k/samplesize) for k=lowIndex..highIndex, as (re,im) pairs
+
+      // Single-precision template FFT and overlaps (see setSinglePrecision() and templateOverlapsFloat()):
+         int singlePrecision;         // 1: use them for the likelihood
+      double floatScale;              // FTinF = FTin*floatScale;  the weights are scaled to match, to stay within the range of floats
+       float *FTinF;                  // template in single precision
+         int floatStart, floatEnd;    // the samples of FTinF that can be non-zero
+fftwf_complex *FToutF;                // its FFT
+  fftwf_plan FTplanF;                 // Fourier transform plan
+       float *noiseWeightF;           // noiseWeight/floatScale^2, band only
+       float *weightedDataF;          // weightedData/floatScale, band only
+
+      // Scratch arena for the work space of the templates and overlaps, so that the likelihood does not allocate (see scratchAlloc()):
+        char *scratch;                // fftw_malloc()ed block of scratchSize bytes
+      size_t scratchSize;             // size of the arena
+      size_t scratchUsed;             // bytes in use;  a routine that takes scratch space resets this when it returns
+
+      // LAL detector response for the LAL templates (see setLALresponse() and LALFpFc()):
+ LALDetector lalSite;                 // the detector, found by name
+DetectorResponse lalResponse;         // points to lalSite;  no transfer function
+REAL4TimeSeries lalSignal;            // the detector signal;  its vector (lalSignal.data) is reused for every template
+      double lalFTstart;              // FTstart for which the epoch of lalSignal was set
+
       // Frequency-domain template stuff:
       double *FTin;                   // Fourier transform input                                  
 fftw_complex *FTout;                  // FT output (type here identical to `(double) complex')
@@ -482,6 +695,32 @@ fftw_complex *FTout;                  // FT output (type here identical to `(dou
 
 
 
+// Structure for a waveform backend:  the routines that compute a waveform, and its capabilities (see getWaveformBackend())
+struct waveformBackend{
+  int version;                   // waveformVersion, as in mcmcWaveform and injectionWaveform
+  const char *name;
+  int flags;                     // capabilities:  wfFrequencyDomain, wfDistanceScaling, ...
+  int phaseFactor;               // m in h(f>0) ~ exp(i m phi_c), for a backend with wfPhaseFactor (2 if phi_c is the orbital phase);  0 otherwise
+  
+  // Time-domain template in ifo[ifonr]->FTin;  NULL for a frequency-domain backend:
+  void (*templateTD)(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+  
+  // Frequency-domain template at the nFreq frequencies freq[], as (re,im) pairs in h;  NULL for a time-domain backend:
+  void (*templateFD)(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                     const double *freq, int nFreq, double *h);
+  
+  // Time-domain templates for the whole network from a single h_+,h_x;  NULL unless the flags contain wfPolarisations:
+  void (*templateNetwork)(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, int injectionWF, 
+                          const struct likelihoodPar *likePar);
+  
+  // Intrinsic part u(f) of a frequency-domain template and complex factor E of the extrinsic parameters;  NULL unless the flags contain wfExtrinsic:
+  void (*templateIntrinsic)(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                            const double *freq, int nFreq, double *h);
+  void (*extrinsicFactor)(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar, double *factor);
+};
+
+
+
 
 
 // Declare functions (prototypes):
@@ -495,42 +734,62 @@ void readSystemInputfile(struct runPar *run);
 void readInjectionXML(struct runPar *run);
 void setParameterNames(struct runPar *run);
 
-void setConstants(void);
 void setIFOdata(struct runPar *run, struct interferometer ifo[]);
 
 void setRandomInjectionParameters(struct runPar *run);
-void getInjectionParameters(struct parSet *par, int nInjectionPar, double *parInjectVal);
+void getInjectionParameters(struct parSet *par, int nInjectionPar, const double *parInjectVal);
 void getStartParameters(struct parSet *par, struct runPar run);
-void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct interferometer *ifo[], struct runPar run);
+void startMCMCOffset(struct parSet *par, const struct MCMCvariables *mcmc, struct MCMCchain *chain, struct interferometer *ifo[], const struct likelihoodPar *likePar);
 void setTemperatureLadder(struct MCMCvariables *mcmc);
 void setTemperatureLadderOld(struct MCMCvariables *mcmc);
 void allocParset(struct parSet *par, int networkSize);
 void freeParset(struct parSet *par);
 
 void copyRun2MCMC(struct runPar run, struct MCMCvariables *mcmc);
+void setLikelihoodPar(struct runPar *run);
 void setMCMCseed(struct runPar *run);
 void setSeed(int *seed);
 
 void MCMC(struct runPar run, struct interferometer *ifo[]);
-void CholeskyDecompose(double **A, struct MCMCvariables *mcmc);
-void par2arr(struct parSet par, double **param, struct MCMCvariables mcmc);
-void arr2par(double **param, struct parSet *par, struct MCMCvariables mcmc);
-double prior(double *par, int p, struct MCMCvariables mcmc);
-double sigmaPeriodicBoundaries(double sigma, int p, struct MCMCvariables mcmc);
-
-void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run);
-void uncorrelatedMCMCsingleUpdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run);
-void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run);
-
-void writeMCMCheader(struct interferometer *ifo[], struct MCMCvariables mcmc, struct runPar run);
-void writeMCMCoutput(struct MCMCvariables mcmc, struct interferometer *ifo[]);
+int mcmcThreads(const struct MCMCvariables *mcmc);
+void updateChain(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+void writeUpdateStatistics(const struct MCMCchain *chain);
+int CholeskyRankOneUpdate(double **L, double *x, double sign, int n);
+void lowerTriangularProduct(double **L, const double *z, double *out, int n);
+void par2arr(const struct parSet *par, double *param, const struct MCMCvariables *mcmc);
+void arr2par(const double *param, struct parSet *par, const struct MCMCvariables *mcmc);
+double prior(double *par, int p, const struct MCMCvariables *mcmc);
+double sigmaPeriodicBoundaries(double sigma, int p, const struct MCMCvariables *mcmc);
+
+void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+void multipleTryMCMCupdate(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+int correlatedProposal(const struct MCMCvariables *mcmc, struct MCMCchain *chain, const double *from, double *to);
+long candidateLogLikelihoods(struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct MCMCchain *chain, const struct likelihoodPar *likePar, const double *cand, const int *candPrior, int nCand, double *logL, double *overlapHD, double *overlapHH);
+void uncorrelatedMCMCsingleUpdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+void differentialEvolutionMCMCupdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+void storeDEhistory(const struct MCMCvariables *mcmc, struct MCMCchain *chain);
+double proposalLogLikelihood(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar, int p);
+void storeOverlapCache(const struct MCMCvariables *mcmc, struct MCMCchain *chain);
+int intrinsicCacheSlot(const struct MCMCvariables *mcmc, const struct MCMCchain *chain, const double *param);
+void setRelativeBinningFiducial(struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct likelihoodPar *likePar, const double *fidParam);
+void checkRelativeBinning(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, const struct likelihoodPar *likePar);
+void accumulateTimePosterior(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, const struct likelihoodPar *likePar);
+void writeTimePosterior(const struct MCMCvariables *mcmc, struct interferometer *ifo[], const char *outputPath);
+void setMultirateTemplate(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct likelihoodPar *likePar, const double *refParam);
+void drawPhaseDistance(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar);
+double drawVonMises(gsl_rng *ran, double mu, double kappa);
+
+void writeMCMCheader(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct runPar run);
+void writeMCMCoutput(const struct MCMCvariables *mcmc, const struct MCMCchain *chain, struct interferometer *ifo[]);
 void allocateMCMCvariables(struct MCMCvariables *mcmc);
 void freeMCMCvariables(struct MCMCvariables *mcmc);
 
-void updateCovarianceMatrix(struct MCMCvariables *mcmc);
+void accumulateCovariance(const struct MCMCvariables *mcmc, struct MCMCchain *chain);
+void updateCovarianceMatrix(const struct MCMCvariables *mcmc, struct MCMCchain *chain);
 double annealTemperature(double temp0, int nburn, int nburn0, int iIter);
 void swapChains(struct MCMCvariables *mcmc);
-void writeChainInfo(struct MCMCvariables mcmc);
+void writeChainInfo(const struct MCMCvariables *mcmc, const struct MCMCchain *chain);
 
 
 
@@ -556,11 +815,21 @@ double angle(double x[3], double y[3]);
 void coord2vec(double sinlati, double longi, double x[3]);
 void vec2coord(double x[3], double *sinlati, double *longi);
 
+long heapAllocations(void);
+
 
 //************************************************************************************************************************************************
 
 void IFOinit(struct interferometer **ifo, int networkSize, struct runPar run);
 void IFOdispose(struct interferometer *ifo, struct runPar run);
+void IFOthreadInit(struct interferometer *copy, const struct interferometer *ifo);
+void IFOthreadDispose(struct interferometer *copy);
+void setBandFFT(struct interferometer *ifo, struct runPar run);
+void setBandFFTsplit(struct interferometer *ifo, int n2);
+double timeTemplateFFT(struct interferometer *ifo);
+void setSinglePrecision(struct interferometer *ifo);
+void setScratch(struct interferometer *ifo, int samplesize, const struct likelihoodPar *likePar);
+void *scratchAlloc(struct interferometer *ifo, size_t size);
 double *filter(int *order, int samplerate, double upperlimit, struct runPar run);
 double *downsample(double data[], int *datalength, double coef[], int ncoef, struct runPar run);
 void dataFT(struct interferometer *ifo[], int i, int networkSize, struct runPar run);
@@ -577,27 +846,54 @@ void printParameterHeaderToFile(FILE * dump, struct interferometer *ifo, struct
 
 
 //************************************************************************************************************************************************
-void waveformTemplate(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run);
-void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
-void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize, int injectionWF, struct runPar run);
+const struct waveformBackend *getWaveformBackend(int waveformVersion);
+int waveformCapability(int waveformVersion, int flags);
+void waveformTemplate(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+void networkWaveformTemplate(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+int networkTemplateAllowed(struct interferometer *ifo[], int networkSize, int waveformVersion);
+void waveformTemplateFD(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+void waveformTemplateFDfreq(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar,
+                            const double *freq, int nFreq, double *h);
+int frequencyDomainTemplate(int waveformVersion);
+void waveformTemplateIntrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, const struct likelihoodPar *likePar,
+                               const double *freq, int nFreq, double *h);
+void waveformExtrinsicFactor(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, const struct likelihoodPar *likePar, double *factor);
+int extrinsicParameter(int parID);
+void setTemplateSupport(struct interferometer *ifo, int tStart, int tEnd);
+void copyTemplate(struct interferometer *ifo, const double *wave);
+void taperTemplate(struct interferometer *ifo, const struct likelihoodPar *likePar);
+int taperWindow(struct interferometer *ifo, int N, const struct likelihoodPar *likePar);
+void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateApostolatosScalar(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void cubicSplineSetup(const int *x, const double *y, int n, double *y2, double *work);
+void templateTaylorF2(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                      const double *freq, int nFreq, double *h);
+void taylorF2response(struct interferometer *ifo, double pLongi, double pSinDec, double pPsi, double pCosI, double *respRe, double *respIm);
+void taylorF2phaseCoefficients(double pEta, double PNorder, double *a);
+void templateTaylorF2intrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                               const double *freq, int nFreq, double *h);
+void templateTaylorF2extrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar, double *factor);
+void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize, int injectionWF, const struct likelihoodPar *likePar);
 		  
 
 
 //************************************************************************************************************************************************
 
-void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
-void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
-void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
-void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
-void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run);
+void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar);
+void templateLALnetwork(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
 
 //void LALHpHc(CoherentGW *waveform, double *hplus, double *hcross, int *l, int length, struct parSet *par, struct interferometer *ifo, int ifonr);
-void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, struct runPar run);
-void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, struct runPar run);
-void LALHpHcNonSpinning(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, struct runPar run);
+void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar);
+void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar);
+void LALHpHcNonSpinning(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar);
 //double LALFpFc(CoherentGW *waveform, double *wave, int *l, int length, struct parSet *par, int ifonr);
 double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, double *wave, int length, struct parSet *par, struct interferometer *ifo, int ifonr);
 
+void setLALresponse(struct interferometer *ifo, int length);
 void getWaveformApproximant(const char* familyName, int length, double PNorder, char* waveformApproximant);
 void LALfreedomSpin(CoherentGW *waveform);
 void LALfreedomNoSpin(CoherentGW *waveform);
@@ -605,21 +901,77 @@ void LALfreedomPhenSpinTaylorRD(CoherentGW *waveform);
 
 //************************************************************************************************************************************************
 
-double netLogLikelihood(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, struct runPar run);
-double IFOlogLikelihood(struct parSet *par, struct interferometer *ifo[], int i, int waveformVersion, int injectionWF, struct runPar run);
-double logLikelihood_nine(struct parSet *par, int waveformVersion, int injectionWF, struct runPar run);
-double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int i, int waveformVersion, int injectionWF, struct runPar run);
-double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer *ifo[], int networkSize, struct runPar run);
-double overlapWithData(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run);
-double parOverlap(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer* ifo[], int ifonr, struct runPar run);
+double netLogLikelihood(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double IFOlogLikelihood(struct parSet *par, struct interferometer *ifo[], int i, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double netLogLikelihoodOverlaps(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh);
+double templateLogLikelihood(struct interferometer *ifo);
+void templateOverlaps(struct interferometer *ifo, double *overlaphd, double *overlaphh);
+void templateFFT(struct interferometer *ifo);
+void templateOverlapsFloat(struct interferometer *ifo, double *overlaphd, double *overlaphh);
+void compareSinglePrecision(struct interferometer *ifo[], int networkSize, struct runPar run);
+void compareThreadedLikelihood(struct interferometer *ifo[], int networkSize, struct runPar run);
+void benchmarkOverlaps(struct interferometer *ifo[], int networkSize);
+void benchmarkTemplateFFT(struct interferometer *ifo[], int networkSize);
+void compareExtrinsicLikelihood(struct interferometer *ifo[], int networkSize, struct runPar run);
+void compareApostolatosTemplates(struct interferometer *ifo[], int networkSize, struct runPar run);
+void bandOverlaps(struct interferometer *ifo, double *overlaphd, double *overlaphh);
+void setRelativeBins(struct interferometer *ifo, double epsilon);
+void relativeBinningSummaryData(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, const struct likelihoodPar *likePar);
+void relativeBinningOverlaps(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh);
+void intrinsicTemplateCache(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, const struct likelihoodPar *likePar,
+                            double *cacheDH, double *cacheHH);
+double extrinsicLogLikelihood(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, const struct likelihoodPar *likePar,
+                              const double *cacheDH, const double *cacheHH, double *overlaphd, double *overlaphh);
+void setTimeMarginalisation(struct interferometer *ifo[], int networkSize, struct runPar run);
+void addTimeCorrelation(struct interferometer *ifo[], int ifonr);
+void timeShiftRange(struct parSet *par, struct interferometer *ifo, const struct likelihoodPar *likePar, int *nLow, int *nUp);
+double timeMarginalisedLogLikelihood(struct parSet *par, struct interferometer *ifo[], const struct likelihoodPar *likePar, double overlaphh);
+double bandOverlapImag(struct interferometer *ifo);
+double templateDistance(struct parSet *par, const struct likelihoodPar *likePar);
+double logBesselI0(double x);
+double phaseDistMarginalisedLogLikelihood(struct parSet *par, const struct likelihoodPar *likePar, double overlaphd, double overlaphdImag, double overlaphh);
+double logLikelihood_nine(struct parSet *par, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int i, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer *ifo[], int networkSize, const struct likelihoodPar *likePar);
+double overlapWithData(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double parOverlap(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer* ifo[], int ifonr, const struct likelihoodPar *likePar);
 double vecOverlap(fftw_complex *vec1, fftw_complex *vec2, double * noise, int j_1, int j_2, double deltaFT);
-void signalFFT(fftw_complex * FFTout, struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run);
-double matchBetweenParameterArrayAndTrueParameters(double * pararray, struct interferometer *ifo[], struct MCMCvariables mcmc, struct runPar run);
+void vecOverlapFused(const double *h, const double *weightedData, const double *weight, int n, double *overlaphd, double *overlaphh);
+void vecOverlapFusedFloat(const float *h, const float *weightedData, const float *weight, int n, double *overlaphd, double *overlaphh);
+void signalFFT(fftw_complex * FFTout, struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar);
+double matchBetweenParameterArrayAndTrueParameters(double * pararray, struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct likelihoodPar *likePar);
 //void computeFisherMatrixIFO(struct parSet *par, int npar, struct interferometer *ifo[], int networkSize, int ifonr, double **matrix);
 //void computeFisherMatrix(struct parSet *par, int npar, struct interferometer *ifo[], int networkSize, double **matrix);
 //double match(struct parSet *par, struct interferometer *ifo[], int i, int networkSize);
 
+
+//************************************************************************************************************************************************
+
+void buildROQbasis(struct interferometer *ifo[], int networkSize, struct runPar run);
+int buildROQinterpolant(struct interferometer *ifo[], int networkSize, int ifonr, double **trainPar, int nTrain, int quadratic, struct runPar run, FILE *fout);
+double roqTrainingTemplate(struct parSet *par, const double *trainPar, struct interferometer *ifo[], int networkSize, int ifonr, int quadratic, struct runPar run, fftw_complex *h);
+void readROQbasis(struct interferometer *ifo, struct runPar run);
+void roqOverlaps(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh);
+void complexLUdecompose(fftw_complex *A, int n, int *perm);
+void complexLUsolve(const fftw_complex *LU, int n, const int *perm, fftw_complex *b);
+
 void parseCharacterOptionString(char *input, char **strings[], int *n);
 void readCachefile(struct runPar *run, int ifonr);
 
+
+
+// Runtime checks:  count the heap allocations made by SPINspiral (not those inside LAL), see heapAllocations():
+#ifdef SPINSPIRAL_CHECKS
+void *countedMalloc(size_t size);
+void *countedCalloc(size_t n, size_t size);
+void *countedRealloc(void *ptr, size_t size);
+void *countedFFTWmalloc(size_t size);
+void *countedFFTWFmalloc(size_t size);
+#define malloc(size) countedMalloc(size)
+#define calloc(n,size) countedCalloc(n,size)
+#define realloc(ptr,size) countedRealloc(ptr,size)
+#define fftw_malloc(size) countedFFTWmalloc(size)
+#define fftwf_malloc(size) countedFFTWFmalloc(size)
+#endif
+
 #endif
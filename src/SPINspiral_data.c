@@ -129,7 +129,7 @@ void IFOinit(struct interferometer **ifo, int networkSize, struct runPar run)
   char latchar[2];
   char longchar[2];
   int ifonr,j;
-  double f;
+  double f,w;
   double flattening, eccentricitySQ, curvatureradius;
   for(ifonr=0; ifonr<networkSize; ++ifonr){
     ifo[ifonr]->index = ifonr;
@@ -204,12 +204,34 @@ void IFOinit(struct interferometer **ifo, int networkSize, struct runPar run)
     noisePSDestimate(ifo,ifonr,run);
     
     
+    // Empty cache of taper windows for the templates, see taperTemplate();  its tables and the scratch arena are allocated by
+    //   setScratch().  The support of the template in FTin is unknown until a template routine sets it:
+    ifo[ifonr]->tStart = -1;
+    ifo[ifonr]->tEnd = -1;
+    for(j=0; j<taperCacheSize; j++) {
+      ifo[ifonr]->taperN[j] = -1;
+      ifo[ifonr]->taperWin[j] = NULL;
+    }
+    ifo[ifonr]->taperNext = 0;
+    ifo[ifonr]->taperTukey1 = -1.0;
+    ifo[ifonr]->taperTukey2 = -1.0;
+    ifo[ifonr]->scratch = NULL;
+    ifo[ifonr]->lalSignal.data = NULL;   // The LAL detector response is set up by setLALresponse()
+    
+    
     // Read 'detector' data for injection
     double delta = ceil(run.geocentricTc + ifo[ifonr]->after_tc  + (ifo[ifonr]->before_tc+ifo[ifonr]->after_tc) * 0.5 * (run.tukeyWin/(1.0-run.tukeyWin))) -
       floor(run.geocentricTc - ifo[ifonr]->before_tc - (ifo[ifonr]->before_tc+ifo[ifonr]->after_tc) * 0.5 * (run.tukeyWin/(1.0-run.tukeyWin)));
     if(run.beVerbose>=1) printf("   Reading %4.1fs of data for the detector in %s...\n",delta,ifo[ifonr]->name);
     dataFT(ifo,ifonr,networkSize,run);
     
+    // Work space for the templates and overlaps, so that the likelihood does not allocate memory (see scratchAlloc()):
+    setScratch(ifo[ifonr], ifo[ifonr]->samplesize, &run.likePar);
+    
+    // Detector response for the LAL templates, found by the name of the IFO (an injection template sets up its own, in LALFpFc() or
+    //   templateLALPhenSpinTaylorRD()):
+    if(run.mcmcWaveform>=2 && run.mcmcWaveform<=5) setLALresponse(ifo[ifonr], ifo[ifonr]->samplesize);
+    
     
     
     // Initialise array of different powers of Fourier frequencies corresponding to the elements of 'ifo[ifonr]->dataTrafo':       
@@ -227,17 +249,77 @@ void IFOinit(struct interferometer **ifo, int networkSize, struct runPar run)
     
     ifo[ifonr]->noisePSD  = ((double*) malloc(sizeof(double) * ifo[ifonr]->indexRange));
     ifo[ifonr]->dataTrafo = ((fftw_complex*) malloc(sizeof(fftw_complex) * ifo[ifonr]->indexRange));
+    ifo[ifonr]->bandFreq  = ((double*) malloc(sizeof(double) * ifo[ifonr]->indexRange));
     for(j=0; j<ifo[ifonr]->indexRange; ++j){
       f = (((double)(j+ifo[ifonr]->lowIndex))/((double)ifo[ifonr]->deltaFT));
+      ifo[ifonr]->bandFreq[j] = f;
       ifo[ifonr]->noisePSD[j] = interpolLogNoisePSD(f,ifo[ifonr]);
       
       // Although smoothing was done for log noise, we store real noise on output
       ifo[ifonr]->noisePSD[j] = exp(ifo[ifonr]->noisePSD[j]);
       ifo[ifonr]->dataTrafo[j]  = ifo[ifonr]->raw_dataTrafo[j+ifo[ifonr]->lowIndex];
     }
+
+    // Weights and weighted data for the fused overlap in templateLogLikelihood().  The weights contain the 4/deltaFT factor of the
+    //   inner product and the 1/samplerate^2 correction of the (unnormalised) template FFT; the data FFT is already normalised in dataFT().
+    //   Store both as (re,im) pairs, so that <d|h> and <h|h> become plain dot products over the doubles in FTout:
+    ifo[ifonr]->noiseWeight  = (double*) fftw_malloc(sizeof(double) * 2 * ifo[ifonr]->indexRange);
+    ifo[ifonr]->weightedData = (double*) fftw_malloc(sizeof(double) * 2 * ifo[ifonr]->indexRange);
+    for(j=0; j<ifo[ifonr]->indexRange; ++j){
+      w = 4.0 / (ifo[ifonr]->noisePSD[j] * ifo[ifonr]->deltaFT * (double)ifo[ifonr]->samplerate * (double)ifo[ifonr]->samplerate);
+      ifo[ifonr]->noiseWeight[2*j]    = w;
+      ifo[ifonr]->noiseWeight[2*j+1]  = w;
+      ifo[ifonr]->weightedData[2*j]   = creal(ifo[ifonr]->dataTrafo[j]) * (double)ifo[ifonr]->samplerate * w;
+      ifo[ifonr]->weightedData[2*j+1] = cimag(ifo[ifonr]->dataTrafo[j]) * (double)ifo[ifonr]->samplerate * w;
+    }
+    
+    // Transform the templates for the band only, if that is faster than the full FFT:
+    setBandFFT(ifo[ifonr], run);
+    
+    // Single-precision FFT and overlaps for time-domain templates;  for singlePrecision=2, compareSinglePrecision() switches them on:
+    ifo[ifonr]->singlePrecision = 0;
+    ifo[ifonr]->FTinF = NULL;
+    if(run.singlePrecision>=1) {
+      if(!frequencyDomainTemplate(run.mcmcWaveform)) {
+        setSinglePrecision(ifo[ifonr]);
+        ifo[ifonr]->singlePrecision = (run.singlePrecision==1);
+      } else if(ifonr==0) {
+        fprintf(stderr, "\n ***  Warning:  singlePrecision needs a time-domain MCMC template;  using double precision ***\n\n");
+      }
+    }
+    
+    // Weights for the reduced-order-quadrature likelihood, from the basis in run.roqFilename (likelihoodROQ = 2 builds that basis in main()):
+    ifo[ifonr]->roqNlin = 0;
+    ifo[ifonr]->roqNquad = 0;
+    if(run.likelihoodROQ==1) {
+      if(frequencyDomainTemplate(run.mcmcWaveform)) {
+        readROQbasis(ifo[ifonr], run);
+        if(run.beVerbose>=2) printf(" | %d linear and %d quadratic ROQ nodes from %s.\n", ifo[ifonr]->roqNlin, ifo[ifonr]->roqNquad, run.roqFilename);
+      } else if(ifonr==0) {
+        fprintf(stderr, "\n ***  Warning:  the ROQ likelihood needs a frequency-domain MCMC template;  using the full likelihood ***\n\n");
+      }
+    }
+    
+    // Bins for the relative-binning likelihood.  The summary data are computed around a fiducial template in MCMC():
+    ifo[ifonr]->relBinN = 0;
+    ifo[ifonr]->relBinUse = 0;
+    if(run.relativeBinning>=1 && ifo[ifonr]->roqNlin>0) {
+      if(ifonr==0) fprintf(stderr, "\n ***  Warning:  relative binning cannot be combined with the ROQ likelihood;  using ROQ ***\n\n");
+    } else if(run.relativeBinning>=1) {
+      if(frequencyDomainTemplate(run.mcmcWaveform)) {
+        setRelativeBins(ifo[ifonr], run.relBinEpsilon);
+        if(run.beVerbose>=2) printf(" | %d relative-binning bins for a maximum phase difference of %.3f rad.\n", ifo[ifonr]->relBinN, run.relBinEpsilon);
+      } else if(ifonr==0) {
+        fprintf(stderr, "\n ***  Warning:  relative binning needs a frequency-domain MCMC template;  using the full likelihood ***\n\n");
+      }
+    }
+
     if(run.beVerbose>=2) printf(" | %d Fourier frequencies within operational range %.0f--%.0f Hz.\n", ifo[ifonr]->indexRange, ifo[ifonr]->lowCut, ifo[ifonr]->highCut);
     if(ifonr<networkSize-1 && run.beVerbose>=2) printf(" | --- --- --- --- --- --- --- --- --- --- --- --- --- --- --- --- --- --- --\n");
   } //for(ifonr=0; ifonr<networkSize; ++ifonr)
+  
+  // Prepare the inverse FFT for the time-marginalised likelihood, for the whole network:
+  setTimeMarginalisation(ifo, networkSize, run);
 } // End of IFOinit()
 // ****************************************************************************************************************************************************  
 
@@ -254,11 +336,60 @@ void IFOinit(struct interferometer **ifo, int networkSize, struct runPar run)
 // ****************************************************************************************************************************************************  
 void IFOdispose(struct interferometer *ifo, struct runPar run)
 {
+  int j=0;
   if(run.beVerbose>=2) printf(" | Interferometer %d '%s' is taken offline.\n", ifo->index, ifo->name);
   free(ifo->raw_noisePSD);       ifo->raw_noisePSD = NULL;
   fftw_free(ifo->raw_dataTrafo); ifo->raw_dataTrafo = NULL;
   free(ifo->noisePSD);           ifo->noisePSD = NULL;
   free(ifo->dataTrafo);          ifo->dataTrafo = NULL;
+  fftw_free(ifo->noiseWeight);   ifo->noiseWeight = NULL;
+  fftw_free(ifo->weightedData);  ifo->weightedData = NULL;
+  free(ifo->bandFreq);           ifo->bandFreq = NULL;
+  if(ifo->relBinN>0) {
+    free(ifo->relBinEdge);       ifo->relBinEdge = NULL;
+    free(ifo->relBinFreq);       ifo->relBinFreq = NULL;
+    fftw_free(ifo->relBinH0);    ifo->relBinH0 = NULL;
+    fftw_free(ifo->relBinH);     ifo->relBinH = NULL;
+    fftw_free(ifo->relBinA0);    ifo->relBinA0 = NULL;
+    fftw_free(ifo->relBinA1);    ifo->relBinA1 = NULL;
+    free(ifo->relBinB0);         ifo->relBinB0 = NULL;
+    free(ifo->relBinB1);         ifo->relBinB1 = NULL;
+    free(ifo->relBinB2);         ifo->relBinB2 = NULL;
+    ifo->relBinN = 0;
+    ifo->relBinUse = 0;
+  }
+  if(ifo->roqNlin>0) {
+    free(ifo->roqLinFreq);       ifo->roqLinFreq = NULL;
+    free(ifo->roqQuadFreq);      ifo->roqQuadFreq = NULL;
+    fftw_free(ifo->roqLinWeight); ifo->roqLinWeight = NULL;
+    free(ifo->roqQuadWeight);    ifo->roqQuadWeight = NULL;
+    fftw_free(ifo->roqH);        ifo->roqH = NULL;
+    ifo->roqNlin = 0;
+    ifo->roqNquad = 0;
+  }
+  if(ifo->tMargN>0) {
+    fftw_destroy_plan(ifo->tMargPlan);
+    fftw_free(ifo->tMargIn);     ifo->tMargIn = NULL;
+    fftw_free(ifo->tMargOut);    ifo->tMargOut = NULL;
+    ifo->tMargN = 0;
+  }
+  for(j=0; j<taperCacheSize; j++) {
+    free(ifo->taperWin[j]);      ifo->taperWin[j] = NULL;
+    ifo->taperN[j] = -1;
+  }
+  fftw_free(ifo->scratch);       ifo->scratch = NULL;
+  if(ifo->lalSignal.data != NULL) {
+    XLALDestroyREAL4Vector(ifo->lalSignal.data);  ifo->lalSignal.data = NULL;
+  }
+  setBandFFTsplit(ifo, 0);
+  if(ifo->FTinF != NULL) {
+    fftwf_destroy_plan(ifo->FTplanF);
+    fftwf_free(ifo->FTinF);      ifo->FTinF = NULL;
+    fftwf_free(ifo->FToutF);     ifo->FToutF = NULL;
+    fftwf_free(ifo->noiseWeightF);  ifo->noiseWeightF = NULL;
+    fftwf_free(ifo->weightedDataF); ifo->weightedDataF = NULL;
+    ifo->singlePrecision = 0;
+  }
   fftw_destroy_plan(ifo->FTplan);
   fftw_free(ifo->FTin);          ifo->FTin = NULL;
   fftw_free(ifo->rawDownsampledWindowedData); ifo->rawDownsampledWindowedData = NULL;  
@@ -272,6 +403,354 @@ void IFOdispose(struct interferometer *ifo, struct runPar run)
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Make a copy of an IFO that a thread can compute templates and likelihoods with, alongside the original and other copies
+ * 
+ * The data, noise weights, frequency bins, FFT plans and the other read-only set-up are shared with ifo.  The copy gets its own
+ * work space:  the template and its FFT, the buffers of the pruned, single-precision and time-marginalised transforms, the template 
+ * at the relative-binning edges and ROQ nodes, the scratch arena, the taper-window cache and the LAL detector response.  The plans 
+ * are executed on these buffers with the new-array interface of FFTW, which is thread safe, so that a copy gives the same results 
+ * as ifo, bit for bit.  Make the copies after the set-up of ifo is complete, and free them with IFOthreadDispose() before ifo.
+ */
+// ****************************************************************************************************************************************************  
+void IFOthreadInit(struct interferometer *copy, const struct interferometer *ifo)
+{
+  int j=0;
+  
+  *copy = *ifo;
+  
+  copy->FTin  = (double*) fftw_malloc(sizeof(double) * ifo->samplesize);
+  copy->FTout = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * ifo->FTsize);
+  for(j=0; j<ifo->samplesize; j++) copy->FTin[j] = 0.0;
+  for(j=0; j<ifo->FTsize; j++) copy->FTout[j] = 0.0;
+  copy->tStart = 0;                                                                      // FTin is empty
+  copy->tEnd = -1;
+  
+  if(ifo->bandFFTn2>0) copy->bandFFTout = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * ifo->bandFFTn2 * (ifo->bandFFTn1/2+1));
+  
+  if(ifo->FTinF != NULL) {
+    copy->FTinF  = (float*) fftwf_malloc(sizeof(float) * ifo->samplesize);
+    copy->FToutF = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * ifo->FTsize);
+    for(j=0; j<ifo->samplesize; j++) copy->FTinF[j] = 0.0;
+    copy->floatStart = 0;
+    copy->floatEnd = -1;
+  }
+  
+  if(ifo->relBinN>0) copy->relBinH = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (ifo->relBinN+1));
+  if(ifo->roqNlin>0) copy->roqH = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * max(ifo->roqNlin,ifo->roqNquad));
+  if(ifo->tMargN>0) {
+    copy->tMargIn  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * ifo->tMargN);
+    copy->tMargOut = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * ifo->tMargN);
+    for(j=0; j<ifo->tMargN; j++) copy->tMargIn[j] = 0.0;
+  }
+  
+  copy->scratch = (char*) fftw_malloc(ifo->scratchSize);
+  copy->scratchUsed = 0;
+  
+  for(j=0; j<taperCacheSize; j++) {
+    copy->taperWin[j] = NULL;
+    if(ifo->taperCap[j]>0) {
+      copy->taperWin[j] = (double*) malloc(sizeof(double) * ifo->taperCap[j]);
+      if(ifo->taperN[j]>=0) memcpy(copy->taperWin[j], ifo->taperWin[j], sizeof(double) * (ifo->taperRise[j]+ifo->taperFall[j]));
+    }
+  }
+  
+  copy->lalResponse.site = &(copy->lalSite);
+  copy->lalSignal.data = NULL;
+  if(ifo->lalSignal.data != NULL) {
+    copy->lalSignal.data = XLALCreateREAL4Vector(ifo->lalSignal.data->length);
+    for(j=0; j<(int)ifo->lalSignal.data->length; j++) copy->lalSignal.data->data[j] = 0.0;
+  }
+  
+} // End of IFOthreadInit()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Free the work space of an IFO copy made by IFOthreadInit();  the shared set-up is left to IFOdispose() of the original
+ */
+// ****************************************************************************************************************************************************  
+void IFOthreadDispose(struct interferometer *copy)
+{
+  int j=0;
+  fftw_free(copy->FTin);         copy->FTin = NULL;
+  fftw_free(copy->FTout);        copy->FTout = NULL;
+  if(copy->bandFFTn2>0) {
+    fftw_free(copy->bandFFTout); copy->bandFFTout = NULL;
+  }
+  if(copy->FTinF != NULL) {
+    fftwf_free(copy->FTinF);     copy->FTinF = NULL;
+    fftwf_free(copy->FToutF);    copy->FToutF = NULL;
+  }
+  if(copy->relBinN>0) {
+    fftw_free(copy->relBinH);    copy->relBinH = NULL;
+  }
+  if(copy->roqNlin>0) {
+    fftw_free(copy->roqH);       copy->roqH = NULL;
+  }
+  if(copy->tMargN>0) {
+    fftw_free(copy->tMargIn);    copy->tMargIn = NULL;
+    fftw_free(copy->tMargOut);   copy->tMargOut = NULL;
+  }
+  fftw_free(copy->scratch);      copy->scratch = NULL;
+  for(j=0; j<taperCacheSize; j++) {
+    free(copy->taperWin[j]);     copy->taperWin[j] = NULL;
+  }
+  if(copy->lalSignal.data != NULL) {
+    XLALDestroyREAL4Vector(copy->lalSignal.data);  copy->lalSignal.data = NULL;
+  }
+} // End of IFOthreadDispose()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Choose between the full FFT and a pruned FFT for the band of the templates
+ * 
+ * Only the bins lowIndex..highIndex of the template FFT are used in the likelihood (see templateFFT()).  Time the full FFT and the 
+ * pruned transforms that split the segment into n2 = 2, 4, ..., bandFFTmaxSplit subsequences (where n2 divides the segment length), 
+ * and keep the fastest.  The pruned transform must reproduce the band of the full FFT of the data.
+ */
+// ****************************************************************************************************************************************************  
+void setBandFFT(struct interferometer *ifo, struct runPar run)
+{
+  int j=0, n2=0, bestN2=0;
+  double t=0.0, tFull=0.0, tBest=0.0, err=0.0, norm=0.0;
+  fftw_complex *band = (fftw_complex*) malloc(sizeof(fftw_complex) * ifo->indexRange);
+  
+  ifo->bandFFTn1 = ifo->samplesize;
+  ifo->bandFFTn2 = 0;
+  ifo->bandFFTplan = NULL;
+  ifo->bandFFTout = NULL;
+  ifo->bandFFTtwiddle = NULL;
+  
+  // Full FFT of the data still in FTin, as a reference:
+  tFull = timeTemplateFFT(ifo);
+  tBest = tFull;
+  for(j=0; j<ifo->indexRange; j++) band[j] = ifo->FTout[ifo->lowIndex+j];
+  
+  for(n2=2; n2<=bandFFTmaxSplit && ifo->samplesize%n2==0; n2*=2) {
+    setBandFFTsplit(ifo, n2);
+    t = timeTemplateFFT(ifo);
+    
+    err = 0.0;
+    norm = 0.0;
+    for(j=0; j<ifo->indexRange; j++) {
+      err  += creal((ifo->FTout[ifo->lowIndex+j]-band[j]) * conj(ifo->FTout[ifo->lowIndex+j]-band[j]));
+      norm += creal(band[j]*conj(band[j]));
+    }
+    if(err > 1.e-20*norm) {
+      fprintf(stderr, "\n ***  Warning:  setBandFFT():  pruned FFT with %d subsequences has a relative error of %g;  not used ***\n\n", n2, sqrt(err/norm));
+      continue;
+    }
+    if(run.beVerbose>=2) printf(" | Template FFT for %d subsequences:  %.3g ms  (full FFT:  %.3g ms).\n", n2, t*1000.0, tFull*1000.0);
+    if(t < tBest) {
+      tBest = t;
+      bestN2 = n2;
+    }
+  }
+  
+  setBandFFTsplit(ifo, bestN2);
+  if(run.beVerbose>=1) {
+    if(bestN2==0) {
+      printf("   Using the full FFT of %d samples for the templates.\n", ifo->samplesize);
+    } else {
+      printf("   Using a pruned FFT of %d x %d samples for %d of %d template bins, %.1fx faster than the full FFT.\n", 
+             bestN2, ifo->bandFFTn1, ifo->indexRange, ifo->FTsize, tFull/tBest);
+    }
+  }
+  
+  free(band);
+} // End of setBandFFT()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Set up the pruned template FFT (see templateFFT()) with n2 subsequences, or the full FFT for n2=0
+ * 
+ * Frees the previous pruned FFT, if any.  n2 must divide ifo->samplesize.
+ */
+// ****************************************************************************************************************************************************  
+void setBandFFTsplit(struct interferometer *ifo, int n2)
+{
+  int j=0;
+  double arg=0.0;
+  
+  if(ifo->bandFFTn2>0) {
+    fftw_destroy_plan(ifo->bandFFTplan);
+    fftw_free(ifo->bandFFTout);         ifo->bandFFTout = NULL;
+    free(ifo->bandFFTtwiddle);          ifo->bandFFTtwiddle = NULL;
+  }
+  ifo->bandFFTn1 = ifo->samplesize;
+  ifo->bandFFTn2 = 0;
+  if(n2<=0) return;
+  
+  ifo->bandFFTn1 = ifo->samplesize/n2;
+  ifo->bandFFTn2 = n2;
+  ifo->bandFFTout = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n2 * (ifo->bandFFTn1/2+1));
+  ifo->bandFFTplan = fftw_plan_many_dft_r2c(1, &ifo->bandFFTn1, n2, ifo->FTin, NULL, n2, 1,                    // Subsequence m: FTin[m+n2*i]
+                                            ifo->bandFFTout, NULL, 1, ifo->bandFFTn1/2+1, FFTW_ESTIMATE);
+  
+  ifo->bandFFTtwiddle = (double*) malloc(sizeof(double) * 2 * ifo->indexRange);
+  for(j=0; j<ifo->indexRange; j++) {
+    arg = -2.0*pi * (double)(ifo->lowIndex+j) / (double)ifo->samplesize;
+    ifo->bandFFTtwiddle[2*j]   = cos(arg);
+    ifo->bandFFTtwiddle[2*j+1] = sin(arg);
+  }
+  
+} // End of setBandFFTsplit()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the wall-clock time of templateFFT() for ifo in seconds, the fastest of a few calls
+ */
+// ****************************************************************************************************************************************************  
+double timeTemplateFFT(struct interferometer *ifo)
+{
+  int i=0;
+  double t=0.0, tMin=1.e30;
+  struct timeval start, end;
+  
+  for(i=0; i<10; i++) {
+    gettimeofday(&start, NULL);
+    templateFFT(ifo);
+    gettimeofday(&end, NULL);
+    t = (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    tMin = min(tMin, t);
+  }
+  
+  return tMin;
+} // End of timeTemplateFFT()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Set up the single-precision FFT and overlaps of the templates (see templateOverlapsFloat())
+ * 
+ * The noise weights are of the order of 1/PSD, which does not fit in a float.  Scale the template up by 
+ * floatScale = sqrt(max(noiseWeight)) and the (weighted) data and weights down to match, so that <d|h> and <h|h> are unchanged.
+ */
+// ****************************************************************************************************************************************************  
+void setSinglePrecision(struct interferometer *ifo)
+{
+  int j=0;
+  double maxWeight=0.0;
+  
+  for(j=0; j<2*ifo->indexRange; j++) maxWeight = max(maxWeight, ifo->noiseWeight[j]);
+  ifo->floatScale = sqrt(maxWeight);
+  
+  ifo->FTinF  = (float*) fftwf_malloc(sizeof(float) * ifo->samplesize);
+  ifo->FToutF = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * ifo->FTsize);
+  for(j=0; j<ifo->samplesize; j++) ifo->FTinF[j] = 0.0;
+  ifo->floatStart = 0;
+  ifo->floatEnd = -1;
+  ifo->FTplanF = fftwf_plan_dft_r2c_1d(ifo->samplesize, ifo->FTinF, ifo->FToutF, FFTW_ESTIMATE);
+  
+  ifo->noiseWeightF  = (float*) fftwf_malloc(sizeof(float) * 2 * ifo->indexRange);
+  ifo->weightedDataF = (float*) fftwf_malloc(sizeof(float) * 2 * ifo->indexRange);
+  for(j=0; j<2*ifo->indexRange; j++) {
+    ifo->noiseWeightF[j]  = (float)(ifo->noiseWeight[j] / maxWeight);
+    ifo->weightedDataF[j] = (float)(ifo->weightedData[j] / ifo->floatScale);
+  }
+  
+} // End of setSinglePrecision()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Allocate the scratch arena and the taper-window cache of ifo for templates of samplesize samples
+ * 
+ * The arena holds the largest work space of a template (the knots of the multirate templateApostolatos() take nine doubles and an 
+ * int each), the two Fourier transforms that parMatch() holds while it computes a template, and room for a few small blocks and the
+ * rounding of the block sizes.  The taper-window tables are allocated at the size the Tukey window in likePar needs for the longest 
+ * template, so that taperWindow() does not reallocate them.  Any previous arena and cache are freed.
+ */
+// ****************************************************************************************************************************************************  
+void setScratch(struct interferometer *ifo, int samplesize, const struct likelihoodPar *likePar)
+{
+  int j=0;
+  int nWin = (int)ceil(0.5*(likePar->tukey1+likePar->tukey2)*(double)samplesize) + 2;
+  
+  fftw_free(ifo->scratch);
+  ifo->scratchSize = sizeof(double)*10*(samplesize+2) + sizeof(fftw_complex)*2*(samplesize/2+1) + 64*scratchAlign;
+  ifo->scratch = (char*) fftw_malloc(ifo->scratchSize);
+  ifo->scratchUsed = 0;
+  
+  for(j=0; j<taperCacheSize; j++) {
+    free(ifo->taperWin[j]);
+    ifo->taperWin[j] = (double*) malloc(sizeof(double)*nWin);
+    ifo->taperCap[j] = nWin;
+    ifo->taperN[j] = -1;
+  }
+  
+} // End of setScratch()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Take size bytes from the scratch arena of ifo
+ * 
+ * The memory is not initialised.  A routine that takes scratch space saves ifo->scratchUsed first and restores it before it returns,
+ * which releases everything it took.  Blocks are rounded up to scratchAlign bytes, so that they keep the alignment of the arena.
+ */
+// ****************************************************************************************************************************************************  
+void *scratchAlloc(struct interferometer *ifo, size_t size)
+{
+  char *block = ifo->scratch + ifo->scratchUsed;
+  size = (size + scratchAlign-1) / scratchAlign * scratchAlign;
+  
+  if(ifo->scratch==NULL || ifo->scratchUsed + size > ifo->scratchSize) {
+    fprintf(stderr,"\n\n   ERROR:  scratchAlloc(): the scratch arena of the %s detector is too small (%ld bytes in use, %ld requested, %ld available)\n   Aborting...\n\n",
+            ifo->name, (long)ifo->scratchUsed, (long)size, (long)ifo->scratchSize);
+    exit(1);
+  }
+  
+  ifo->scratchUsed += size;
+  return block;
+} // End of scratchAlloc()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
 // *** Routines that do data I/O and data handling ***
 
 // ****************************************************************************************************************************************************  
@@ -558,7 +1037,7 @@ void dataFT(struct interferometer *ifo[], int ifonr, int networkSize, struct run
     ifo[ifonr]->FTstart = from; // Temporary setting so that localPar() works properly
     
     int injectionWF = 1;                  //Call waveformTemplate with the injection template
-    localPar(&injectpar, ifo, networkSize, injectionWF, run);
+    localPar(&injectpar, ifo, networkSize, injectionWF, &run.likePar);
     
     if(run.beVerbose>=2) {
       printf(" :   local parameters:\n");
@@ -570,17 +1049,20 @@ void dataFT(struct interferometer *ifo[], int ifonr, int networkSize, struct run
     
     // Generate injection waveform template:
     injection = malloc(sizeof(double) * N);
+    setScratch(ifo[ifonr], N, &run.likePar);   //Work space for a template of N samples
     double* tempInj = ifo[ifonr]->FTin;
     double tempFrom = ifo[ifonr]->FTstart;
     int tempN = ifo[ifonr]->samplesize;
     ifo[ifonr]->FTin = injection;
     ifo[ifonr]->FTstart = from;
     ifo[ifonr]->samplesize = N;
+    ifo[ifonr]->tStart = -1;          //The injection array is not initialised
     injectionWF = 1;                  //Call waveformTemplate with the injection template
-    waveformTemplate(&injectpar,ifo,ifonr, run.injectionWaveform, injectionWF, run);
+    waveformTemplate(&injectpar,ifo,ifonr, run.injectionWaveform, injectionWF, &run.likePar);
     ifo[ifonr]->FTin = tempInj;
     ifo[ifonr]->FTstart = tempFrom;
     ifo[ifonr]->samplesize = tempN;
+    ifo[ifonr]->tStart = -1;          //FTin holds the data, not a template
     
     freeParset(&injectpar);
     
@@ -1146,7 +1628,7 @@ void writeSignalsToFiles(struct interferometer *ifo[], int networkSize, struct r
   getInjectionParameters(&par, run.nInjectPar, run.injParVal);
   allocParset(&par, networkSize);
   int injectionWF = 1;                            //Call waveformTemplate with the injection template
-  localPar(&par, ifo, networkSize, injectionWF, run);
+  localPar(&par, ifo, networkSize, injectionWF, &run.likePar);
   
   for(i=0; i<networkSize; i++){
     double f;
@@ -1154,7 +1636,7 @@ void writeSignalsToFiles(struct interferometer *ifo[], int networkSize, struct r
     
     // Fill ifo[i]->FTin with time-domain template:
     injectionWF = 1;                              //Call waveformTemplate with the injection template
-    waveformTemplate(&par, ifo, i, run.injectionWaveform, injectionWF, run);
+    waveformTemplate(&par, ifo, i, run.injectionWaveform, injectionWF, &run.likePar);
 
     //printf("tStart: %d\t%13.6e \n tEnd: %d\t%13.6e \n tLength: %d\n", tStart,ifo[i]->FTin[tStart], tEnd, ifo[i]->FTin[tEnd], tLength);
 
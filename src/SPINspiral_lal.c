@@ -101,9 +101,8 @@
  * Use the LAL <=3.5 PN spinning waveform, with 1 spinning object (12 parameters)
  */
 // ****************************************************************************************************************************************************  
-void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
-  int i=0;
   double samplerate=0.0,inversesamplerate=0.0;
   int length=0;
   
@@ -114,13 +113,15 @@ void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr,
   
   // double hplusLAL[length+2];
   // double hcrossLAL[length+2];
-  double *wave = (double*)calloc(length+2,sizeof(double));
+  size_t scratchMark = ifo[ifonr]->scratchUsed;  // wave is taken from the scratch arena of the IFO
+  double *wave = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*(length+2));
+  memset(wave, 0, sizeof(double)*(length+2));
   int lengthLAL = 0;
   
   
   /*LAL thingies needed. Have to be freed later*/
   
-  static LALStatus    status;
+  LALStatus           status;
   CoherentGW          waveform;
   SimInspiralTable    injParams;
   PPNParamStruc       ppnParams;
@@ -138,7 +139,7 @@ void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr,
   
   // Compute h_+ and h_x
   //LALHpHc(&thewaveform, hplusLAL, hcrossLAL, &lengthLAL, length, par, ifo[ifonr], ifonr);
-  LALHpHc12(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, run);  //ifonr is for debugging purposes
+  LALHpHc12(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, likePar);  //ifonr is for debugging purposes
   
   
   
@@ -166,17 +167,9 @@ void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr,
   //printf("lengthLAL = %d\n", lengthLAL);
   //printf("length: %d,  lengthLAL: %d,  i1: %d,  i2: %d\n", length, lengthLAL,indexstart, indexstart+lengthLAL);
   
-  for (i=0; i<length; ++i){
-    //MvdS:  Reduce the number of if statements:
-    //if(i<indexstart) ifo[ifonr]->FTin[i]   = 0.0;
-    //if(i>=indexstart && i<(indexstart+lengthLAL)) ifo[ifonr]->FTin[i] = wave[i-indexstart];
-    //if(i>=(indexstart+lengthLAL)) ifo[ifonr]->FTin[i]   = 0.0;
-    //ifo[ifonr]->FTin[i] = 0.0;
-    // if(i>=indexstart && i<(indexstart+lengthLAL)) ifo[ifonr]->FTin[i] = wave[i-indexstart];
-    ifo[ifonr]->FTin[i] = wave[i];
-  }
+  copyTemplate(ifo[ifonr], wave);  // Copy the template into FTin and record its support for taperTemplate()
   
-  free(wave);
+  ifo[ifonr]->scratchUsed = scratchMark;
   
 } // End of templateLAL12()
 // ****************************************************************************************************************************************************  
@@ -197,7 +190,7 @@ void templateLAL12(struct parSet *par, struct interferometer *ifo[], int ifonr,
  * l is a pointer to get the lenght of the waveform computed, this length is also available as waveform->phi->data->length.
  */
 // ****************************************************************************************************************************************************  
-void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, struct runPar run) {
+void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar) {
   
   //  static LALStatus    mystatus;
   
@@ -223,35 +216,35 @@ void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   double pMc=0.0,pEta=0.0,pTc=0.0,pLogDl=0.0,pSpin1=0.0,pSpCosTh1=0.0,pRA=0.0,pLongi=0.0,pSinDec=0.0,pPhase=0.0,pSinThJ0=0.0,pPhiJ0=0.0,pSpPhi1=0.0,PNorder=0.0;
   
   if(injectionWF==1) {                                               // Then this is an injection waveform template
-    pMc       = par->par[run.injRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.injRevID[62]];                                            // 62: eta
-    pTc       = par->par[run.injRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.injRevID[22]];                                            // 22: log(d_L)
-    pSpin1    = par->par[run.injRevID[71]];                                            // 71: a_spin1
-    pSpCosTh1 = par->par[run.injRevID[72]];                                            // 72: cos(theta_spin1)
-    pRA       = par->par[run.injRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pSinThJ0  = par->par[run.injRevID[53]];                                            // 53: sin(theta_J0)
-    pPhiJ0    = par->par[run.injRevID[54]];                                            // 54: phi_J0
-    pSpPhi1   = par->par[run.injRevID[73]];                                            // 73: phi_spin1    
+    pMc       = par->par[likePar->injRevID[61]];                                            // 61: Mc
+    pEta      = par->par[likePar->injRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->injRevID[11]];                                            // 11: t_c
+    pLogDl    = par->par[likePar->injRevID[22]];                                            // 22: log(d_L)
+    pSpin1    = par->par[likePar->injRevID[71]];                                            // 71: a_spin1
+    pSpCosTh1 = par->par[likePar->injRevID[72]];                                            // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->injRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pSinThJ0  = par->par[likePar->injRevID[53]];                                            // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->injRevID[54]];                                            // 54: phi_J0
+    pSpPhi1   = par->par[likePar->injRevID[73]];                                            // 73: phi_spin1    
     
-    PNorder   = run.injectionPNorder;                                                  // Post-Newtonian order
+    PNorder   = likePar->injectionPNorder;                                                  // Post-Newtonian order
   } else {                                                           // Then this is an MCMC waveform template
-    pMc       = par->par[run.parRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.parRevID[62]];                                            // 62: eta
-    pTc       = par->par[run.parRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.parRevID[22]];                                            // 22: log(d_L)  
-    pSpin1    = par->par[run.parRevID[71]];                                            // 71: a_spin1           
-    pSpCosTh1 = par->par[run.parRevID[72]];                                            // 72: cos(theta_spin1)
-    pRA       = par->par[run.parRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)     
-    pPhase    = par->par[run.parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pSinThJ0  = par->par[run.parRevID[53]];                                            // 53: sin(theta_J0)
-    pPhiJ0    = par->par[run.parRevID[54]];                                            // 54: phi_J0         
-    pSpPhi1   = par->par[run.parRevID[73]];                                            // 73: phi_spin1    
+    pMc       = par->par[likePar->parRevID[61]];                                            // 61: Mc
+    pEta      = par->par[likePar->parRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->parRevID[11]];                                            // 11: t_c
+    pLogDl    = par->par[likePar->parRevID[22]];                                            // 22: log(d_L)  
+    pSpin1    = par->par[likePar->parRevID[71]];                                            // 71: a_spin1           
+    pSpCosTh1 = par->par[likePar->parRevID[72]];                                            // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->parRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)     
+    pPhase    = par->par[likePar->parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pSinThJ0  = par->par[likePar->parRevID[53]];                                            // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->parRevID[54]];                                            // 54: phi_J0         
+    pSpPhi1   = par->par[likePar->parRevID[73]];                                            // 73: phi_spin1    
     
-    PNorder   = run.mcmcPNorder;                                                       // Post-Newtonian order
+    PNorder   = likePar->mcmcPNorder;                                                       // Post-Newtonian order
   }
   
   pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);    // RA -> 'lon'
@@ -420,7 +413,7 @@ void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   injParams->f_lower = (float)f_lower;
   
   //Remember we're in the 12-par routine here
-  char* waveformApproximant = (char*)calloc(128,sizeof(char));
+  char waveformApproximant[128];
   getWaveformApproximant("SpinTaylor",128,PNorder,waveformApproximant);  //Spinning
   //snprintf(waveformApproximant,128,"SpinTayloronePointFivePN"); //Set it manually
   //printf("\n  %s\n\n",waveformApproximant);
@@ -477,7 +470,6 @@ void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   ///////////////////////////////////////////////////////at this point the structure waveform is still allocated in memory and will have to be freed. See LALfreedomSpin below//////////
   
-  free(waveformApproximant);
   
   
 } // End of LALHpHc12()
@@ -498,9 +490,8 @@ void LALHpHc12(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
  * Use the LAL 3.5/2.5 PN spinning waveform, with 2 spinning objects (15 parameters) 
  */
 // ****************************************************************************************************************************************************  
-void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
-  int i=0;
   double samplerate=0.0,inversesamplerate=0.0;
   int length=0;
   
@@ -511,13 +502,15 @@ void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifon
   
   // double hplusLAL[length+2];
   // double hcrossLAL[length+2];
-  double *wave = (double*)calloc(length+2,sizeof(double));
+  size_t scratchMark = ifo[ifonr]->scratchUsed;  // wave is taken from the scratch arena of the IFO
+  double *wave = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*(length+2));
+  memset(wave, 0, sizeof(double)*(length+2));
   int lengthLAL = 0;
   
   
   /*LAL thingies needed. Have to be freed later*/
   
-  static LALStatus    status;
+  LALStatus           status;
   CoherentGW          waveform;
   SimInspiralTable    injParams;
   PPNParamStruc       ppnParams;
@@ -535,8 +528,12 @@ void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifon
   
   // Compute h_+ and h_x
   //LALHpHc(&thewaveform, hplusLAL, hcrossLAL, &lengthLAL, length, par, ifo[ifonr], ifonr);
-  LALHpHc15(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, run);
-  
+  LALHpHc15(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, likePar);
+  if(status.statusCode) {
+    setTemplateSupport(ifo[ifonr], 0, -1);  // Empty template
+    ifo[ifonr]->scratchUsed = scratchMark;
+    return;
+  }
   
   
   
@@ -564,17 +561,9 @@ void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifon
   //printf("lengthLAL = %d\n", lengthLAL);
   //printf("length: %d,  lengthLAL: %d,  i1: %d,  i2: %d\n", length, lengthLAL,indexstart, indexstart+lengthLAL);
   
-  for (i=0; i<length; ++i){
-    //MvdS:  Reduce the number of if statements:
-    //if(i<indexstart) ifo[ifonr]->FTin[i]   = 0.0;
-    //if(i>=indexstart && i<(indexstart+lengthLAL)) ifo[ifonr]->FTin[i] = wave[i-indexstart];
-    //if(i>=(indexstart+lengthLAL)) ifo[ifonr]->FTin[i]   = 0.0;
-    //ifo[ifonr]->FTin[i] = 0.0;
-    // if(i>=indexstart && i<(indexstart+lengthLAL)) ifo[ifonr]->FTin[i] = wave[i-indexstart];
-    ifo[ifonr]->FTin[i] = wave[i];
-  }
+  copyTemplate(ifo[ifonr], wave);  // Copy the template into FTin and record its support for taperTemplate()
   
-  free(wave);
+  ifo[ifonr]->scratchUsed = scratchMark;
   
 } // End of templateLAL15old()
 // ****************************************************************************************************************************************************  
@@ -593,10 +582,12 @@ void templateLAL15old(struct parSet *par, struct interferometer *ifo[], int ifon
  * 
  * Compute h_+ and h_x form the parameters in par and interferometer information in ifo. 
  * l is a pointer to get the lenght of the waveform computed, this length is also available in waveform->phi->data->length.
+ * Only the cut-off frequencies and sampling rate are taken from ifo, so that h_+,h_x can be projected onto any detector with 
+ * the same settings (see templateLALnetwork()).  If an MCMC template fails, status->statusCode is non-zero on return.
  */
 // ****************************************************************************************************************************************************  
 void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, 
-               struct interferometer *ifo, int injectionWF, struct runPar run) 
+               struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar) 
 {
   
   // static LALStatus    mystatus;
@@ -628,45 +619,45 @@ void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   double pSpin1=0.0,pSpCosTh1=0.0,pSpPhi1=0.0,pSpin2=0.0,pSpCosTh2=0.0,pSpPhi2=0.0,PNorder=0.0;
   
   if(injectionWF==1) {                                               // Then this is an injection waveform template
-    pTc       = par->par[run.injRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.injRevID[22]];                                            // 22: log(d_L)
-    pMc       = par->par[run.injRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.injRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->injRevID[11]];                                            // 11: t_c
+    pLogDl    = par->par[likePar->injRevID[22]];                                            // 22: log(d_L)
+    pMc       = par->par[likePar->injRevID[61]];                                            // 61: Mc
+    pEta      = par->par[likePar->injRevID[62]];                                            // 62: eta
     
-    pRA       = par->par[run.injRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.injRevID[51]];                                            // 51: cos(inclination)
-    pPsi      = par->par[run.injRevID[52]];                                            // 52: psi: polarisation angle
+    pRA       = par->par[likePar->injRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->injRevID[51]];                                            // 51: cos(inclination)
+    pPsi      = par->par[likePar->injRevID[52]];                                            // 52: psi: polarisation angle
     
-    pSpin1    = par->par[run.injRevID[71]];                                            // 71: a_spin1
-    pSpCosTh1 = par->par[run.injRevID[72]];                                            // 72: cos(theta_spin1)
-    pSpPhi1   = par->par[run.injRevID[73]];                                            // 73: phi_spin1    
-    pSpin2    = par->par[run.injRevID[81]];                                            // 81: a_spin2
-    pSpCosTh2 = par->par[run.injRevID[82]];                                            // 82: cos(theta_spin2)
-    pSpPhi2   = par->par[run.injRevID[83]];                                            // 83: phi_spin2    
+    pSpin1    = par->par[likePar->injRevID[71]];                                            // 71: a_spin1
+    pSpCosTh1 = par->par[likePar->injRevID[72]];                                            // 72: cos(theta_spin1)
+    pSpPhi1   = par->par[likePar->injRevID[73]];                                            // 73: phi_spin1    
+    pSpin2    = par->par[likePar->injRevID[81]];                                            // 81: a_spin2
+    pSpCosTh2 = par->par[likePar->injRevID[82]];                                            // 82: cos(theta_spin2)
+    pSpPhi2   = par->par[likePar->injRevID[83]];                                            // 83: phi_spin2    
     
-    PNorder   = run.injectionPNorder;                                                  // Post-Newtonian order
+    PNorder   = likePar->injectionPNorder;                                                  // Post-Newtonian order
   } else {                                                           // Then this is an MCMC waveform template
-    pTc       = par->par[run.parRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.parRevID[22]];                                            // 22: log(d_L)
-    pMc       = par->par[run.parRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.parRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->parRevID[11]];                                            // 11: t_c
+    pLogDl    = par->par[likePar->parRevID[22]];                                            // 22: log(d_L)
+    pMc       = par->par[likePar->parRevID[61]];                                            // 61: Mc
+    pEta      = par->par[likePar->parRevID[62]];                                            // 62: eta
     
-    pRA       = par->par[run.parRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.parRevID[51]];                                            // 51: cos(inclination) of the binary
-    pPsi      = par->par[run.parRevID[52]];                                            // 52: psi: polarisation angle of the binary
+    pRA       = par->par[likePar->parRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->parRevID[51]];                                            // 51: cos(inclination) of the binary
+    pPsi      = par->par[likePar->parRevID[52]];                                            // 52: psi: polarisation angle of the binary
     
-    pSpin1    = par->par[run.parRevID[71]];                                            // 71: a_spin1
-    pSpCosTh1 = par->par[run.parRevID[72]];                                            // 72: cos(theta_spin1)
-    pSpPhi1   = par->par[run.parRevID[73]];                                            // 73: phi_spin1    
-    pSpin2    = par->par[run.parRevID[81]];                                            // 81: a_spin2
-    pSpCosTh2 = par->par[run.parRevID[82]];                                            // 82: cos(theta_spin2)
-    pSpPhi2   = par->par[run.parRevID[83]];                                            // 83: phi_spin2    
+    pSpin1    = par->par[likePar->parRevID[71]];                                            // 71: a_spin1
+    pSpCosTh1 = par->par[likePar->parRevID[72]];                                            // 72: cos(theta_spin1)
+    pSpPhi1   = par->par[likePar->parRevID[73]];                                            // 73: phi_spin1    
+    pSpin2    = par->par[likePar->parRevID[81]];                                            // 81: a_spin2
+    pSpCosTh2 = par->par[likePar->parRevID[82]];                                            // 82: cos(theta_spin2)
+    pSpPhi2   = par->par[likePar->parRevID[83]];                                            // 83: phi_spin2    
     
-    PNorder   = run.mcmcPNorder;                                                       // Post-Newtonian order
+    PNorder   = likePar->mcmcPNorder;                                                       // Post-Newtonian order
   }
   
   pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);    // RA -> 'lon'
@@ -691,7 +682,7 @@ void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   injParams->f_lower = (float)f_lower;
   
   //Remember we're in the 15-par routine here
-  char* waveformApproximant = (char*)calloc(128,sizeof(char));
+  char waveformApproximant[128];
   getWaveformApproximant("SpinTaylor",128,PNorder,waveformApproximant);  //Spinning
   //snprintf(waveformApproximant,128,"%s","SpinTaylorthreePointFivePN"); //Set it manually
   //printf("\n  %s\n\n",waveformApproximant);
@@ -739,9 +730,13 @@ void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   LALGenerateInspiral( status, waveform, injParams, ppnParams );
   if(status->statusCode) {
-    fprintf(stderr, "\n\n   LALHpHc15:  ERROR generating waveform\n" );
-    REPORTSTATUS(status);
-    exit(1);
+    if(injectionWF==1) {
+      fprintf(stderr, "\n\n   LALHpHc15():  ERROR generating injection waveform %s (too high mass?)\n   Aborting...\n\n", waveformApproximant);
+      REPORTSTATUS(status);
+      exit(1);
+    }
+    *l = 0;                    // MCMC template: leave status->statusCode set for the caller to check
+    return;
   }
   // printf("ppnParams->tc = %f\n",ppnParams->tc);
   // LALInfo( status, ppnParams.termDescription );
@@ -757,7 +752,6 @@ void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   ///////////////////////////////////////////////////////at this point the structure waveform is still allocated in memory and will have to be freed. See LALfreedomSpin below//////////
   
-  free(waveformApproximant);
   
   
 } // End of LALHpHc15()
@@ -781,77 +775,20 @@ void LALHpHc15(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
  * Use the LAL 3.5/2.5 PN spinning waveform, with 2 spinning objects (15 parameters) 
  */
 // ****************************************************************************************************************************************************  
-void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
-  
-  // Get the 15 waveform parameters from their array:
-  double pMc=0.0,pEta=0.0,pTc=0.0,pLogDl=0.0,pRA=0.0,pLongi=0.0,pSinDec=0.0,pPhase=0.0,pCosI=0.0,pPsi=0.0;
-  double pSpin1=0.0,pSpCosTh1=0.0,pSpPhi1=0.0,pSpin2=0.0,pSpCosTh2=0.0,pSpPhi2=0.0,PNorder=0.0;
-  
-  if(injectionWF==1) {                                               // Then this is an injection waveform template
-    pTc       = par->par[run.injRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.injRevID[22]];                                            // 22: log(d_L)
-    pMc       = par->par[run.injRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.injRevID[62]];                                            // 62: eta
-    
-    pRA       = par->par[run.injRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.injRevID[51]];                                            // 51: cos(inclination)
-    pPsi      = par->par[run.injRevID[52]];                                            // 52: psi: polarisation angle
-    
-    pSpin1    = par->par[run.injRevID[71]];                                            // 71: a_spin1
-    pSpCosTh1 = par->par[run.injRevID[72]];                                            // 72: cos(theta_spin1)
-    pSpPhi1   = par->par[run.injRevID[73]];                                            // 73: phi_spin1    
-    pSpin2    = par->par[run.injRevID[81]];                                            // 81: a_spin2
-    pSpCosTh2 = par->par[run.injRevID[82]];                                            // 82: cos(theta_spin2)
-    pSpPhi2   = par->par[run.injRevID[83]];                                            // 83: phi_spin2    
-    
-    PNorder   = run.injectionPNorder;                                                  // Post-Newtonian order
-  } else {                                                           // Then this is an MCMC waveform template
-    pTc       = par->par[run.parRevID[11]];                                            // 11: t_c
-    pLogDl    = par->par[run.parRevID[22]];                                            // 22: log(d_L)
-    pMc       = par->par[run.parRevID[61]];                                            // 61: Mc
-    pEta      = par->par[run.parRevID[62]];                                            // 62: eta
-    
-    pRA       = par->par[run.parRevID[31]];                                            // 31: RA
-    pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.parRevID[51]];                                            // 51: cos(inclination) of the binary
-    pPsi      = par->par[run.parRevID[52]];                                            // 52: psi: polarisation angle of the binary
-    
-    pSpin1    = par->par[run.parRevID[71]];                                            // 71: a_spin1
-    pSpCosTh1 = par->par[run.parRevID[72]];                                            // 72: cos(theta_spin1)
-    pSpPhi1   = par->par[run.parRevID[73]];                                            // 73: phi_spin1    
-    pSpin2    = par->par[run.parRevID[81]];                                            // 81: a_spin2
-    pSpCosTh2 = par->par[run.parRevID[82]];                                            // 82: cos(theta_spin2)
-    pSpPhi2   = par->par[run.parRevID[83]];                                            // 83: phi_spin2    
-    
-    PNorder   = run.mcmcPNorder;                                                       // Post-Newtonian order
-  }
-  
-  pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);    // RA -> 'lon'
-  
-  // Get masses from Mch and eta:
-  double m1,m2;
-  McEta2masses(pMc,pEta,&m1,&m2);
-  
-  //printf(" LAL two-spin WF pars:  injWF: %i, Mc: %f, eta: %f, tc: %f, logD: %f, RA: %f, dec: %f, phi: %f, cos(i): %f, psi: %f,  a1: %f, cth1: %f, phi1: %f,  a2: %f, cth2: %f, phi2: %f\n",
-  //injectionWF,pMc, pEta, pTc, pLogDl, pRA, pSinDec, pPhase, pCosI, pPsi,  pSpin1, pSpCosTh1, pSpPhi1,  pSpin2, pSpCosTh2, pSpPhi2);
-  //printf(" Mc: %f,  M1: %f,  M2: %f,  Mtot: %f\n",pMc,m1,m2,m1+m2);
-  
-  
-  // Cannot compute templates for Mtot >~ 146Mo (?).  Use 140Mo.
   int length = ifo[ifonr]->samplesize;
-  int i=0;
+  int lengthLAL=0;
   
   
   double samplerate = (double)ifo[ifonr]->samplerate;
   double inversesamplerate = 1.0/samplerate;
-  double *wave = (double*)calloc(length+2,sizeof(double));
+  size_t scratchMark = ifo[ifonr]->scratchUsed;  // wave is taken from the scratch arena of the IFO
+  double *wave = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*(length+2));
+  memset(wave, 0, sizeof(double)*(length+2));
   
   // LAL thingies needed. Have to be freed later:
-  static LALStatus    status;
+  LALStatus           status;
   CoherentGW          waveform;
   SimInspiralTable    injParams;
   PPNParamStruc       ppnParams;
@@ -866,71 +803,15 @@ void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr,
   ppnParams.ppn      = NULL;
   
   
-  ////////////////////////////////////////////////////////////now we fill the injParam structure with the parameters//////////////
-  
-  injParams.mass1 = (float)m1;
-  injParams.mass2 = (float)m2;
-  
-  injParams.f_final = (float)ifo[ifonr]->highCut;  // It seems injParams.f_final gets overwritten by LALGenerateInspiral; it's an output parameter rather than input. This will also somewhat affect SNR comparisons with the Apostolatos waveform.
-  injParams.f_lower = (float)ifo[ifonr]->lowCut;
-  
-  // Remember we're in the 15-par routine here:
-  char* waveformApproximant = (char*)calloc(128,sizeof(char));
-  getWaveformApproximant("SpinTaylor",128,PNorder,waveformApproximant);  //Spinning
-  //snprintf(waveformApproximant,128,"%s","SpinTaylorthreePointFivePN"); //Set it manually
-  
-  snprintf(injParams.waveform,LIGOMETA_WAVEFORM_MAX*sizeof(CHAR),"%s",waveformApproximant);
-  
-  // This is given in Mpc:
-  injParams.distance = (float)exp(pLogDl); // d_L;
-  
-  injParams.inclination = (float)acos(pCosI);                      // Inclination of the binary
-  
-  double pSpsinth1 = sqrt(1.0 - pSpCosTh1*pSpCosTh1);
-  injParams.spin1x = (float)(pSpin1 * pSpsinth1 * cos(pSpPhi1));
-  injParams.spin1y = (float)(pSpin1 * pSpsinth1 * sin(pSpPhi1));
-  injParams.spin1z = (float)(pSpin1 * pSpCosTh1);
-  
-  double pSpsinth2 = sqrt(1.0 - pSpCosTh2*pSpCosTh2);
-  injParams.spin2x = (float)(pSpin2 * pSpsinth2 * cos(pSpPhi2));
-  injParams.spin2y = (float)(pSpin2 * pSpsinth2 * sin(pSpPhi2));
-  injParams.spin2z = (float)(pSpin2 * pSpCosTh2);
-  
-  // 4 parameters used after the computation of h+,x ********************//
-  injParams.coa_phase = (float)pPhase;                                      // GW phase at coalescence
-  injParams.longitude = (float)pLongi;                                      // 'Longitude'
-  injParams.latitude = (float)asin(pSinDec);                                // Declination
-  injParams.polarization = (float)pPsi;                                     // Polarisation angle
-  
-  REAL8 geocent_end_time = pTc;
-  
-  XLALGPSSetREAL8( &(injParams.geocent_end_time), geocent_end_time );
-  
-  ppnParams.deltaT = inversesamplerate;
-  
-  
-  //Print output:
-  //  printf("  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf  %lf\n",
-  //     injParams.mass1,injParams.mass2,injParams.f_final,injParams.f_lower,injParams.distance,injParams.inclination,injParams.spin1x,injParams.spin1y,injParams.spin1z,
-  //     injParams.spin2x,injParams.spin2y,injParams.spin2z,injParams.coa_phase,injParams.longitude,injParams.latitude,injParams.polarization);
-  
-  
-  // Call the injection function:
-  LALGenerateInspiral( &status, &waveform, &injParams, &ppnParams );
-	if(status.statusCode) {
-    if(injectionWF==1) {
-      fprintf(stderr, "\n\n   templateLAL15():  ERROR generating injection waveform %s (too high mass?)\n   Aborting...\n\n", waveformApproximant);
-      REPORTSTATUS(&status);
-      exit(1);
-    }
-    for(i=0; i<length; ++i) ifo[ifonr]->FTin[i] = 0.0;
-		
+  // Compute h_+ and h_x:
+  LALHpHc15(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, likePar);
+  if(status.statusCode) {
+    setTemplateSupport(ifo[ifonr], 0, -1);  // Empty template
+    
     //LALfreedomNoSpin(&waveform);  //Why does this give a seg.fault here, but not at the end of the routine?
-    free(wave);
-    free(waveformApproximant);
+    ifo[ifonr]->scratchUsed = scratchMark;
     return;
   }
-  // LALInfo( status, ppnParams.termDescription );
   
   
   
@@ -939,10 +820,9 @@ void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr,
   delay = delay; //MvdS: remove 'declared but never referenced' warnings
   
   
-  for (i=0; i<length; ++i) ifo[ifonr]->FTin[i] = wave[i];
+  copyTemplate(ifo[ifonr], wave);  // Copy the template into FTin and record its support for taperTemplate()
   
-  free(wave);
-  free(waveformApproximant);
+  ifo[ifonr]->scratchUsed = scratchMark;
   LALfreedomSpin(&waveform);
   
 } // End of templateLAL15()
@@ -951,74 +831,67 @@ void templateLAL15(struct parSet *par, struct interferometer *ifo[], int ifonr,
 
 
 
-
 // ****************************************************************************************************************************************************  
 /**
  * \brief Compute waveform for a 15-parameter (two spins) LAL PhenSpinTaylorRD waveform
  * 
- * Use the LAL 3.5/2.5 PN spinning hybrid PhenSpinTaylorRD waveform, with 2 spinning objects (15 parameters). Phenomenological ring-down attached
+ * Use the LAL 3.5/2.5 PN spinning hybrid PhenSpinTaylorRD waveform, with 2 spinning objects (15 parameters). Phenomenological ring-down attached.
+ * The detector response is computed, time shifted and resampled to the data in a single pass into ifo[ifonr]->FTin, without intermediate 
+ * time series.
  */
 // ****************************************************************************************************************************************************  
-void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
 	
 	// Get the 15 waveform parameters from their array:
 	double pMc=0.0,pEta=0.0,pTc=0.0,pLogDl=0.0,pRA=0.0,pLongi=0.0,pSinDec=0.0,pPhase=0.0,pCosI=0.0,pPsi=0.0;
 	double pSpin1=0.0,pSpCosTh1=0.0,pSpPhi1=0.0,pSpin2=0.0,pSpCosTh2=0.0,pSpPhi2=0.0,PNorder=0.0;
 	//REAL8 h1, h2, phi, shift;
-	REAL4TimeSeries *htData = NULL;
-	CHAR ifoname[LIGOMETA_IFO_MAX];
-	INT8 waveformStartTime;
-	INT4 dataLength, wfmLength;
-	float *x1;
 	
 	if(injectionWF==1) {                                               // Then this is an injection waveform template
-		pTc       = par->par[run.injRevID[11]];                                            // 11: t_c
-		pLogDl    = par->par[run.injRevID[22]];                                            // 22: log(d_L)
-		pMc       = par->par[run.injRevID[61]];                                            // 61: Mc
-		pEta      = par->par[run.injRevID[62]];                                            // 62: eta
+		pTc       = par->par[likePar->injRevID[11]];                                            // 11: t_c
+		pLogDl    = par->par[likePar->injRevID[22]];                                            // 22: log(d_L)
+		pMc       = par->par[likePar->injRevID[61]];                                            // 61: Mc
+		pEta      = par->par[likePar->injRevID[62]];                                            // 62: eta
 		
-		pRA       = par->par[run.injRevID[31]];                                            // 31: RA
-		pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
-		pPhase    = par->par[run.injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-		pCosI     = par->par[run.injRevID[51]];                                            // 51: cos(inclination)
-		pPsi      = par->par[run.injRevID[52]];                                            // 52: psi: polarisation angle
+		pRA       = par->par[likePar->injRevID[31]];                                            // 31: RA
+		pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
+		pPhase    = par->par[likePar->injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+		pCosI     = par->par[likePar->injRevID[51]];                                            // 51: cos(inclination)
+		pPsi      = par->par[likePar->injRevID[52]];                                            // 52: psi: polarisation angle
 		
-		pSpin1    = par->par[run.injRevID[71]];                                            // 71: a_spin1
-		pSpCosTh1 = par->par[run.injRevID[72]];                                            // 72: cos(theta_spin1)
-		pSpPhi1   = par->par[run.injRevID[73]];                                            // 73: phi_spin1    
-		pSpin2    = par->par[run.injRevID[81]];                                            // 81: a_spin2
-		pSpCosTh2 = par->par[run.injRevID[82]];                                            // 82: cos(theta_spin2)
-		pSpPhi2   = par->par[run.injRevID[83]];                                            // 83: phi_spin2    
+		pSpin1    = par->par[likePar->injRevID[71]];                                            // 71: a_spin1
+		pSpCosTh1 = par->par[likePar->injRevID[72]];                                            // 72: cos(theta_spin1)
+		pSpPhi1   = par->par[likePar->injRevID[73]];                                            // 73: phi_spin1    
+		pSpin2    = par->par[likePar->injRevID[81]];                                            // 81: a_spin2
+		pSpCosTh2 = par->par[likePar->injRevID[82]];                                            // 82: cos(theta_spin2)
+		pSpPhi2   = par->par[likePar->injRevID[83]];                                            // 83: phi_spin2    
 		
-		PNorder   = run.injectionPNorder;                                                  // Post-Newtonian order
+		PNorder   = likePar->injectionPNorder;                                                  // Post-Newtonian order
 	} else {                                                           // Then this is an MCMC waveform template
-		pTc       = par->par[run.parRevID[11]];                                            // 11: t_c
-		pLogDl    = par->par[run.parRevID[22]];                                            // 22: log(d_L)
-		pMc       = par->par[run.parRevID[61]];                                            // 61: Mc
-		pEta      = par->par[run.parRevID[62]];                                            // 62: eta
+		pTc       = par->par[likePar->parRevID[11]];                                            // 11: t_c
+		pLogDl    = par->par[likePar->parRevID[22]];                                            // 22: log(d_L)
+		pMc       = par->par[likePar->parRevID[61]];                                            // 61: Mc
+		pEta      = par->par[likePar->parRevID[62]];                                            // 62: eta
 		
-		pRA       = par->par[run.parRevID[31]];                                            // 31: RA
-		pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)
-		pPhase    = par->par[run.parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-		pCosI     = par->par[run.parRevID[51]];                                            // 51: cos(inclination) of the binary
-		pPsi      = par->par[run.parRevID[52]];                                            // 52: psi: polarisation angle of the binary
+		pRA       = par->par[likePar->parRevID[31]];                                            // 31: RA
+		pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)
+		pPhase    = par->par[likePar->parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+		pCosI     = par->par[likePar->parRevID[51]];                                            // 51: cos(inclination) of the binary
+		pPsi      = par->par[likePar->parRevID[52]];                                            // 52: psi: polarisation angle of the binary
 		
-		pSpin1    = par->par[run.parRevID[71]];                                            // 71: a_spin1
-		pSpCosTh1 = par->par[run.parRevID[72]];                                            // 72: cos(theta_spin1)
-		pSpPhi1   = par->par[run.parRevID[73]];                                            // 73: phi_spin1    
-		pSpin2    = par->par[run.parRevID[81]];                                            // 81: a_spin2
-		pSpCosTh2 = par->par[run.parRevID[82]];                                            // 82: cos(theta_spin2)
-		pSpPhi2   = par->par[run.parRevID[83]];                                            // 83: phi_spin2    
+		pSpin1    = par->par[likePar->parRevID[71]];                                            // 71: a_spin1
+		pSpCosTh1 = par->par[likePar->parRevID[72]];                                            // 72: cos(theta_spin1)
+		pSpPhi1   = par->par[likePar->parRevID[73]];                                            // 73: phi_spin1    
+		pSpin2    = par->par[likePar->parRevID[81]];                                            // 81: a_spin2
+		pSpCosTh2 = par->par[likePar->parRevID[82]];                                            // 82: cos(theta_spin2)
+		pSpPhi2   = par->par[likePar->parRevID[83]];                                            // 83: phi_spin2    
 		
-		PNorder   = run.mcmcPNorder;                                                       // Post-Newtonian order
+		PNorder   = likePar->mcmcPNorder;                                                       // Post-Newtonian order
 	}
 	
 	pLongi = pRA; //XLALComputeDetAMResponse() takes RA. fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);    // RA -> 'lon'
 	
-	double temp_ra = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);
-	printf("temp_ra=%f\n",temp_ra);
-	
 	// Get masses from Mch and eta:
 	double m1,m2;
 	McEta2masses(pMc,pEta,&m1,&m2);
@@ -1031,14 +904,13 @@ void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[
 	// Cannot compute templates for Mtot >~ 146Mo (?).  Use 140Mo.
 	int length = ifo[ifonr]->samplesize;
 	int i=0;
-	for ( i = 0; i < length; i++ ) {ifo[ifonr]->FTin[i] = 0.0;}
+	setTemplateSupport(ifo[ifonr], 0, -1);  // Start from an empty template
 	
 	REAL8 samplerate = (double)ifo[ifonr]->samplerate;
 	double inversesamplerate = 1.0/samplerate;
-	double *wave = (double*)calloc(length+2,sizeof(double));
 	
 	// LAL thingies needed. Have to be freed later:
-	static LALStatus    status;
+	LALStatus           status;
 	CoherentGW          waveform;
 	SimInspiralTable    injParams;
 	PPNParamStruc       ppnParams;
@@ -1062,7 +934,7 @@ void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[
 	injParams.f_lower = (float)ifo[ifonr]->lowCut;
 	
 	// Remember we're in the 15-par routine here:
-	char* waveformApproximant = (char*)calloc(128,sizeof(char));
+	char waveformApproximant[128];
 	getWaveformApproximant("PhenSpinTaylorRD",128,PNorder,waveformApproximant);  //Spinning
 	//snprintf(waveformApproximant,128,"%s","SpinTaylorthreePointFivePN"); //Set it manually
 	
@@ -1120,15 +992,11 @@ void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[
 		}
 		if(waveform.h == NULL){fprintf(stderr,"waveform.h == NULL\n");}
 		REPORTSTATUS(&status);
-		for(i=0; i<length; ++i) ifo[ifonr]->FTin[i] = 0.0;
+		setTemplateSupport(ifo[ifonr], 0, -1);
     //printf("wave at zero\n");
 		//LALfreedomPhenSpinTaylorRD(&waveform);
-		//XLALDestroyREAL4Vector ( htData->data);
-		//LALFree(htData);
 		
 		//LALfreedomNoSpin(&waveform);  //Why does this give a seg.fault here, but not at the end of the routine?
-		free(wave);
-		free(waveformApproximant);
 		return;
 	}
 	// LALInfo( status, ppnParams.termDescription );
@@ -1146,255 +1014,54 @@ void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[
 //	detector.transfer = NULL;
 //	detector.ephemerides = NULL;
 	
-	switch ( ifonr )
-	{
-		case 0:
-		//	*(detector.site) = lalCachedDetectors[LALDetectorIndexLHODIFF];
-			strcpy(ifoname, "H1");
-			break;
-		case 1:
-		//	*(detector.site) = lalCachedDetectors[LALDetectorIndexLLODIFF];
-			strcpy(ifoname, "L1");
-			break;
-		case 2:
-		//	*(detector.site) = lalCachedDetectors[LALDetectorIndexVIRGODIFF];
-			strcpy(ifoname, "V1");
-			break;
-		default:
-		//	LALFree( detector.site );
-		//	detector.site = NULL;
-			fprintf(stderr, "\n\n   Unknown detector site ifonr=%d\n   Aborting...\n\n",ifonr);
-			REPORTSTATUS(&status);
-			exit(1);
-			break;
-	}
-	
-	waveformStartTime = XLALGPSToINT8NS( &(injParams.geocent_end_time) );
-	waveformStartTime -= (INT8) ( 1000000000.0 * ppnParams.tc );
-
-	XLALINT8NSToGPS( &(waveform.h->epoch), waveformStartTime );
-//	memcpy( &(waveform.f->epoch), &(waveform.h->epoch),
-//		   sizeof(LIGOTimeGPS) );
-//	memcpy( &(waveform.phi->epoch), &(waveform.h->epoch),
-//		   sizeof(LIGOTimeGPS) );
-//	memcpy( &(waveform.a->epoch), &(waveform.a->epoch),
-//		   sizeof(LIGOTimeGPS) );
-
-	wfmLength = waveform.h->data->length;
-	dataLength = 2*wfmLength;
-	x1 = (float *) LALMalloc(sizeof(x1)*dataLength);
-	/*
-	 * We are using functions from NRWaveInject which do not take a vector
-	 * with alternating h+ & hx but rather one that stores h+ in the first
-	 * half and hx in the second half.
-	 *
-	 * We also must multiply the strain by the distance to be compatible
-	 * with NRWaveInject.
-	 *
-	 */
-	for( i = 0; i < dataLength; i++)
-	{
-        x1[i] = waveform.h->data->data[i]*injParams.distance;
-	}
-	for( i = 0; i < wfmLength; i++)
-	{
-		waveform.h->data->data[i] = x1[2*i];
-		waveform.h->data->data[wfmLength+i] = x1[2*i+1];
-	}
-	
-	LALFree(x1);
-	
-	waveform.h->data->vectorLength = wfmLength;
-	
-	INT4 sampleRate = (INT4)samplerate;
-	
-	// Compute the detector response:
-	//htData = XLALCalculateNRStrain( waveform.h, &injParams, ifoname, sampleRate );
-	
-	
-	
-	LALDetector            det;
-	double                 fplus;
-	double                 fcross;
-	double                 tDelay;
-	//REAL4TimeSeries       *htData = NULL;
-	UINT4                  vecLength, k;
-	InterferometerNumber   ifoNumber = LAL_UNKNOWN_IFO;
-	
-	/* get the detector information */
-	memset( &det, 0, sizeof(LALDetector) );
-	ifoNumber = (InterferometerNumber)XLALIFONumber( ifoname );
-	XLALReturnDetector( &det, ifoNumber );
-	
-	if( ifoNumber == LAL_UNKNOWN_IFO )
-	{
-		XLALPrintWarning( "Unknown ifo! Injecting signal overhead!\n" );
-		fplus  = 1.0;
-		fcross = 0.0;
-		tDelay = 0.0;
-	}
-	else
-	{
-		/* compute detector response */
-		XLALComputeDetAMResponse(&fplus, &fcross, det.response, injParams.longitude,
-								 injParams.latitude, injParams.polarization, injParams.end_time_gmst);
-		
-		/* calculate the time delay */
-		tDelay = XLALTimeDelayFromEarthCenter( det.location, injParams.longitude,
-											  injParams.latitude, &(injParams.geocent_end_time) );
-	}
-	
-	/* create htData */
-	htData = LALCalloc(1, sizeof(*htData));
-	if (!htData)
-	{
-		printf("hData unassigned\n");
-		//ABORTXLAL( &status );
-		exit(1);
-	}
-	vecLength = waveform.h->data->vectorLength;
-	htData->data = XLALCreateREAL4Vector( vecLength );
-	if ( ! htData->data )
-	{
-		LALFree( htData );
-		printf("hData->data unassigned\n");
-		//ABORTXLAL( &status );
-		exit(1);
-	}
-	
-	/* store the htData */
-	
-	/* add timedelay to inj->geocent_end_time */
-	{
-		REAL8 tEnd;
-		tEnd =  XLALGPSGetREAL8(&(injParams.geocent_end_time) );
-		tEnd += tDelay;
-		XLALGPSSetREAL8(&(htData->epoch), tEnd );
-	}
-	/* Using XLALGPSAdd is bad because that changes the GPS time! */
-	/*  htData->epoch = *XLALGPSAdd( &(inj->geocent_end_time), tDelay ); */
-	
-	htData->deltaT = waveform.h->deltaT;
-	htData->sampleUnits = lalADCCountUnit;
-	
-	for ( k = 0; k < vecLength; ++k )
-	{
-	  htData->data->data[k] = (float)(fplus * waveform.h->data->data[k]  +
-				   fcross * waveform.h->data->data[vecLength + k]) / injParams.distance;
-	}
-	
-	/*interpolate to given sample rate */
-	//htData = XLALInterpolateNRWave( htData, sampleRate);
-
-
-	
-	
-	
-	
-	
-	REAL4TimeSeries *ret=NULL;
-	REAL8 deltaTin, deltaTout, r, y_1, y_2;
-	REAL8 tObs; /* duration of signal */
-	UINT4 lo, numPoints;
-	
-	deltaTin = htData->deltaT;
-	tObs = deltaTin * htData->data->length;
-	
-	/* length of output vector */
-	numPoints = (UINT4) (sampleRate * tObs);
-	
-	/* allocate memory */
-	ret = LALCalloc(1, sizeof(*ret));
-	if (!ret)
-	{
-		printf("ret unassigned\n");
-		//ABORTXLAL( &status );
-		exit(1);
-	}
-	
-	ret->data = XLALCreateREAL4Vector( numPoints );
-	if (! ret->data)
-	{
-		printf("ret->data unassigned\n");
-		//ABORTXLAL( &status );
-		exit(1);
-	}
-	
-	ret->deltaT = 1./sampleRate;
-	deltaTout = ret->deltaT;
-	
-	/* copy stuff from in which should be the same */
-	ret->epoch = htData->epoch;
-	ret->f0 = htData->f0;
-	ret->sampleUnits = htData->sampleUnits;
-	strcpy(ret->name, htData->name);
-	
-	/* go over points of output vector and interpolate linearly
-     using closest points of input */
-	for (k = 0; k < numPoints; k++) {
-		
-		lo = (UINT4)( k*deltaTout / deltaTin);
-		
-		/* y_1 and y_2 are the input values at x1 and x2 */
-		/* here we need to make sure that we don't exceed
-		 bounds of input vector */
-		if ( lo < htData->data->length - 1) {
-			y_1 = htData->data->data[lo];
-			y_2 = htData->data->data[lo+1];
-			
-			/* we want to calculate y_2*r + y_1*(1-r) where
-			 r = (x-x1)/(x2-x1) */
-			r = k*deltaTout / deltaTin - lo;
-			
-			ret->data->data[k] = (float)(y_2 * r + y_1 * (1 - r));
-		}
-		else {
-			ret->data->data[k] = 0.0;
+	// The detector is found by name in setLALresponse(), not by its number in the network.  IFOinit() sets it up;  an injection 
+	//   template may come first:
+	if(ifo[ifonr]->lalSignal.data==NULL) setLALresponse(ifo[ifonr], length);
+	LALDetector *det = &(ifo[ifonr]->lalSite);
+	double fplus=0.0, fcross=0.0, tDelay=0.0;
+	
+	// Compute the detector response and the time delay:
+	XLALComputeDetAMResponse(&fplus, &fcross, det->response, injParams.longitude,
+							 injParams.latitude, injParams.polarization, injParams.end_time_gmst);
+	tDelay = XLALTimeDelayFromEarthCenter( det->location, injParams.longitude,
+										  injParams.latitude, &(injParams.geocent_end_time) );
+	
+	
+	// Project the waveform onto the detector, shift it to its arrival time and resample it to the data in one step, straight into FTin.
+	//   waveform.h holds (h+,hx) pairs.  The peak of the amplitude (the coalescence time of XLALFindNRCoalescenceTime()) arrives at
+	//   t_c + tDelay;  each sample of FTin is interpolated linearly between the two nearest samples of the waveform:
+	int wfmLength = (int)waveform.h->data->length;
+	REAL4 *hpc = waveform.h->data->data;
+	double deltaTin = waveform.h->deltaT;
+	double ampSq=0.0, maxAmpSq=0.0, x=0.0, r=0.0;
+	int k=0, kPeak=0, lo=0;
+	
+	for(k=0; k<wfmLength; k++) {
+		ampSq = hpc[2*k]*hpc[2*k] + hpc[2*k+1]*hpc[2*k+1];
+		if(ampSq > maxAmpSq) {
+			kPeak = k;
+			maxAmpSq = ampSq;
 		}
 	}
 	
-	if ( !ret )
-	{
-		printf("ret unassigned\n");
-		//ABORTXLAL( &status );
-		exit(1);
+	double tWave = pTc + tDelay - (double)kPeak*deltaTin - ifo[ifonr]->FTstart;  // Start of the waveform, w.r.t. the start of FTin
+	int i1 = max(0, (int)ceil(tWave*samplerate));
+	int i2 = min(length-1, (int)floor((tWave + (double)(wfmLength-1)*deltaTin)*samplerate));
+	
+	setTemplateSupport(ifo[ifonr], i1, i2);
+	for(i=i1; i<=i2; i++) {
+		x = ((double)i*inversesamplerate - tWave) / deltaTin;
+		lo = (int)x;
+		r = x - (double)lo;
+		if(x<0.0 || lo>=wfmLength-1) {
+			ifo[ifonr]->FTin[i] = 0.0;
+		} else {
+			ifo[ifonr]->FTin[i] = (1.0-r) * (fplus*hpc[2*lo]   + fcross*hpc[2*lo+1]) + 
+			                           r  * (fplus*hpc[2*lo+2] + fcross*hpc[2*lo+3]);
+		}
 	}
 	
-	REAL8 offset;
-	XLALFindNRCoalescenceTime( &offset, waveform.h);
-	XLALGPSAdd( &(ret->epoch), -offset);
-	
-	REAL4TimeSeries signalvec;        // GW signal 
-	
-	memset( &signalvec, 0, sizeof(REAL4TimeSeries) );
-	
-	/* set the parameters for the signal time series */
-	signalvec.deltaT = ret->deltaT;
-	
-	signalvec.sampleUnits = lalADCCountUnit;
-	//signal.f0 = 0.0;
-	signalvec.data = NULL;
-	/* simulate the detectors response to the inspiral */
-	LALSCreateVector( &status, &(signalvec.data), (UINT4)length );
-	XLALGPSSetREAL8( &(signalvec.epoch), ifo[ifonr]->FTstart);	
-	for ( i = 0; i < (int)signalvec.data->length; i++ ) {signalvec.data->data[i]=0.0;}
-	LALSSInjectTimeSeries( &status, &signalvec, ret );
-	
-	for ( i = 0; i < (int)signalvec.data->length && i < length; i++ ) {ifo[ifonr]->FTin[i] = signalvec.data->data[i];
-																//printf("signal.data->data[%d] = %10.10e\n",i,signal.data->data[i]);
-																}
-	
-	free(wave);
-	free(waveformApproximant);
 	LALfreedomPhenSpinTaylorRD(&waveform);
-	XLALDestroyREAL4Vector ( htData->data);
-	LALFree(htData);
-	XLALDestroyREAL4Vector ( ret->data);
-	LALFree(ret);
-	LALSDestroyVector( &status, &( signalvec.data ) );
-//	if ( detector.site ) LALFree( detector.site );
-//	LALFree( detector.transfer );
-
 	
 } // End of templateLALPhenSpinTaylorRD()
 // ****************************************************************************************************************************************************  
@@ -1414,38 +1081,94 @@ void templateLALPhenSpinTaylorRD(struct parSet *par, struct interferometer *ifo[
  * Uses GeneratePPN approximant.
  */
 // ****************************************************************************************************************************************************  
-void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
-  int i=0;
+  int lengthLAL=0;
+  int length = ifo[ifonr]->samplesize;
+  
+  
+  // LAL structs needed. Have to be freed later
+  LALStatus           status;
+  CoherentGW          waveform;  // i.e. output
+  SimInspiralTable    injParams;  // Physical input parameters
+  PPNParamStruc       ppnParams;  // 'non-physical' input parameters, e.g. f cuts, Delta-t, etc.
+  
+  memset( &status, 0, sizeof(LALStatus) );
+  memset( &waveform, 0, sizeof(CoherentGW) );
+  memset( &injParams, 0, sizeof(SimInspiralTable) );
+  memset( &ppnParams, 0, sizeof(PPNParamStruc) );
+  
+  size_t scratchMark = ifo[ifonr]->scratchUsed;  // wave is taken from the scratch arena of the IFO
+  double *wave = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*(length+2));
+  memset(wave, 0, sizeof(double)*(length+2));
+  
+  
+  // Compute h_+ and h_x:
+  LALHpHcNonSpinning(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[ifonr], injectionWF, likePar);
+  if(status.statusCode) {
+    setTemplateSupport(ifo[ifonr], 0, -1);  // Empty template
+    
+    //LALfreedomNoSpin(&waveform);  //Why does this give a seg.fault here, but not at the end of the routine?
+    ifo[ifonr]->scratchUsed = scratchMark;
+    return;
+  }
+  
+  
+  // Compute the detector response  -  Is this done by LALGenerateInspiral for the non-spinning case?
+  double delay = LALFpFc(&status, &waveform, &injParams, &ppnParams, wave, length, par, ifo[ifonr], ifonr); //Vivien: lentghLAL is set in LALinteface.c But is is also availble in the structure thewaveform (which holds h+,x) and the structure wave (which holds F+,x)
+  delay = delay; //MvdS: remove 'declared but never referenced' warnings
+  
+  
   
+  copyTemplate(ifo[ifonr], wave);  // Copy the template into FTin and record its support for taperTemplate()
+  
+  LALfreedomNoSpin(&waveform);
+  ifo[ifonr]->scratchUsed = scratchMark;
+  
+} // End of templateLALnonSpinning()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute h_+ and h_x for a LAL non-spinning inspiral waveform
+ * 
+ * Uses GeneratePPN approximant.  Like LALHpHc15(), only the cut-off frequencies and sampling rate are taken from ifo,
+ * and on failure for an MCMC template status->statusCode is left non-zero and *l is set to 0.
+ */
+// ****************************************************************************************************************************************************  
+void LALHpHcNonSpinning(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injParams, PPNParamStruc *ppnParams, int *l, struct parSet *par, struct interferometer *ifo, int injectionWF, const struct likelihoodPar *likePar)
+{
   // Get the 9 waveform parameters from their array:
   double pMc=0.0,pEta=0.0,pTc=0.0,pDl=0.0,pRA=0.0,pLongi=0.0,pSinDec=0.0,pPhase=0.0,pCosI=0.0,pPsi=0.0,PNorder=0.0;
   if(injectionWF==1) {                                               // Then this is an injection waveform template
-    pTc       = par->par[run.injRevID[11]];                                            // 11: t_c
-    pDl       = pow(par->par[run.injRevID[21]],c3rd);                                            // 21: d_L^3
-    pMc       = pow(par->par[run.injRevID[65]],6);                                            // 65: Mc^(1/6)
-    pEta      = par->par[run.injRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->injRevID[11]];                                            // 11: t_c
+    pDl       = pow(par->par[likePar->injRevID[21]],c3rd);                                            // 21: d_L^3
+    pMc       = pow(par->par[likePar->injRevID[65]],6);                                            // 65: Mc^(1/6)
+    pEta      = par->par[likePar->injRevID[62]];                                            // 62: eta
     
-    pRA       = par->par[run.injRevID[31]];                                            // 31: 'longi' := RA (?)
-    pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.injRevID[51]];                                            // 51: cos(inclination)
-    pPsi      = par->par[run.injRevID[52]];                                            // 52: psi: polarisation angle
+    pRA       = par->par[likePar->injRevID[31]];                                            // 31: 'longi' := RA (?)
+    pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->injRevID[51]];                                            // 51: cos(inclination)
+    pPsi      = par->par[likePar->injRevID[52]];                                            // 52: psi: polarisation angle
     
-    PNorder   = run.injectionPNorder;                                                  // Post-Newtonian order
+    PNorder   = likePar->injectionPNorder;                                                  // Post-Newtonian order
   } else {                                                           // Then this is an MCMC waveform template
-    pTc       = par->par[run.parRevID[11]];                                            // 11: t_c
-    pDl       = pow(par->par[run.parRevID[21]],c3rd);                                            // 21: d_L^3
-    pMc       = pow(par->par[run.parRevID[65]],6);                                            // 65: Mc^(1/6)
-    pEta      = par->par[run.parRevID[62]];                                            // 62: eta
+    pTc       = par->par[likePar->parRevID[11]];                                            // 11: t_c
+    pDl       = pow(par->par[likePar->parRevID[21]],c3rd);                                            // 21: d_L^3
+    pMc       = pow(par->par[likePar->parRevID[65]],6);                                            // 65: Mc^(1/6)
+    pEta      = par->par[likePar->parRevID[62]];                                            // 62: eta
     
-    pRA       = par->par[run.parRevID[31]];                                            // 31: longi := RA (?)
-    pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)
-    pPhase    = par->par[run.parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
-    pCosI     = par->par[run.parRevID[51]];                                            // 51: cos(inclination) of the binary
-    pPsi      = par->par[run.parRevID[52]];                                            // 52: psi: polarisation angle of the binary
+    pRA       = par->par[likePar->parRevID[31]];                                            // 31: longi := RA (?)
+    pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->parRevID[51]];                                            // 51: cos(inclination) of the binary
+    pPsi      = par->par[likePar->parRevID[52]];                                            // 52: psi: polarisation angle of the binary
     
-    PNorder   = run.mcmcPNorder;                                                       // Post-Newtonian order
+    PNorder   = likePar->mcmcPNorder;                                                       // Post-Newtonian order
   }
   
   pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);    // RA -> 'lon'
@@ -1462,101 +1185,71 @@ void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], in
   
   //printf(" LAL nS WF pars:  injWF: %i, Mc: %f, eta: %f, M1: %f, M2: %f, Mtot: %f\n",injectionWF,pMc, pEta, m1, m2, m1+m2);
   
-  int length = ifo[ifonr]->samplesize;
-  
-  
-  // LAL structs needed. Have to be freed later
-  static LALStatus    status;
-  CoherentGW          waveform;  // i.e. output
-  SimInspiralTable    injParams;  // Physical input parameters
-  PPNParamStruc       ppnParams;  // 'non-physical' input parameters, e.g. f cuts, Delta-t, etc.
-  
-  memset( &status, 0, sizeof(LALStatus) );
-  memset( &waveform, 0, sizeof(CoherentGW) );
-  memset( &injParams, 0, sizeof(SimInspiralTable) );
-  memset( &ppnParams, 0, sizeof(PPNParamStruc) );
-  
-  double f_lower=ifo[ifonr]->lowCut;
-  double samplerate = (double)ifo[ifonr]->samplerate;
+  double f_lower=ifo->lowCut;
+  double samplerate = (double)ifo->samplerate;
   double inversesamplerate = 1.0/samplerate;
-  double *wave = (double*)calloc(length+2,sizeof(double));
-  
-  
   
   
-  // Store waveform family and pN order in injParams.waveform
+  // Store waveform family and pN order in injParams->waveform
   // Remember we're in the non-spinning LAL routine here
-  char* waveformApproximant = (char*)calloc(128,sizeof(char));
+  char waveformApproximant[128];
   getWaveformApproximant("GeneratePPN",128,PNorder,waveformApproximant);  //Non-spinning
   //getWaveformApproximant("SpinTaylor",128,PNorder,waveformApproximant);  //Spinning
   //printf("\n  %s\n\n",waveformApproximant);
   
-  snprintf(injParams.waveform,LIGOMETA_WAVEFORM_MAX*sizeof(CHAR),"%s",waveformApproximant);
+  snprintf(injParams->waveform,LIGOMETA_WAVEFORM_MAX*sizeof(CHAR),"%s",waveformApproximant);
   Approximant injapprox;
-  LALGetApproximantFromString(&status,injParams.waveform,&injapprox);
-  if(injapprox!=GeneratePPN) fprintf(stderr,"\n *** Warning:  not using GeneratePPN approximant causes incoherent injections. Used: %s\t%s***\n",waveformApproximant,injParams.waveform);
+  LALGetApproximantFromString(status,injParams->waveform,&injapprox);
+  if(injapprox!=GeneratePPN) fprintf(stderr,"\n *** Warning:  not using GeneratePPN approximant causes incoherent injections. Used: %s\t%s***\n",waveformApproximant,injParams->waveform);
   
   // Fill injParam with the waveform parameters:
-  injParams.mass1 = (float)m1;
-  injParams.mass2 = (float)m2;
-  injParams.mchirp = (float)pMc;  // Get a seg.fault when setting both pairs?!?!?
-  injParams.eta = (float)pEta;
+  injParams->mass1 = (float)m1;
+  injParams->mass2 = (float)m2;
+  injParams->mchirp = (float)pMc;  // Get a seg.fault when setting both pairs?!?!?
+  injParams->eta = (float)pEta;
   
-  injParams.distance = (float)pDl;                                  // Distance in Mpc
-  injParams.inclination = (float)acos(pCosI);                               // Inclination of the binary
+  injParams->distance = (float)pDl;                                  // Distance in Mpc
+  injParams->inclination = (float)acos(pCosI);                               // Inclination of the binary
   
   
   // 4 parameters used after the computation of h+,x ********************//
-  injParams.coa_phase = (float)pPhase;                                      // GW phase at coalescence
-  injParams.longitude = (float)pLongi;                                      // 'Longitude'  CHECK: is this actually RA?!?!?
-  injParams.latitude = (float)asin(pSinDec);                                // Declination
-  injParams.polarization = (float)pPsi;                                     // Polarisation angle
+  injParams->coa_phase = (float)pPhase;                                      // GW phase at coalescence
+  injParams->longitude = (float)pLongi;                                      // 'Longitude'  CHECK: is this actually RA?!?!?
+  injParams->latitude = (float)asin(pSinDec);                                // Declination
+  injParams->polarization = (float)pPsi;                                     // Polarisation angle
   
-  injParams.f_final = (float)ifo[ifonr]->highCut;  // It seems injParams.f_final gets overwritten by LALGenerateInspiral; it's an output parameter rather than input. This will also somewhat affect SNR comparisons with the Apostolatos waveform.
-  injParams.f_lower = (float)f_lower;
+  injParams->f_final = (float)ifo->highCut;  // It seems injParams->f_final gets overwritten by LALGenerateInspiral; it's an output parameter rather than input. This will also somewhat affect SNR comparisons with the Apostolatos waveform.
+  injParams->f_lower = (float)f_lower;
   
-  ppnParams.fStartIn = (float)f_lower;  //May be needed here as well...(?)
-  ppnParams.deltaT   = inversesamplerate;
-  ppnParams.lengthIn = 0;
-  ppnParams.ppn      = NULL;
+  ppnParams->fStartIn = (float)f_lower;  //May be needed here as well...(?)
+  ppnParams->deltaT   = inversesamplerate;
+  ppnParams->lengthIn = 0;
+  ppnParams->ppn      = NULL;
   
   
   
   
   REAL8 geocent_end_time = pTc;
-  XLALGPSSetREAL8( &injParams.geocent_end_time, geocent_end_time );
+  XLALGPSSetREAL8( &injParams->geocent_end_time, geocent_end_time );
   
   
   // Call the injection function; compute h_+ and h_x:
-  LALGenerateInspiral(&status, &waveform, &injParams, &ppnParams );
-  if(status.statusCode) {
+  LALGenerateInspiral(status, waveform, injParams, ppnParams );
+  if(status->statusCode) {
     if(injectionWF==1) {
       fprintf(stderr, "\n\n   templateLALnonSpinning():  ERROR generating injection waveform %s (too high mass?)\n   Aborting...\n\n", waveformApproximant);
-      REPORTSTATUS(&status);
+      REPORTSTATUS(status);
       exit(1);
     }
-    for(i=0; i<length; ++i) ifo[ifonr]->FTin[i] = 0.0;
-    
-    //LALfreedomNoSpin(&waveform);  //Why does this give a seg.fault here, but not at the end of the routine?
-    free(wave);
-    free(waveformApproximant);
+    *l = 0;
     return;
   }
   
+  *l = waveform->phi->data->length;
   
-  // Compute the detector response  -  Is this done by LALGenerateInspiral for the non-spinning case?
-  double delay = LALFpFc(&status, &waveform, &injParams, &ppnParams, wave, length, par, ifo[ifonr], ifonr); //Vivien: lentghLAL is set in LALinteface.c But is is also availble in the structure thewaveform (which holds h+,x) and the structure wave (which holds F+,x)
-  delay = delay; //MvdS: remove 'declared but never referenced' warnings
-  
-  
-  
-  for(i=0; i<length; ++i) ifo[ifonr]->FTin[i] = wave[i];
-  
-  LALfreedomNoSpin(&waveform);
-  free(wave);
-  free(waveformApproximant);
+  // At this point the structure waveform is still allocated in memory and will have to be freed. See LALfreedomNoSpin()
   
-} // End of templateLALnonSpinning()
+} // End of LALHpHcNonSpinning()
 // ****************************************************************************************************************************************************  
 
 
@@ -1575,6 +1268,79 @@ void templateLALnonSpinning(struct parSet *par, struct interferometer *ifo[], in
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute a LAL waveform template for all detectors in the network, computing h_+,h_x only once
+ * 
+ * LALGenerateInspiral() integrates the orbit and computes the polarisations, which is by far the most expensive part of the template.
+ * Call it once for the network and apply F_+,F_x and the arrival-time delay of each detector with LALFpFc(), which fills ifo[i]->FTin.
+ * The IFOs must share their cut-off frequencies, sampling rate and sample size; see networkTemplateAllowed().
+ * waveformVersion 3: 15-parameter spinning LAL template;  4: non-spinning LAL template.
+ */
+// ****************************************************************************************************************************************************  
+void templateLALnetwork(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
+{
+  int ifonr=0, lengthLAL=0;
+  int length = ifo[0]->samplesize;
+  
+  // LAL structs needed. Have to be freed later
+  LALStatus           status;
+  CoherentGW          waveform;
+  SimInspiralTable    injParams;
+  PPNParamStruc       ppnParams;
+  
+  memset( &status, 0, sizeof(LALStatus) );
+  memset( &waveform, 0, sizeof(CoherentGW) );
+  memset( &injParams, 0, sizeof(SimInspiralTable) );
+  memset( &ppnParams, 0, sizeof(PPNParamStruc) );
+  
+  ppnParams.deltaT   = 1.0/(double)ifo[0]->samplerate;
+  ppnParams.lengthIn = 0;
+  ppnParams.ppn      = NULL;
+  
+  
+  // Compute h_+ and h_x once for the whole network:
+  if(waveformVersion==3) {
+    LALHpHc15(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[0], injectionWF, likePar);
+  } else {
+    LALHpHcNonSpinning(&status, &waveform, &injParams, &ppnParams, &lengthLAL, par, ifo[0], injectionWF, likePar);
+  }
+  
+  if(status.statusCode) {
+    for(ifonr=0; ifonr<networkSize; ifonr++) setTemplateSupport(ifo[ifonr], 0, -1);  // Empty templates
+    return;
+  }
+  
+  
+  // Compute the detector response for each IFO:
+  size_t scratchMark = ifo[0]->scratchUsed;  // wave is taken from the scratch arena of ifo[0]
+  double *wave = (double*)scratchAlloc(ifo[0], sizeof(double)*(length+2));
+  memset(wave, 0, sizeof(double)*(length+2));
+  double delay = 0.0;
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    delay = LALFpFc(&status, &waveform, &injParams, &ppnParams, wave, length, par, ifo[ifonr], ifonr);
+    copyTemplate(ifo[ifonr], wave);
+  }
+  delay = delay; // Remove 'declared but never referenced' warnings
+  
+  ifo[0]->scratchUsed = scratchMark;
+  if(waveformVersion==3) {
+    LALfreedomSpin(&waveform);
+  } else {
+    LALfreedomNoSpin(&waveform);
+  }
+  
+} // End of templateLALnetwork()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+
+
+
 // ****************************************************************************************************************************************************  
 /**
  * \brief Compute detector response for a given detector and given h_+,h_x
@@ -1591,23 +1357,11 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   // memset( &stat, 0, sizeof(LALStatus) );
   
   int i;
+  ifonr = ifonr;  // The detector is found by name in setLALresponse(), not by its number in the network
   
-  DetectorResponse detector;   // the detector in question 
-  //memset( &detector, 0, sizeof( DetectorResponse ) );
-  
-  
-  //LALDetector site;
-  detector.site = (LALDetector *) LALMalloc( sizeof(LALDetector) );
-  
-  if(ifonr==0) *(detector.site) = lalCachedDetectors[LALDetectorIndexLHODIFF]; 
-  if(ifonr==1) *(detector.site) = lalCachedDetectors[LALDetectorIndexLLODIFF];
-  if(ifonr==2) *(detector.site) = lalCachedDetectors[LALDetectorIndexVIRGODIFF];
-  
-  //site = lalCachedDetectors[LALDetectorIndexLLODIFF];
-  
-  //detector.site = &site;
-  detector.transfer = NULL;
-  detector.ephemerides = NULL;
+  // The detector, its response and the signal vector are set up once per IFO.  Redo this if the length or start time of the 
+  //   data have changed (i.e., for the injection in dataFT()):
+  if(ifo->lalSignal.data==NULL || (int)ifo->lalSignal.data->length != length || ifo->lalFTstart != ifo->FTstart) setLALresponse(ifo, length);
   
   /* set up units for the transfer function */
   /*    RAT4 negOne = { -1, 0 };
@@ -1643,9 +1397,7 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   
   
-  REAL4TimeSeries signalvec;        // GW signal 
-  
-  memset( &signalvec, 0, sizeof(REAL4TimeSeries) );
+  REAL4TimeSeries *signalvec = &(ifo->lalSignal);        // GW signal 
   
   //REAL4TimeSeries chan;        // channel
   
@@ -1681,15 +1433,8 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   
   
-  /* set the parameters for the signal time series */
-  signalvec.deltaT = waveform->phi->deltaT;
-  
-  signalvec.sampleUnits = lalADCCountUnit;
-  //signalvec.f0 = 0.0;
-  signalvec.data = NULL;
-  /* simulate the detectors response to the inspiral */
-  LALSCreateVector( status, &(signalvec.data), (UINT4)length );
-  XLALGPSSetREAL8( &(signalvec.epoch), ifo->FTstart);
+  /* set the parameters for the signal time series;  its units, epoch and vector were set in setLALresponse() */
+  signalvec->deltaT = waveform->phi->deltaT;
   
   
   /* set the parameters for the signal time series */
@@ -1704,7 +1449,7 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   waveform->position.system=COORDINATESYSTEM_GEOGRAPHIC;
   
-  LALSimulateCoherentGW( status, &signalvec, waveform, &detector );//////////////////this is were F+,x are being computed.
+  LALSimulateCoherentGW( status, signalvec, waveform, &(ifo->lalResponse) );//////////////////this is were F+,x are being computed.
   
   //LALFloatToGPS( status, &(chan.epoch), &(ifo->FTstart));
   
@@ -1720,11 +1465,11 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   //      LALSSInjectTimeSeries(status, &chan, &signalvec );
   
-  for ( i = 0; i < (int)signalvec.data->length && i < length; i++ ){
+  for ( i = 0; i < (int)signalvec->data->length && i < length; i++ ){
     
     //printf("%d\t%10.10e\n", i, chan.data->data[i]);
     
-    wave[i] = signalvec.data->data[i]; // wave is my array of doubles to send back the waveform to the rest of SPINspiral.
+    wave[i] = signalvec->data->data[i]; // wave is my array of doubles to send back the waveform to the rest of SPINspiral.
 	  //printf("%d\t%10.10e\n", i, signalvec.data->data[i]);
   }
   //printf("1000\t%10.10e\n",wave[1000]);
@@ -1743,15 +1488,11 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
   
   // LALTimeDelayFromEarthCenter(status, &delay, &det1_and_source);
   
-  LALSDestroyVector( status, &( signalvec.data ) );
   // LALSDestroyVector( status, &( chan.data ) );
   
   // if(waveform->position.system==COORDINATESYSTEM_EQUATORIAL) printf("youpi\n");
   // printf("position=%f,%f\n",waveform->position.longitude,waveform->position.latitude);
   
-  if ( detector.site ) LALFree( detector.site );
-  LALFree( detector.transfer );
-  
   return delay;
   
 } // End of LALFpFc()
@@ -1762,6 +1503,55 @@ double LALFpFc(LALStatus *status, CoherentGW *waveform, SimInspiralTable *injPar
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Set up the LAL detector response of ifo, used by LALFpFc() for every template
+ * 
+ * The detector is found by the name of the IFO (or else by the prefix of its channel name, e.g. H1:), so that it does not depend
+ * on the position of the IFO in the network.  The signal vector is (re)allocated for length samples, and starts at ifo->FTstart.
+ */
+// ****************************************************************************************************************************************************  
+void setLALresponse(struct interferometer *ifo, int length)
+{
+  int i=0, j=0, site=-1;
+  
+  // Names and channel prefixes of the detectors in lalCachedDetectors[]:
+  const int nSites = 4;
+  const int siteIndex[4] = { LALDetectorIndexLHODIFF, LALDetectorIndexLLODIFF, LALDetectorIndexVIRGODIFF, LALDetectorIndexGEO600DIFF };
+  const char *siteNames[4][3] = { {"Hanford","LHO","H"}, {"Livingston","LLO","L"}, {"Pisa","Virgo","V"}, {"GEO","GEO600","G"} };
+  
+  for(i=0; i<nSites && site<0; i++) {
+    for(j=0; j<2; j++) if(strcmp(ifo->name, siteNames[i][j])==0) site = i;
+  }
+  for(i=0; i<nSites && site<0; i++) {
+    if(ifo->ch1name[0]==siteNames[i][2][0] && ifo->ch1name[1]!='\0' && ifo->ch1name[2]==':') site = i;    // e.g. H1:, H2:
+  }
+  if(site<0) {
+    fprintf(stderr,"\n\n   ERROR:  setLALresponse(): cannot find the LAL detector for the IFO %s (channel %s)\n   Aborting...\n\n",ifo->name,ifo->ch1name);
+    exit(1);
+  }
+  
+  ifo->lalSite = lalCachedDetectors[siteIndex[site]];
+  memset( &(ifo->lalResponse), 0, sizeof(DetectorResponse) );
+  ifo->lalResponse.site = &(ifo->lalSite);
+  ifo->lalResponse.transfer = NULL;
+  ifo->lalResponse.ephemerides = NULL;
+  
+  if(ifo->lalSignal.data != NULL) XLALDestroyREAL4Vector( ifo->lalSignal.data );
+  memset( &(ifo->lalSignal), 0, sizeof(REAL4TimeSeries) );
+  ifo->lalSignal.sampleUnits = lalADCCountUnit;
+  ifo->lalSignal.data = XLALCreateREAL4Vector( (UINT4)length );
+  XLALGPSSetREAL8( &(ifo->lalSignal.epoch), ifo->FTstart );
+  ifo->lalFTstart = ifo->FTstart;
+  
+} // End of setLALresponse()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
 
 
 
@@ -1834,7 +1624,7 @@ void getWaveformApproximant(const char* familyName, int length, double PNorder,
 // ****************************************************************************************************************************************************  
 void LALfreedomSpin(CoherentGW *waveform) {
   // Free LAL stuff  
-  static LALStatus stat;     // status structure
+  LALStatus stat;            // status structure
   
   memset( &stat, 0, sizeof(LALStatus) );
   
@@ -1858,7 +1648,7 @@ void LALfreedomSpin(CoherentGW *waveform) {
 // ****************************************************************************************************************************************************  
 void LALfreedomPhenSpinTaylorRD(CoherentGW *waveform) {
 	// Free LAL stuff  
-	static LALStatus stat;     // status structure
+	LALStatus stat;            // status structure
 	
 	memset( &stat, 0, sizeof(LALStatus) );
 	
@@ -1884,7 +1674,7 @@ void LALfreedomPhenSpinTaylorRD(CoherentGW *waveform) {
 // ****************************************************************************************************************************************************  
 void LALfreedomNoSpin(CoherentGW *waveform) {
   // Free LAL stuff  
-  static LALStatus stat;     // status structure
+  LALStatus stat;            // status structure
   
   memset( &stat, 0, sizeof(LALStatus) );
   
@@ -31,8 +31,6 @@
 
 #include <SPINspiral.h>
 
-double Ms,Mpc,G,c,Mpcs,pi,tpi,mtpi;
-
 /**
  * \mainpage SPINspiral documentation
  * SPINspiral is a parameter-estimation code designed to extract the physical parameters of compact-binary coalescences (CBCs) from observed gravitational-wave signals.
@@ -75,7 +73,6 @@ int main(int argc, char* argv[])
   run.injXMLfilename = NULL;
   run.injXMLnr = -1;
   for(i=0;i<99;i++) run.commandSettingsFlag[i] = 0;
-  setConstants();                          //Set the global constants (which are variable in C)
   setParameterNames(&run);                 //Set the names of the parameters in the hardcoded parameter database
   
   sprintf(run.mainFilename,"SPINspiral.input");  //Default input filename
@@ -100,6 +97,8 @@ int main(int argc, char* argv[])
   struct interferometer database[run.maxIFOdbaseSize];
   setIFOdata(&run, database);
   
+  setLikelihoodPar(&run);                  //Copy the run parameters needed for templates and likelihoods to run.likePar
+  
   
   
   //Define interferometer network with IFOs.  The first run.networkSize are actually used
@@ -129,7 +128,7 @@ int main(int argc, char* argv[])
     getInjectionParameters(&injParSet, run.nInjectPar, run.injParVal);
     allocParset(&injParSet, networkSize);
     injectionWF = 1;
-    localPar(&injParSet, network, networkSize, injectionWF, run);
+    localPar(&injParSet, network, networkSize, injectionWF, &run.likePar);
     
     
     // Calculate SNR:
@@ -137,7 +136,7 @@ int main(int argc, char* argv[])
     if(run.doSNR==1) {
       for(ifonr=0; ifonr<networkSize; ++ifonr) {
         injectionWF = 1;                           //Call signalToNoiseRatio with the injection waveform
-        snr = signalToNoiseRatio(&injParSet, network, ifonr, run.injectionWaveform, injectionWF, run);
+        snr = signalToNoiseRatio(&injParSet, network, ifonr, run.injectionWaveform, injectionWF, &run.likePar);
         network[ifonr]->snr = snr;
         run.netsnr += snr*snr;
       }
@@ -153,14 +152,14 @@ int main(int argc, char* argv[])
       getInjectionParameters(&injParSet, run.nMCMCpar, run.injParVal);
       allocParset(&injParSet, networkSize);
       injectionWF = 1;
-      localPar(&injParSet, network, networkSize, injectionWF, run);
+      localPar(&injParSet, network, networkSize, injectionWF, &run.likePar);
       
       // Recalculate SNR:
       run.netsnr = 0.0;
       if(run.doSNR==1) {
         for(ifonr=0; ifonr<networkSize; ++ifonr) {
           injectionWF = 1;                           //Call signalToNoiseRatio with the injection waveform
-          snr = signalToNoiseRatio(&injParSet, network, ifonr, run.injectionWaveform, injectionWF, run);
+          snr = signalToNoiseRatio(&injParSet, network, ifonr, run.injectionWaveform, injectionWF, &run.likePar);
           network[ifonr]->snr = snr;
           run.netsnr += snr*snr;
         }
@@ -251,6 +250,38 @@ int main(int argc, char* argv[])
   }
   
   
+  //Build a reduced-order-quadrature basis for this band and these priors, and quit
+  if(run.likelihoodROQ==2) {
+    buildROQbasis(network, networkSize, run);
+    run.doMCMC = 0;
+    run.doMatch = 0;
+  }
+  
+  
+  //Compare the single- and double-precision likelihoods, and quit
+  if(run.singlePrecision==2) {
+    compareSinglePrecision(network, networkSize, run);
+    run.doMCMC = 0;
+    run.doMatch = 0;
+  }
+  
+  
+#ifdef SPINSPIRAL_CHECKS
+  //Time the likelihood kernels
+  benchmarkOverlaps(network, networkSize);
+  benchmarkTemplateFFT(network, networkSize);
+  
+  //Check the likelihoods from a cached intrinsic template against full computations
+  if(run.doMCMC==1) compareExtrinsicLikelihood(network, networkSize, run);
+  
+  //Check the blocked Apostolatos template against the scalar reference version
+  if(run.doMCMC==1) compareApostolatosTemplates(network, networkSize, run);
+  
+  //Check that the likelihood gives the same results on several threads as serially
+  if(run.doMCMC==1) compareThreadedLikelihood(network, networkSize, run);
+#endif
+  
+  
   //Do MCMC
   clock_t time1 = clock();
   if(run.doMCMC==1) {
@@ -277,7 +308,7 @@ int main(int argc, char* argv[])
       for(fac=-0.002;fac<0.002;fac+=0.00005) {
       injParSet.tc = matchpar+fac;
       for(ifonr=0;ifonr<networkSize;ifonr++) {
-      localPar(&injParSet, network, networkSize, injectionWF, run);
+      localPar(&injParSet, network, networkSize, injectionWF, &run.likePar);
       matchres = match(&injParSet,network,ifonr,networkSize);
       printf("%10.6f  %10.6f\n",fac,matchres);
       fprintf(fout,"%10.6f  %10.6f\n",fac,matchres);
@@ -306,15 +337,15 @@ int main(int argc, char* argv[])
       //getInjectionParameters(&startPar, run.nInjectPar, run.injParVal);  // startPar contains injection parameters
       getStartParameters(&startPar, run);                                // startPar contains MCMC starting parameters
       
-      localPar(&injctPar, network, networkSize, injectionWF, run);
-      localPar(&startPar, network, networkSize, mcmcWF, run);
+      localPar(&injctPar, network, networkSize, injectionWF, &run.likePar);
+      localPar(&startPar, network, networkSize, mcmcWF, &run.likePar);
       
       //run.injectionWaveform = 1;
       double matchres=0.0, overlap=0.0;
       printf("\n\n  Match:\n");
-      matchres = parMatch(&injctPar, run.injectionWaveform, injectionWF, &startPar, run.mcmcWaveform, mcmcWF, network, networkSize, run);
+      matchres = parMatch(&injctPar, run.injectionWaveform, injectionWF, &startPar, run.mcmcWaveform, mcmcWF, network, networkSize, &run.likePar);
       printf("\n\n  Overlap:\n");
-      overlap = parOverlap(&injctPar, run.injectionWaveform, injectionWF, &startPar, run.mcmcWaveform, mcmcWF, network, 0, run); //For IFO 0
+      overlap = parOverlap(&injctPar, run.injectionWaveform, injectionWF, &startPar, run.mcmcWaveform, mcmcWF, network, 0, &run.likePar); //For IFO 0
       
       printf("\n\n   Match: %10.5lf,  overlap IFO 0: %g \n",matchres,overlap);
       printf("\n");
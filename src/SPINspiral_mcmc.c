@@ -74,18 +74,19 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   char outfileName[99];
   char outfilePath[512];
+  int tempi=0;
   mcmc.fouts = (FILE**)calloc(mcmc.nTemps,sizeof(FILE*));
-  for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {
-    if(mcmc.iTemp==0 || mcmc.saveHotChains>0) {
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) {
+    if(tempi==0 || mcmc.saveHotChains>0) {
       if(run.outputPath) {
         strcpy(outfilePath,run.outputPath);
       } else {
         sprintf(outfilePath,"./");                       // In current dir, allows for multiple copies to run
       }
-      sprintf(outfileName,"SPINspiral.output.%6.6d.%2.2d",mcmc.seed,mcmc.iTemp);
+      sprintf(outfileName,"SPINspiral.output.%6.6d.%2.2d",mcmc.seed,tempi);
       strcat(outfilePath,outfileName);
-      mcmc.fouts[mcmc.iTemp] = fopen(outfilePath,"w");
-      if(mcmc.fouts[mcmc.iTemp] == NULL) {
+      mcmc.fouts[tempi] = fopen(outfilePath,"w");
+      if(mcmc.fouts[tempi] == NULL) {
         fprintf(stderr, "\n\n   ERROR:  could not open/create output file %s. Check that output directory %s exists.\n   Aborting...",outfilePath,run.outputPath); 
         exit(1);
       }
@@ -103,18 +104,39 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   int i=0,j=0,j_1=0,j_2=0,injectionWF=0;
   
-  //Allocate memory for (most of) the MCMCvariables struct
+  //Allocate memory for (most of) the MCMCvariables struct, and for the state of the chains
   allocateMCMCvariables(&mcmc);
+  struct MCMCchain *chain = &mcmc.chain[0];   // The T=1 chain
+  chain->ran = mcmc.ran;                      // The T=1 chain uses mcmc.ran, so that a run without parallel tempering is unchanged
+  
+  // If the amplitude of the waveform scales as 1/d_L, <d|h> and <h|h> can be rescaled for distance-only proposals:
+  mcmc.distParIndex = -1;
+  mcmc.distParID = 0;
+  if(mcmc.likelihoodCache>=1 && waveformCapability(mcmc.mcmcWaveform, wfDistanceScaling)) {
+    if(mcmc.mcmcParUse[22]==1) {
+      mcmc.distParID = 22;                        // 22: log(d_L)
+    } else if(mcmc.mcmcParUse[21]==1) {
+      mcmc.distParID = 21;                        // 21: d_L^3
+    }
+    if(mcmc.distParID>0) mcmc.distParIndex = mcmc.parRevID[mcmc.distParID];
+  }
   
-  double **tempcovar;
-  tempcovar = (double**)calloc(mcmc.nMCMCpar,sizeof(double*)); // A temp Cholesky-decomposed matrix
-  for(i=0;i<mcmc.nMCMCpar;i++) tempcovar[i] = (double*)calloc(mcmc.nMCMCpar,sizeof(double));
-  
-  double ***covar1;
-  covar1  = (double***)calloc(mcmc.nTemps,sizeof(double**)); // The actual covariance matrix
-  for(i=0;i<mcmc.nTemps;i++) {
-    covar1[i]  = (double**)calloc(mcmc.nMCMCpar,sizeof(double*));
-    for(j=0;j<mcmc.nMCMCpar;j++) covar1[i][j]  = (double*)calloc(mcmc.nMCMCpar,sizeof(double));
+  // If the template factorises as u(f) E exp(-2 pi i f t_c), proposals of extrinsic parameters only can reuse a cached intrinsic template u.
+  //   Not with the relative-binning or ROQ likelihoods, whose approximations the cached template does not share:
+  mcmc.extrinsicCache = (mcmc.likelihoodCache>=1 && waveformCapability(mcmc.mcmcWaveform, wfExtrinsic) && mcmc.relativeBinning==0);
+  for(i=0;i<mcmc.networkSize;i++) if(ifo[i]->roqNlin>0) mcmc.extrinsicCache = 0;
+  for(i=0;i<mcmc.nMCMCpar;i++) mcmc.parExtrinsic[i] = extrinsicParameter(mcmc.parID[i]);
+  if(mcmc.extrinsicCache==1) {
+    mcmc.intrinsicBins = 0;
+    for(i=0;i<mcmc.networkSize;i++) mcmc.intrinsicBins += ifo[i]->indexRange;
+    for(tempi=0;tempi<mcmc.nTemps;tempi++) {            // Two slots per chain:  the current state and a recent proposal
+      mcmc.chain[tempi].intrinsicCacheCur = 0;
+      mcmc.chain[tempi].intrinsicCacheValid[0] = 0;
+      mcmc.chain[tempi].intrinsicCacheValid[1] = 0;
+      mcmc.chain[tempi].intrinsicCachePar = (double*)calloc(2*mcmc.nMCMCpar,sizeof(double));
+      mcmc.chain[tempi].intrinsicCacheDH  = (double*)malloc(sizeof(double) * 2 * 2*mcmc.intrinsicBins);
+      mcmc.chain[tempi].intrinsicCacheHH  = (double*)malloc(sizeof(double) * 2*mcmc.networkSize);
+    }
   }
   
   
@@ -130,7 +152,6 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
     setTemperatureLadderOld(&mcmc);
     //setTemperatureLadder(&mcmc);
   }
-  mcmc.iTemp = 0;  //MUST be zero
   
   
   
@@ -138,8 +159,7 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   // *** WRITE RUN 'HEADER' TO SCREEN AND FILE ************************************************************************************************************************************
   
-  writeMCMCheader(ifo, mcmc, run);
-  mcmc.iTemp = 0;  //MUST be zero
+  writeMCMCheader(ifo, &mcmc, run);
   
   
   
@@ -153,31 +173,31 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
     allocParset(&state, mcmc.networkSize);
     
     // *** Write injection/best-guess values to screen and file ***
-    par2arr(state, mcmc.param, mcmc);  //Put the variables in their array
+    par2arr(&state, chain->param, &mcmc);  //Put the variables in their array
     injectionWF = 1;                                                 // Call localPar, netLogLikelihood with an injection waveform
-    localPar(&state, ifo, mcmc.networkSize, injectionWF, run);
-    mcmc.logL[mcmc.iTemp] = netLogLikelihood(&state, mcmc.networkSize, ifo, mcmc.injectionWaveform, injectionWF, run);  //Calculate the likelihood using the injection waveform
+    localPar(&state, ifo, mcmc.networkSize, injectionWF, &run.likePar);
+    chain->logL = netLogLikelihood(&state, mcmc.networkSize, ifo, mcmc.injectionWaveform, injectionWF, &run.likePar);  //Calculate the likelihood using the injection waveform
     freeParset(&state);
     
     // Store Injection parameters in temp array nParam[][]:
-    for(i=0;i<mcmc.nInjectPar;i++) mcmc.nParam[mcmc.iTemp][i] = mcmc.param[mcmc.iTemp][i];
+    for(i=0;i<mcmc.nInjectPar;i++) chain->nParam[i] = chain->param[i];
     
     // Copy Injection to MCMC parameters, as far as possible; otherwise use MCMC BestValue
     int iInj=0, nDiffPar=0;
     for(i=0;i<mcmc.nMCMCpar;i++) {
       iInj = mcmc.injRevID[mcmc.parID[i]];  //Get the index of this parameter in the injection set.  -1 if not available.
       if(mcmc.injParUse[mcmc.parID[i]] == 1) { // If an MCMC parameter was used for the injection
-        mcmc.param[mcmc.iTemp][i] = mcmc.nParam[mcmc.iTemp][iInj];  // Set the MCMC parameter to the corresponding injection parameter
+        chain->param[i] = chain->nParam[iInj];  // Set the MCMC parameter to the corresponding injection parameter
 	
       } else { // If an MCMC parameter was not used for the injection, try to translate:
         if(mcmc.parID[i]==21 && mcmc.injID[i]==22) {
-          mcmc.param[mcmc.iTemp][i] = exp(3.0*mcmc.nParam[mcmc.iTemp][i]);  // Injection uses log(d), MCMC uses d^3
-          if(mcmc.beVerbose>=1) printf("   I translated  log(d_L/Mpc) = %lf  to  d_L^3 = %lf Mpc^3\n",mcmc.nParam[mcmc.iTemp][i],mcmc.param[mcmc.iTemp][i]);
+          chain->param[i] = exp(3.0*chain->nParam[i]);  // Injection uses log(d), MCMC uses d^3
+          if(mcmc.beVerbose>=1) printf("   I translated  log(d_L/Mpc) = %lf  to  d_L^3 = %lf Mpc^3\n",chain->nParam[i],chain->param[i]);
         } else if(mcmc.parID[i]==22 && mcmc.injID[i]==21) {
-          mcmc.param[mcmc.iTemp][i] = log(mcmc.nParam[mcmc.iTemp][i])/3.0;  // Injection uses d^3, MCMC uses log(d)
-          if(mcmc.beVerbose>=1) printf("   I translated  d_L^3 = %lf  to  log(d_L/Mpc) = %lf Mpc^3\n",mcmc.nParam[mcmc.iTemp][i],mcmc.param[mcmc.iTemp][i]);
+          chain->param[i] = log(chain->nParam[i])/3.0;  // Injection uses d^3, MCMC uses log(d)
+          if(mcmc.beVerbose>=1) printf("   I translated  d_L^3 = %lf  to  log(d_L/Mpc) = %lf Mpc^3\n",chain->nParam[i],chain->param[i]);
         } else {
-          mcmc.param[mcmc.iTemp][i] = mcmc.parBestVal[i];        // Set the MCMC parameter to BestValue - this should only happen if the injection waveform has different parameters than the MCMC waveform
+          chain->param[i] = mcmc.parBestVal[i];        // Set the MCMC parameter to BestValue - this should only happen if the injection waveform has different parameters than the MCMC waveform
           nDiffPar += 1;
         }
 	
@@ -195,28 +215,31 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
     }
     
   } else { // If no software injection was done (injectSignal<=0):
-    for(i=0;i<mcmc.nMCMCpar;i++) mcmc.param[mcmc.iTemp][i] = mcmc.parBestVal[i];  // Set the MCMC parameter to BestValue
+    for(i=0;i<mcmc.nMCMCpar;i++) chain->param[i] = mcmc.parBestVal[i];  // Set the MCMC parameter to BestValue
   }
   
   
   // Print/save injection parameters as MCMC output, line -1:
   mcmc.iIter = -1;
-  for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {
-    mcmc.iTemp = mcmc.iTemp;
-    for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.param[mcmc.iTemp][j_1] = mcmc.param[0][j_1];
-    mcmc.logL[mcmc.iTemp] = mcmc.logL[0];
-    writeMCMCoutput(mcmc, ifo);  //Write output line with injection parameters to screen and/or file (iteration -1)
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) {
+    for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.chain[tempi].param[j_1] = chain->param[j_1];
+    mcmc.chain[tempi].logL = chain->logL;
+    writeMCMCoutput(&mcmc, &mcmc.chain[tempi], ifo);  //Write output line with injection parameters to screen and/or file (iteration -1)
   }
-  mcmc.iTemp = 0;  //MUST be zero
   
   
-  //Determine the number of parameters that is actually fitted/varied (i.e. not kept fixed at the true values)
-  for(i=0;i<mcmc.nMCMCpar;i++) if(mcmc.parFix[i]==0) mcmc.nParFit += 1;
+  // *** Initialise covariance matrix (initially diagonal), to do updates in the first block ***
+  chain->corrUpdate = mcmc.correlatedUpdates;   // = 0 for no corr.upd, 1 to refresh matrix only once, 2 to refresh it every nCorr iterations
+  for(j_1=0;j_1<mcmc.nParFit;j_1++) chain->covar[j_1][j_1] = mcmc.parSigma[mcmc.parFree[j_1]];
   
   
-  // *** Initialise covariance matrix (initially diagonal), to do updates in the first block ***
-  mcmc.corrUpdate[0] = mcmc.correlatedUpdates; // = 0 for no corr.upd, 1 to refresh matrix only once, 2 to refresh it every nCorr iterations
-  for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.covar[mcmc.iTemp][j_1][j_1] = mcmc.parSigma[j_1];
+  
+  
+  // *** Compute the relative-binning summary data around the injection or best-guess values, which are now in chain->param ***
+  if(mcmc.relativeBinning>=1 && ifo[0]->relBinN>0) setRelativeBinningFiducial(ifo, &mcmc, &run.likePar, chain->param);
+  
+  // *** Choose the knot spacing of the multirate template, by comparing it to the full-rate template for these parameters ***
+  if(run.likePar.multirateAccuracy>0.0) setMultirateTemplate(ifo, &mcmc, &run.likePar, chain->param);
   
   
   
@@ -227,18 +250,18 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   getStartParameters(&state, run);
   allocParset(&state, mcmc.networkSize);
   
-  par2arr(state, mcmc.param, mcmc);  //Put the variables in their array
-  startMCMCOffset(&state, &mcmc, ifo, run);  // Start MCMC offset if and where wanted
+  par2arr(&state, chain->param, &mcmc);  //Put the variables in their array
+  startMCMCOffset(&state, &mcmc, chain, ifo, &run.likePar);  // Start MCMC offset if and where wanted
   
   
   // *** Set the NEW array, sigma and scale ***
   for(i=0;i<mcmc.nMCMCpar;i++) {
-    mcmc.nParam[mcmc.iTemp][i] = mcmc.param[mcmc.iTemp][i];
-    mcmc.adaptSigma[mcmc.iTemp][i] = 0.1 * mcmc.parSigma[i];
-    if(mcmc.adaptiveMCMC==1) mcmc.adaptSigma[mcmc.iTemp][i] = mcmc.parSigma[i]; //Don't use adaptation (?)
-    mcmc.adaptScale[mcmc.iTemp][i] = 10.0 * mcmc.parSigma[i];
-    //mcmc.adaptScale[mcmc.iTemp][i] = 0.0 * mcmc.parSigma[i]; //No adaptation
-    sigmaPeriodicBoundaries(mcmc.adaptSigma[mcmc.iTemp][i], i, mcmc);
+    chain->nParam[i] = chain->param[i];
+    chain->adaptSigma[i] = 0.1 * mcmc.parSigma[i];
+    if(mcmc.adaptiveMCMC==1) chain->adaptSigma[i] = mcmc.parSigma[i]; //Don't use adaptation (?)
+    chain->adaptScale[i] = 10.0 * mcmc.parSigma[i];
+    //chain->adaptScale[i] = 0.0 * mcmc.parSigma[i]; //No adaptation
+    sigmaPeriodicBoundaries(chain->adaptSigma[i], i, &mcmc);
   }
   
   
@@ -247,21 +270,19 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   // *** WRITE STARTING STATE TO SCREEN AND FILE **********************************************************************************************************************************
   
-  arr2par(mcmc.param, &state, mcmc);                         //Get the parameters from their array
+  arr2par(chain->param, &state, &mcmc);                       //Get the parameters from their array
   injectionWF = 0;                                                 // Call netLogLikelihood with an MCMC waveform
-  localPar(&state, ifo, mcmc.networkSize, injectionWF, run);
-  mcmc.logL[mcmc.iTemp] = netLogLikelihood(&state, mcmc.networkSize, ifo, mcmc.mcmcWaveform, injectionWF, run);  //Calculate the likelihood
+  localPar(&state, ifo, mcmc.networkSize, injectionWF, &run.likePar);
+  chain->logL = netLogLikelihood(&state, mcmc.networkSize, ifo, mcmc.mcmcWaveform, injectionWF, &run.likePar);  //Calculate the likelihood
   
   // *** Write output line to screen and/or file
   printf("\n");
   mcmc.iIter = 0;
-  for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {
-    mcmc.iTemp = mcmc.iTemp;
-    for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.param[mcmc.iTemp][j_1] = mcmc.param[0][j_1];
-    mcmc.logL[mcmc.iTemp] = mcmc.logL[0];
-    writeMCMCoutput(mcmc, ifo);  //Write output line to screen and/or file
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) {
+    for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.chain[tempi].param[j_1] = chain->param[j_1];
+    mcmc.chain[tempi].logL = chain->logL;
+    writeMCMCoutput(&mcmc, &mcmc.chain[tempi], ifo);  //Write output line to screen and/or file
   }
-  mcmc.iTemp = 0;  //MUST be zero
   
   
   
@@ -271,22 +292,21 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   // *** Put the initial values of the parameters, sigmas etc in the different temperature chains ***
   if(mcmc.nTemps>1) {
-    for(mcmc.iTemp=1;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {
+    for(tempi=1;tempi<mcmc.nTemps;tempi++) {
       for(j=0;j<mcmc.nMCMCpar;j++) {
-        mcmc.param[mcmc.iTemp][j] = mcmc.param[0][j];
-        mcmc.nParam[mcmc.iTemp][j] = mcmc.nParam[0][j];
-        mcmc.adaptSigma[mcmc.iTemp][j] = mcmc.adaptSigma[0][j];
-        mcmc.adaptScale[mcmc.iTemp][j] = mcmc.adaptScale[0][j];
-        mcmc.logL[mcmc.iTemp] = mcmc.logL[0];
-        mcmc.nlogL[mcmc.iTemp] = mcmc.nlogL[0];
-	
-        for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) {
-          for(j_2=0;j_2<=j_1;j_2++) mcmc.covar[mcmc.iTemp][j_1][j_2] = mcmc.covar[0][j_1][j_2];
-        }
+        mcmc.chain[tempi].param[j] = chain->param[j];
+        mcmc.chain[tempi].nParam[j] = chain->nParam[j];
+        mcmc.chain[tempi].adaptSigma[j] = chain->adaptSigma[j];
+        mcmc.chain[tempi].adaptScale[j] = chain->adaptScale[j];
+        mcmc.chain[tempi].logL = chain->logL;
+        mcmc.chain[tempi].nlogL = chain->nlogL;
       }
-      mcmc.corrUpdate[mcmc.iTemp] = mcmc.corrUpdate[0];
-      //mcmc.corrUpdate[mcmc.iTemp] = 0; //Correlated update proposals only for T=1 chain?
-      //mcmc.corrUpdate[mcmc.nTemps-1] = 0; //Correlated update proposals not for hottest chain
+      for(j_1=0;j_1<mcmc.nParFit;j_1++) {
+        for(j_2=0;j_2<=j_1;j_2++) mcmc.chain[tempi].covar[j_1][j_2] = chain->covar[j_1][j_2];
+      }
+      mcmc.chain[tempi].corrUpdate = chain->corrUpdate;
+      //mcmc.chain[tempi].corrUpdate = 0; //Correlated update proposals only for T=1 chain?
+      //mcmc.chain[mcmc.nTemps-1].corrUpdate = 0; //Correlated update proposals not for hottest chain
     }
   }
   
@@ -297,100 +317,138 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   
   
   
+  // *** Set up the chains to be updated on separate threads:  the state of each chain is in its own struct MCMCchain in mcmc.chain,
+  //       while the settings in mcmc are shared by all chains and read only during the update.  Each chain has its own parameter set
+  //       and its own random-number stream, and each thread its own copy of the network (see IFOthreadInit()).
+  int nThreads = mcmcThreads(&mcmc);
+  mcmc.mtmThreads = 1;
+  if(mcmc.nTemps==1 && mcmc.mtmFrac>0.0 && mcmc.mtmCandidates>1) mcmc.mtmThreads = min(nThreads, mcmc.mtmCandidates);  // No chains to share the threads:  evaluate the multiple-try candidates on them
+  nThreads = min(nThreads, mcmc.nTemps);
+  if(mcmc.beVerbose>=1 && nThreads>1) printf("   MCMC: updating the %d chains on %d threads\n",mcmc.nTemps,nThreads);
+  if(mcmc.beVerbose>=1 && mcmc.mtmThreads>1) printf("   MCMC: evaluating the %d multiple-try candidates on %d threads\n",mcmc.mtmCandidates,mcmc.mtmThreads);
+  int nCopies = max(nThreads, mcmc.mtmThreads);
+  
+  struct parSet *chainState = (struct parSet*)malloc(sizeof(struct parSet) * mcmc.nTemps);
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) {
+    if(tempi>0) {
+      mcmc.chain[tempi].ran = gsl_rng_alloc(gsl_rng_mt19937);
+      gsl_rng_set(mcmc.chain[tempi].ran, gsl_rng_get(mcmc.ran));    // Seed the stream of each hot chain from the main stream
+    }
+    chainState[tempi] = state;
+    allocParset(&chainState[tempi], mcmc.networkSize);
+  }
+  
+  struct interferometer *ifoCopies = NULL;
+  struct interferometer **chainIfo = (struct interferometer**)malloc(sizeof(struct interferometer*) * nCopies*mcmc.networkSize);
+  if(nCopies>1) {
+    ifoCopies = (struct interferometer*)malloc(sizeof(struct interferometer) * nCopies*mcmc.networkSize);
+    for(i=0;i<nCopies*mcmc.networkSize;i++) {
+      IFOthreadInit(&ifoCopies[i], ifo[i%mcmc.networkSize]);
+      chainIfo[i] = &ifoCopies[i];
+    }
+  } else {
+    for(i=0;i<mcmc.networkSize;i++) chainIfo[i] = ifo[i];
+  }
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) mcmc.chain[tempi].threadIfo = chainIfo;
+  
+  
+  
+  
   // ********************************************************************************************************************************************************************************
   // ***  CREATE MARKOV CHAIN   *****************************************************************************************************************************************************
   // ********************************************************************************************************************************************************************************
   
+  struct timeval chainStart, chainEnd;       // Wall-clock time of the Markov chain, to report the sampler throughput
+  gettimeofday(&chainStart, NULL);
+  
   mcmc.iIter = 1;
   while(mcmc.iIter<=mcmc.nIter) {  // loop over Markov-chain states 
     
-    for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {  // loop over temperature ladder
-      mcmc.iTemp = mcmc.iTemp;
-      
-      //Set temperature
-      if(mcmc.parallelTempering==1 || mcmc.parallelTempering==3) { //Chains at fixed T
-        mcmc.chTemp = mcmc.tempLadder[mcmc.iTemp];
-      }
-      if(mcmc.parallelTempering==2 || mcmc.parallelTempering==4) { //Chains with sinusoid T
-        if(mcmc.iTemp==0) {
-          mcmc.chTemp = 1.0;
-        } else {
-          mcmc.chTemp = mcmc.tempLadder[mcmc.iTemp]  +  mcmc.tempAmpl[mcmc.iTemp] * pow((-1.0),mcmc.iTemp) * sin(tpi*(double)mcmc.iIter/(5.0*(double)mcmc.nCorr));  //Sinusoid around the temperature T_i with amplitude tempAmpl and period 5.0 * nCorr
-          mcmc.chTemp = max(mcmc.chTemp, 1.0);  // Make sure T>=1
-        }
-      }
-      
-      
-      
-      // *** UPDATE MARKOV CHAIN STATE **************************************************************************************************************************************************
-      
-      // *** Uncorrelated update *************************************************************************************************
-      if(gsl_rng_uniform(mcmc.ran) > mcmc.corrFrac) {                                               //Do correlated updates from the beginning (quicker, but less efficient start); this saves ~4-5h for 2D, nCorr=1e4, nTemps=5
-        if(gsl_rng_uniform(mcmc.ran) < mcmc.blockFrac){   
-          uncorrelatedMCMCblockUpdate(ifo, &state, &mcmc, run);                                          //Block update for the current temperature chain
-        } else {
-			//for(i=0;i<mcmc.nMCMCpar;i++){
-				uncorrelatedMCMCsingleUpdate(ifo, &state, &mcmc, run);                                         //Componentwise update for the current temperature chain (e.g. 90% of the time)
-			//}
-        }
-	
-        // *** Correlated update ****************************************************************************************************
-      } else {
-        correlatedMCMCupdate(ifo, &state, &mcmc, run);
-      }
+    // *** UPDATE MARKOV CHAIN STATES:  update the chains independently, on nThreads threads at once ****************************
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nThreads) schedule(static,1) if(nThreads>1)
+#endif
+    for(tempi=0;tempi<mcmc.nTemps;tempi++) {
+#ifdef _OPENMP
+      struct interferometer **thisIfo = chainIfo + omp_get_thread_num()*mcmc.networkSize;
+#else
+      struct interferometer **thisIfo = chainIfo;
+#endif
+      updateChain(thisIfo, &chainState[tempi], &mcmc, &mcmc.chain[tempi], &run.likePar);
+    }
+    
+    
+    for(tempi=0;tempi<mcmc.nTemps;tempi++) {  // loop over temperature ladder
+      chain = &mcmc.chain[tempi];
       
       
       // Update the dlogL = logL - logLo, and remember the parameter values where it has a maximum
-      mcmc.dlogL[mcmc.iTemp] = mcmc.logL[mcmc.iTemp];
-      if(mcmc.dlogL[mcmc.iTemp]>mcmc.maxdlogL[mcmc.iTemp]) {
-        mcmc.maxdlogL[mcmc.iTemp] = mcmc.dlogL[mcmc.iTemp];
-        for(i=0;i<mcmc.nMCMCpar;i++) mcmc.maxLparam[mcmc.iTemp][i] = mcmc.param[mcmc.iTemp][i];
+      chain->dlogL = chain->logL;
+      if(chain->dlogL>chain->maxdlogL) {
+        chain->maxdlogL = chain->dlogL;
+        for(i=0;i<mcmc.nMCMCpar;i++) chain->maxLparam[i] = chain->param[i];
       }
       
       
       // *** ACCEPT THE PROPOSED UPDATE *************************************************************************************************************************************************
       
-      if(mcmc.acceptPrior[0]==1) { //Then write output and take care of the correlation matrix
+      if(mcmc.chain[0].acceptPrior==1) { //Then write output and take care of the correlation matrix
 	
 	
         // *** WRITE STATE TO SCREEN AND FILE *******************************************************************************************************************************************
 	
-        writeMCMCoutput(mcmc, ifo);  //Write output line to screen and/or file
+        if(tempi==0 && mcmc.marginalisePhaseDist>=1 && (mcmc.iIter % mcmc.thinOutput)==0) {
+          drawPhaseDistance(ifo, &state, &mcmc, chain, &run.likePar);  // Replace the fixed phi_c and/or d_L by draws from their conditional posterior
+          writeMCMCoutput(&mcmc, chain, ifo);  //Write output line to screen and/or file
+          for(i=0;i<mcmc.nMCMCpar;i++) chain->param[i] = state.par[i];   // Restore the reference values
+        } else {
+          writeMCMCoutput(&mcmc, chain, ifo);  //Write output line to screen and/or file
+        }
+        
+        // Add the conditional posterior of t_c of the saved state, when the likelihood is marginalised over t_c:
+        if(tempi==0 && mcmc.marginaliseTime==1 && ifo[0]->tMargN>0 && (mcmc.iIter % mcmc.thinOutput)==0) 
+          accumulateTimePosterior(ifo, &state, &mcmc, &run.likePar);
+        
+        if(mcmc.deFrac>0.0) storeDEhistory(&mcmc, chain);  // Add the state to the history for differential-evolution updates
 	
 	
 	
         // *** CORRELATION MATRIX *******************************************************************************************************************************************************
 	
-        if(mcmc.corrUpdate[mcmc.iTemp]>=2) { //Calculate correlations multiple times
+        if(chain->corrUpdate>=2) { //Calculate correlations multiple times
 	  
-          // *** Save state to calculate correlations ***
-          if(mcmc.iHist[mcmc.iTemp]<mcmc.nCorr) {
-            for(j_1=0;j_1<mcmc.nMCMCpar;j_1++) mcmc.hist[mcmc.iTemp][j_1][mcmc.iHist[mcmc.iTemp]] = mcmc.param[mcmc.iTemp][j_1];
-            mcmc.iHist[mcmc.iTemp] += 1;
-          }
+          // *** Add the state to the running covariance matrix ***
+          accumulateCovariance(&mcmc, chain);
+          chain->iHist += 1;
 	  
 	  
 	  
           // ***  Update covariance matrix  and  print parallel-tempering info  *************************************************************
-          if(mcmc.iHist[mcmc.iTemp]>=mcmc.nCorr) {
+          if(chain->iHist>=mcmc.corrRefresh) {
 	    
-            updateCovarianceMatrix(&mcmc);  // Calculate the new covariance matrix for the current temperature chain and determine whether the matrix should be updated
+            updateCovarianceMatrix(&mcmc, chain);  // Calculate the new covariance matrix for the current temperature chain and determine whether the matrix should be updated
 	    
 	    
-            if(mcmc.parallelTempering>=1 && mcmc.prParTempInfo>0) writeChainInfo(mcmc);  //Print info on the current (temperature) chain(s) to screen
+            if(mcmc.parallelTempering>=1 && mcmc.prParTempInfo>0) writeChainInfo(&mcmc, chain);  //Print info on the current (temperature) chain(s) to screen
 	    
 	    
-            mcmc.iHist[mcmc.iTemp] = 0;        //Reset history counter for the covariance matrix  This is also used for parallel tempering, which should perhaps get its own counter(?)
+            chain->iHist = 0;        //Reset history counter for the covariance matrix  This is also used for parallel tempering, which should perhaps get its own counter(?)
 	    
-          } //if(mcmc.iHist[mcmc.iTemp]>=mcmc.nCorr)
-        } //if(mcmc.corrUpdate[mcmc.iTemp]>=2)
+          } //if(chain->iHist>=mcmc.corrRefresh)
+        } //if(chain->corrUpdate>=2)
         // *** END CORRELATION MATRIX *************************************************************
 	
-      } //if(mcmc.acceptPrior[mcmc.iTemp]==1)
+      } //if(mcmc.chain[0].acceptPrior==1)
       
-    } // for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) {  //loop over temperature ladder
+    } // for(tempi=0;tempi<mcmc.nTemps;tempi++) {  //loop over temperature ladder
+    
+    
+    
+    
     
     
+    // *** RELATIVE BINNING:  check the likelihood of the T=1 chain against the full likelihood ***
+    if(mcmc.chain[0].acceptPrior==1 && mcmc.relBinCheck>0 && ifo[0]->relBinUse==1 && mcmc.iIter%mcmc.relBinCheck==0) checkRelativeBinning(ifo, &state, &mcmc, &run.likePar);
     
     
     
@@ -398,7 +456,7 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
     // *** ANNEALING ****************************************************************************************************************************************************************
     
     //Doesn't work with parallel tempering.  Use only when not using parallel tempering (and of course, temp0>1)
-    if(mcmc.parallelTempering==0 && mcmc.annealTemp0>1.0) mcmc.chTemp = annealTemperature(mcmc.annealTemp0, mcmc.annealNburn, mcmc.annealNburn0, mcmc.iIter);
+    if(mcmc.parallelTempering==0 && mcmc.annealTemp0>1.0) mcmc.chain[0].chTemp = annealTemperature(mcmc.annealTemp0, mcmc.annealNburn, mcmc.annealNburn0, mcmc.iIter);
     
     
     // *** A test with adaptive parallel tempering was here.   
@@ -409,10 +467,10 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
     
     // *** PARALLEL TEMPERING:  Swap states between T-chains *************************************************************************
     
-    if(mcmc.acceptPrior[0]==1 && mcmc.parallelTempering>=1 && mcmc.nTemps>1) swapChains(&mcmc);
+    if(mcmc.chain[0].acceptPrior==1 && mcmc.parallelTempering>=1 && mcmc.nTemps>1) swapChains(&mcmc);
     
     
-    if(mcmc.acceptPrior[0]==1) mcmc.iIter++;
+    if(mcmc.chain[0].acceptPrior==1) mcmc.iIter++;
   } // while(iIter<=mcmc.nIter) {  //loop over markov chain states 
   
   
@@ -420,30 +478,48 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
   // ***  END CREATE MARKOV CHAIN   *************************************************************************************************************************************************
   // ********************************************************************************************************************************************************************************
   
+  gettimeofday(&chainEnd, NULL);
+  if(mcmc.beVerbose >= 1) {
+    double chainTime = (double)(chainEnd.tv_sec - chainStart.tv_sec) + 1.e-6*(double)(chainEnd.tv_usec - chainStart.tv_usec);
+    printf("\n   MCMC: %d iterations (%d chains) in %.2lf s wall-clock time:  %.1lf iterations/s\n",
+           mcmc.iIter-1,mcmc.nTemps,chainTime,(double)(mcmc.iIter-1)/max(chainTime,1.e-6));
+    if(mcmc.mtmFrac>0.0 || mcmc.deFrac>0.0) writeUpdateStatistics(&mcmc.chain[0]);
+  }
+#ifdef SPINSPIRAL_CHECKS
+  long likelihoodAllocations = 0;
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) likelihoodAllocations += mcmc.chain[tempi].likelihoodAllocations;
+  if(likelihoodAllocations > 0) {
+    fprintf(stderr, "\n ***  Warning:  the likelihood of the proposals made %ld heap allocations ***\n\n",likelihoodAllocations);
+  } else if(mcmc.beVerbose >= 1) {
+    printf("   MCMC: no heap allocations in the likelihood of the proposals\n");
+  }
+#endif
   
   
   
   
-  for(mcmc.iTemp=0;mcmc.iTemp<mcmc.nTemps;mcmc.iTemp++) if(mcmc.iTemp==0 || mcmc.saveHotChains>0) fclose(mcmc.fouts[mcmc.iTemp]);
+  
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) if(tempi==0 || mcmc.saveHotChains>0) fclose(mcmc.fouts[tempi]);
   free(mcmc.fouts);
   
+  if(mcmc.tMargPostCount>0) writeTimePosterior(&mcmc, ifo, run.outputPath);
+  
   
   // *** FREE MEMORY **************************************************************************************************************************************************************
   
   printf("\n");
-  freeMCMCvariables(&mcmc);
+  freeMCMCvariables(&mcmc);                   // Including the random-number streams of the chains
   
   
-  for(i=0;i<mcmc.nMCMCpar;i++) free(tempcovar[i]);
-  free(tempcovar);
+  freeParset(&state);
   
-  for(i=0;i<mcmc.nTemps;i++) {
-    for(j=0;j<mcmc.nMCMCpar;j++) free(covar1[i][j]);
-    free(covar1[i]);
+  for(tempi=0;tempi<mcmc.nTemps;tempi++) freeParset(&chainState[tempi]);
+  free(chainState);
+  if(nCopies>1) {
+    for(i=0;i<nCopies*mcmc.networkSize;i++) IFOthreadDispose(&ifoCopies[i]);
+    free(ifoCopies);
   }
-  free(covar1);
-  
-  freeParset(&state);
+  free(chainIfo);
   
 } // End MCMC()
 // ****************************************************************************************************************************************************  
@@ -453,6 +529,138 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine the number of threads to update the temperature chains or evaluate the multiple-try candidates on
+ *
+ * mcmc->nThreads threads (0: the number of processors).  A single thread is used when the code was compiled without OpenMP 
+ * (CMake option WANT_OPENMP), or when the MCMC waveform is not thread safe (e.g. a LAL waveform with a LAL built without pthread locks).
+ */
+// ****************************************************************************************************************************************************  
+int mcmcThreads(const struct MCMCvariables *mcmc)
+{
+  int nThreads = 1;
+  
+#ifdef _OPENMP
+  nThreads = mcmc->nThreads;
+  if(nThreads<=0) nThreads = omp_get_num_procs();
+#else
+  if(mcmc->nThreads!=1) fprintf(stderr, "\n ***  Warning:  mcmcThreads():  compiled without OpenMP (WANT_OPENMP), using a single thread ***\n\n");
+#endif
+  nThreads = max(nThreads, 1);
+  
+  if(nThreads>1 && !waveformCapability(mcmc->mcmcWaveform, wfThreadSafe)) {
+    fprintf(stderr, "\n ***  Warning:  mcmcThreads():  waveform %d is not thread safe (see getWaveformBackend()), using a single thread ***\n\n",mcmc->mcmcWaveform);
+    nThreads = 1;
+  }
+  
+  return nThreads;
+} // End mcmcThreads()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Set the temperature of the chain and propose and accept or reject an update of its state
+ *
+ * The update is an uncorrelated single-parameter (update type 0), an uncorrelated block (1), a correlated (2) or a multiple-try 
+ * correlated (3) update.  This changes only the state in chain, reads the shared settings in mcmc, and draws from the random-number 
+ * stream of the chain, so that the chains can be updated on separate threads, each with its own copy of the network ifo and scratch 
+ * parameter set state.  The number of proposals and accepted proposals, the wall-clock time and the squared jump distance are
+ * counted per update type (see writeUpdateStatistics()).
+ */
+// ****************************************************************************************************************************************************  
+void updateChain(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
+{
+  int p=0, k=0, type=0;
+  double oldParam[mcmc->nMCMCpar], jump=0.0;
+  struct timeval start, end;
+  
+  for(p=0;p<mcmc->nMCMCpar;p++) oldParam[p] = chain->param[p];
+  gettimeofday(&start, NULL);
+  
+  //Set temperature
+  if(mcmc->parallelTempering==1 || mcmc->parallelTempering==3) { //Chains at fixed T
+    chain->chTemp = mcmc->tempLadder[chain->iTemp];
+  }
+  if(mcmc->parallelTempering==2 || mcmc->parallelTempering==4) { //Chains with sinusoid T
+    if(chain->iTemp==0) {
+      chain->chTemp = 1.0;
+    } else {
+      chain->chTemp = mcmc->tempLadder[chain->iTemp]  +  mcmc->tempAmpl[chain->iTemp] * pow((-1.0),chain->iTemp) * sin(tpi*(double)mcmc->iIter/(5.0*(double)mcmc->nCorr));  //Sinusoid around the temperature T_i with amplitude tempAmpl and period 5.0 * nCorr
+      chain->chTemp = max(chain->chTemp, 1.0);  // Make sure T>=1
+    }
+  }
+  
+  
+  // *** Uncorrelated update *************************************************************************************************
+  if(gsl_rng_uniform(chain->ran) > mcmc->corrFrac) {                                                      //Do correlated updates from the beginning (quicker, but less efficient start); this saves ~4-5h for 2D, nCorr=1e4, nTemps=5
+    double uUncorr = gsl_rng_uniform(chain->ran);                                                       //Fractions deFrac, blockFrac and the rest of the uncorrelated updates
+    if(uUncorr < mcmc->deFrac && chain->deN>=2) {                                                        //Differential-evolution update, once the history holds two states
+      type = 4;
+      differentialEvolutionMCMCupdate(ifo, state, mcmc, chain, likePar);
+    } else if(uUncorr >= mcmc->deFrac && uUncorr < mcmc->deFrac + mcmc->blockFrac){   
+      type = 1;
+      uncorrelatedMCMCblockUpdate(ifo, state, mcmc, chain, likePar);                                          //Block update for the current temperature chain
+    } else {
+      type = 0;
+      uncorrelatedMCMCsingleUpdate(ifo, state, mcmc, chain, likePar);                                         //Componentwise update for the current temperature chain (e.g. 90% of the time)
+    }
+    
+    // *** Correlated update ****************************************************************************************************
+  } else if(mcmc->mtmFrac>0.0 && mcmc->mtmCandidates>1 && gsl_rng_uniform(chain->ran) < mcmc->mtmFrac) {
+    type = 3;
+    multipleTryMCMCupdate(ifo, mcmc, chain, likePar);
+  } else {
+    type = 2;
+    correlatedMCMCupdate(ifo, state, mcmc, chain, likePar);
+  }
+  
+  gettimeofday(&end, NULL);
+  for(k=0;k<mcmc->nParFit;k++) {
+    p = mcmc->parFree[k];
+    jump += pow((chain->param[p] - oldParam[p])/mcmc->parSigma[p], 2);
+  }
+  chain->updateProposed[type] += 1;
+  if(jump>0.0) chain->updateAccepted[type] += 1;
+  chain->updateTime[type] += (double)(end.tv_sec - start.tv_sec) + 1.e-6*(double)(end.tv_usec - start.tv_usec);
+  chain->updateJump[type] += jump;
+} // End updateChain()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Print the acceptance and efficiency of the different update types of the chain
+ *
+ * The efficiency is measured as the squared jump distance (in units of parSigma) per wall-clock second.  For a random-walk sampler
+ * this is proportional to the number of effective (independent) samples per second, and it allows to compare the update types, e.g. the single-try and 
+ * multiple-try updates, which differ in cost per proposal.
+ */
+// ****************************************************************************************************************************************************  
+void writeUpdateStatistics(const struct MCMCchain *chain)
+{
+  int type=0;
+  char typeName[nUpdateTypes][99] = {"single-parameter","block","correlated","multiple-try","diff. evolution"};
+  
+  printf("\n   MCMC update statistics of chain %d:\n",chain->iTemp);
+  printf("   %18s  %10s  %10s  %10s  %12s  %16s\n","Update type:","Proposals:","Accepted:","Time (s):","Accepted/s:","Sq.jump dist./s:");
+  for(type=0;type<nUpdateTypes;type++) {
+    if(chain->updateProposed[type]==0) continue;
+    printf("   %18s  %10ld  %9.1lf%%  %10.2lf  %12.1lf  %16.3lf\n",typeName[type],chain->updateProposed[type],
+           100.0*(double)chain->updateAccepted[type]/(double)chain->updateProposed[type],chain->updateTime[type],
+           (double)chain->updateAccepted[type]/max(chain->updateTime[type],1.e-6),chain->updateJump[type]/max(chain->updateTime[type],1.e-6));
+  }
+} // End writeUpdateStatistics()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
 
 
 
@@ -468,10 +676,10 @@ void MCMC(struct runPar run, struct interferometer *ifo[])
  *
  */
 // ****************************************************************************************************************************************************  
-void par2arr(struct parSet par, double **param, struct MCMCvariables mcmc)
+void par2arr(const struct parSet *par, double *param, const struct MCMCvariables *mcmc)
 {
   int i=0;
-  for(i=0;i<mcmc.nMCMCpar;i++) param[mcmc.iTemp][i] = par.par[i];
+  for(i=0;i<mcmc->nMCMCpar;i++) param[i] = par->par[i];
 } // End par2arr
 // ****************************************************************************************************************************************************  
 
@@ -483,10 +691,10 @@ void par2arr(struct parSet par, double **param, struct MCMCvariables mcmc)
  *
  */
 // ****************************************************************************************************************************************************  
-void arr2par(double **param, struct parSet *par, struct MCMCvariables mcmc)
+void arr2par(const double *param, struct parSet *par, const struct MCMCvariables *mcmc)
 {
   int i=0;
-  for(i=0;i<mcmc.nMCMCpar;i++) par->par[i] = param[mcmc.iTemp][i];
+  for(i=0;i<mcmc->nMCMCpar;i++) par->par[i] = param[i];
 } // End arr2par
 // ****************************************************************************************************************************************************  
 
@@ -509,22 +717,22 @@ void arr2par(double **param, struct parSet *par, struct MCMCvariables mcmc)
  * Contains boundary conditions and prior information for the MCMC.  Try to avoid returning 0, to increase jump sizes
  */
 // ****************************************************************************************************************************************************  
-double prior(double *par, int p, struct MCMCvariables mcmc)
+double prior(double *par, int p, const struct MCMCvariables *mcmc)
 {
   double priorValue = 1.0;
   
-  if(mcmc.priorType[p]==21) {                                               // Periodic boundary condition to bring the variable between 0 and 2pi
+  if(mcmc->priorType[p]==21) {                                               // Periodic boundary condition to bring the variable between 0 and 2pi
     *par = fmod(*par+mtpi,tpi); 
-  } else if(mcmc.priorType[p]==22) {                                        // Periodic boundary condition to bring the variable between 0 and pi
+  } else if(mcmc->priorType[p]==22) {                                        // Periodic boundary condition to bring the variable between 0 and pi
     *par = fmod(*par+mtpi,pi); 
   } else {                                                                  // Bounce back from the wall
-    if(*par < mcmc.priorBoundLow[p] || *par > mcmc.priorBoundUp[p]) {                                        // Do only one bounce
-      if(*par < mcmc.priorBoundLow[p]) {
-        *par = mcmc.priorBoundLow[p] + fabs(*par - mcmc.priorBoundLow[p]);
+    if(*par < mcmc->priorBoundLow[p] || *par > mcmc->priorBoundUp[p]) {                                        // Do only one bounce
+      if(*par < mcmc->priorBoundLow[p]) {
+        *par = mcmc->priorBoundLow[p] + fabs(*par - mcmc->priorBoundLow[p]);
       } else {
-        *par = mcmc.priorBoundUp[p] - fabs(*par - mcmc.priorBoundUp[p]);
+        *par = mcmc->priorBoundUp[p] - fabs(*par - mcmc->priorBoundUp[p]);
       }
-      if(*par<mcmc.priorBoundLow[p] || *par>mcmc.priorBoundUp[p]) priorValue = 0.0;                             // If, after bouncing once, still outside the range, reject
+      if(*par<mcmc->priorBoundLow[p] || *par>mcmc->priorBoundUp[p]) priorValue = 0.0;                             // If, after bouncing once, still outside the range, reject
     }
   }
   
@@ -540,11 +748,11 @@ double prior(double *par, int p, struct MCMCvariables mcmc)
  *
  */
 // ****************************************************************************************************************************************************  
-double sigmaPeriodicBoundaries(double sigma, int p, struct MCMCvariables mcmc)
+double sigmaPeriodicBoundaries(double sigma, int p, const struct MCMCvariables *mcmc)
 {
-  if(mcmc.priorType[p] == 21) {
+  if(mcmc->priorType[p] == 21) {
     return min(tpi,sigma);                                     //Bring sigma between 0 and 2pi;
-  } else if(mcmc.priorType[p] == 22) {
+  } else if(mcmc->priorType[p] == 22) {
     return min(pi,sigma);                                      //Bring sigma between 0 and pi;
   } else {
     return sigma;                                              //Don't do anything
@@ -569,91 +777,78 @@ double sigmaPeriodicBoundaries(double sigma, int p, struct MCMCvariables mcmc)
  * Some experiments with larger jumps using the 'hotter' covariance matrix.
  */
 // ****************************************************************************************************************************************************  
-void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run)
+void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
 // ****************************************************************************************************************************************************  
 {
-  int p1=0, p2=0, tempi=mcmc->iTemp, tempj=0;
-  double temparr[mcmc->nMCMCpar], dparam=0.0;
+  int p=0, k=0;
+  double temparr[mcmc->nParFit], dparam[mcmc->nParFit];
   double ran=0.0, largejump1=0.0, largejumpall=0.0;
   
   //Prepare the proposal by creating a vector of univariate gaussian random numbers
   largejumpall = 1.0;
-  ran = gsl_rng_uniform(mcmc->ran);
+  ran = gsl_rng_uniform(chain->ran);
   if(ran < 1.0e-3) {
     largejumpall = 1.0e1;    //Every 1e3 iterations, take a 10x larger jump in all parameters
     if(ran < 1.0e-4) largejumpall = 1.0e2;    //Every 1e4 iterations, take a 100x larger jump in all parameters
   }
   
-  for(p1=0;p1<mcmc->nMCMCpar;p1++) {
+  for(k=0;k<mcmc->nParFit;k++) {
     largejump1 = 1.0;
-    ran = gsl_rng_uniform(mcmc->ran);
+    ran = gsl_rng_uniform(chain->ran);
     if(ran < 1.0e-2) {
       largejump1 = 1.0e1;    //Every 1e2 iterations, take a 10x larger jump in this parameter
       if(ran < 1.0e-3) largejump1 = 1.0e2;    //Every 1e3 iterations, take a 100x larger jump in this parameter
     }
-    tempj = tempi;
-    /*
-      if(largejump1*largejumpall > 1.01) { //When making a larger jump, use the 'hotter' covariance matrix
-      tempj = min(tempj+1,mcmc->nTemps);
-      if(largejump1*largejumpall > 10.01) tempj = min(tempj+1,mcmc->nTemps);
-      }
-    */
-    temparr[p1] = gsl_ran_gaussian(mcmc->ran,1.0) * mcmc->corrSig[tempj] * largejump1 * largejumpall;   //Univariate gaussian random numbers, with sigma=1, times the adaptable sigma_correlation times the large-jump factors
+    temparr[k] = gsl_ran_gaussian(chain->ran,1.0) * chain->corrSig * largejump1 * largejumpall;   //Univariate gaussian random numbers, with sigma=1, times the adaptable sigma_correlation times the large-jump factors
   }
   
   //Do the proposal
-  mcmc->acceptPrior[tempi] = 1;
-  for(p1=0;p1<mcmc->nMCMCpar;p1++){
-    if(mcmc->parFix[p1]==0) {
-      dparam = 0.0;
-      for(p2=0;p2<=p1;p2++) dparam += mcmc->covar[tempi][p1][p2]*temparr[p2];     //Temparr is now a univariate gaussian random vector
-      mcmc->nParam[tempi][p1] = mcmc->param[tempi][p1] + dparam;                  //Jump from the previous parameter value
-      mcmc->adaptSigmaOut[tempi][p1] = fabs(dparam);                              //This isn't really sigma, but the proposed jump size
-      mcmc->acceptPrior[tempi] *= (int)prior(&mcmc->nParam[tempi][p1],p1,*mcmc);
-    }
+  lowerTriangularProduct(chain->covar, temparr, dparam, mcmc->nParFit);     //Temparr is a univariate gaussian random vector
+  chain->acceptPrior = 1;
+  for(k=0;k<mcmc->nParFit;k++){
+    p = mcmc->parFree[k];
+    chain->nParam[p] = chain->param[p] + dparam[k];                   //Jump from the previous parameter value
+    chain->adaptSigmaOut[p] = fabs(dparam[k]);                               //This isn't really sigma, but the proposed jump size
+    chain->acceptPrior *= (int)prior(&chain->nParam[p],p,mcmc);
   }
   
   
   
   /*
   //Testing with sky position/orientation updates
-  if(gsl_rng_uniform(mcmc->ran) < 0.33) mcmc->nParam[tempi][6]  = fmod(mcmc->nParam[tempi][6]+pi,tpi);  //Move RA over 12h
-  if(gsl_rng_uniform(mcmc->ran) < 0.33) mcmc->nParam[tempi][7]  *= -1.0;                                //Flip declination
-  if(gsl_rng_uniform(mcmc->ran) < 0.33) mcmc->nParam[tempi][9]  *= -1.0;                                //Flip theta_Jo
-  if(gsl_rng_uniform(mcmc->ran) < 0.33) mcmc->nParam[tempi][10] = fmod(mcmc->nParam[tempi][10]+pi,tpi); //Move phi_Jo over 12h
+  if(gsl_rng_uniform(chain->ran) < 0.33) chain->nParam[6]  = fmod(chain->nParam[6]+pi,tpi);  //Move RA over 12h
+  if(gsl_rng_uniform(chain->ran) < 0.33) chain->nParam[7]  *= -1.0;                                //Flip declination
+  if(gsl_rng_uniform(chain->ran) < 0.33) chain->nParam[9]  *= -1.0;                                //Flip theta_Jo
+  if(gsl_rng_uniform(chain->ran) < 0.33) chain->nParam[10] = fmod(chain->nParam[10]+pi,tpi); //Move phi_Jo over 12h
   */
   
   
   
   
   //Decide whether to accept
-  if(mcmc->acceptPrior[tempi]==1) {                                            //Then calculate the likelihood
-    arr2par(mcmc->nParam, state, *mcmc);                                       //Get the parameters from their array
-    int injectionWF = 0;                                                 // Call netLogLikelihood with an MCMC waveform
-    localPar(state, ifo, mcmc->networkSize, injectionWF, run);
-    mcmc->nlogL[tempi] = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, run); //Calculate the likelihood
-    par2arr(*state, mcmc->nParam, *mcmc);                                      //Put the variables back in their array
+  if(chain->acceptPrior==1) {                                            //Then calculate the likelihood
+    chain->nlogL = proposalLogLikelihood(ifo, state, mcmc, chain, likePar, -1);  //Calculate the likelihood
     
-    if(exp(max(-30.0,min(0.0,mcmc->nlogL[tempi]-mcmc->logL[tempi]))) > pow(gsl_rng_uniform(mcmc->ran),mcmc->chTemp) && mcmc->nlogL[tempi] > mcmc->minlogL) {  // Accept proposal
-      for(p1=0;p1<mcmc->nMCMCpar;p1++) {
-        if(mcmc->parFix[p1]==0) {
-          mcmc->param[tempi][p1] = mcmc->nParam[tempi][p1];
-          mcmc->accepted[tempi][p1] += 1;
-        }
+    if(exp(max(-30.0,min(0.0,chain->nlogL-chain->logL))) > pow(gsl_rng_uniform(chain->ran),chain->chTemp) && chain->nlogL > mcmc->minlogL) {  // Accept proposal
+      for(k=0;k<mcmc->nParFit;k++) {
+        p = mcmc->parFree[k];
+        chain->param[p] = chain->nParam[p];
+        chain->accepted[p] += 1;
       }
-      mcmc->logL[tempi] = mcmc->nlogL[tempi];
+      chain->logL = chain->nlogL;
+      storeOverlapCache(mcmc, chain);
       if(mcmc->adaptiveMCMC==1){ 
-        mcmc->corrSig[tempi] *= mcmc->increaseSigma;                    // Increase sigma
+        chain->corrSig *= mcmc->increaseSigma;                    // Increase sigma
       }
     } else {                                                      // Reject proposal because of low likelihood
       if(mcmc->adaptiveMCMC==1){ 
-        mcmc->corrSig[tempi] *= mcmc->decreaseSigma;                    // Decrease sigma
+        chain->corrSig *= mcmc->decreaseSigma;                    // Decrease sigma
       }
     }
   } else {                                                        // Reject proposal because of boundary conditions.  Perhaps one should increase the step size, or at least not decrease it?
     /*
       if(mcmc->adaptiveMCMC==1){ 
-      mcmc->corrSig[tempi] *= 0.8;
+      chain->corrSig *= 0.8;
       }
     */
   }
@@ -662,6 +857,166 @@ void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, st
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Do a multiple-try Metropolis correlated block update
+ *
+ * Draw K = mcmc->mtmCandidates candidate proposals y_j from the Cholesky-decomposed covariance matrix (see correlatedProposal()), and
+ * select one, y, with a probability proportional to its tempered likelihood L(y_j)^(1/T).  Then draw K-1 reference states x_j around y,
+ * and take the current state as x_K.  The selected candidate is accepted with probability  min(1, sum_j L(y_j)^(1/T) / sum_j L(x_j)^(1/T))
+ * (Liu, Liang & Wong 2000;  for a symmetric proposal and within the prior boundaries).  The 2K-1 likelihoods are computed in two batches 
+ * on mcmc->mtmThreads threads (see candidateLogLikelihoods()).  There is no adaptation here;  the jump size corrSig is adapted by the
+ * single-try correlated updates.
+ */
+// ****************************************************************************************************************************************************  
+void multipleTryMCMCupdate(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
+{
+  int j=0, k=0, p=0, sel=0, nPar=mcmc->nMCMCpar, nCand=mcmc->mtmCandidates;
+  int candPrior[nCand], refPrior[nCand];
+  double cand[nCand*nPar], candLogL[nCand], candHD[nCand], candHH[nCand];
+  double ref[nCand*nPar], refLogL[nCand], refHD[nCand], refHH[nCand];
+  double maxLogL=-1.e30, sumCand=0.0, sumRef=0.0, cumul=0.0, ran=0.0;
+  
+  // Draw the candidates around the current state and compute their likelihoods:
+  for(j=0;j<nCand;j++) candPrior[j] = correlatedProposal(mcmc, chain, chain->param, &cand[j*nPar]);
+  chain->likelihoodAllocations += candidateLogLikelihoods(ifo, mcmc, chain, likePar, cand, candPrior, nCand, candLogL, candHD, candHH);
+  
+  for(j=0;j<nCand;j++) {
+    if(candPrior[j]==1 && candLogL[j] > mcmc->minlogL) {
+      maxLogL = max(maxLogL, candLogL[j]);
+    } else {
+      candPrior[j] = 0;                                                            // Weight 0:  outside the prior or below minlogL
+    }
+  }
+  if(maxLogL < -1.e29) {                                                           // Reject:  no candidate is within the prior range
+    chain->acceptPrior = 0;
+    return;
+  }
+  chain->acceptPrior = 1;
+  
+  // Select a candidate with a probability proportional to its weight:
+  for(j=0;j<nCand;j++) if(candPrior[j]==1) sumCand += exp((candLogL[j]-maxLogL)/chain->chTemp);
+  ran = gsl_rng_uniform(chain->ran) * sumCand;
+  for(sel=0;sel<nCand-1;sel++) {
+    if(candPrior[sel]==1) {
+      cumul += exp((candLogL[sel]-maxLogL)/chain->chTemp);
+      if(cumul > ran) break;
+    }
+  }
+  while(candPrior[sel]==0) sel--;                                                  // Rounding:  take the last candidate with non-zero weight
+  
+  // Draw the reference states around the selected candidate, and add the current state:
+  for(j=0;j<nCand-1;j++) refPrior[j] = correlatedProposal(mcmc, chain, &cand[sel*nPar], &ref[j*nPar]);
+  chain->likelihoodAllocations += candidateLogLikelihoods(ifo, mcmc, chain, likePar, ref, refPrior, nCand-1, refLogL, refHD, refHH);
+  refPrior[nCand-1] = 1;
+  refLogL[nCand-1] = chain->logL;
+  
+  for(j=0;j<nCand;j++) {
+    if(refPrior[j]==1 && (refLogL[j] > mcmc->minlogL || j==nCand-1)) {
+      sumRef += exp((refLogL[j]-maxLogL)/chain->chTemp);
+    }
+  }
+  
+  //Decide whether to accept
+  for(p=0;p<nPar;p++) chain->nParam[p] = cand[sel*nPar+p];
+  chain->nlogL = candLogL[sel];
+  if(gsl_rng_uniform(chain->ran)*sumRef < sumCand) {                                // Accept with probability min(1, sumCand/sumRef)
+    for(k=0;k<mcmc->nParFit;k++) {
+      p = mcmc->parFree[k];
+      chain->param[p] = chain->nParam[p];
+      chain->accepted[p] += 1;
+    }
+    chain->logL = chain->nlogL;
+    chain->nOverlapHD = candHD[sel];
+    chain->nOverlapHH = candHH[sel];
+    storeOverlapCache(mcmc, chain);
+  }
+} // End multipleTryMCMCupdate()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Propose a correlated jump of the chain from the parameter set from to the parameter set to
+ *
+ * to = from + corrSig C z, with C the Cholesky-decomposed covariance matrix and z a vector of univariate Gaussian random numbers, for
+ * the non-fixed parameters.  Returns 1 if to is within the prior boundaries, 0 otherwise.
+ */
+// ****************************************************************************************************************************************************  
+int correlatedProposal(const struct MCMCvariables *mcmc, struct MCMCchain *chain, const double *from, double *to)
+{
+  int p=0, k=0, inPrior=1;
+  double temparr[mcmc->nParFit], dparam[mcmc->nParFit];
+  
+  for(k=0;k<mcmc->nParFit;k++) temparr[k] = gsl_ran_gaussian(chain->ran,1.0) * chain->corrSig;
+  lowerTriangularProduct(chain->covar, temparr, dparam, mcmc->nParFit);
+  
+  for(p=0;p<mcmc->nMCMCpar;p++) to[p] = from[p];
+  for(k=0;k<mcmc->nParFit;k++) {
+    p = mcmc->parFree[k];
+    to[p] += dparam[k];
+    inPrior *= (int)prior(&to[p],p,mcmc);
+  }
+  return inPrior;
+} // End correlatedProposal()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(L) of nCand candidate parameter sets (stored consecutively in cand) at once
+ *
+ * The likelihoods are computed on mcmc->mtmThreads threads, with the copies of the network in chain->threadIfo, or in the network ifo 
+ * of the current (chain) thread if mcmc->mtmThreads==1.  Candidates outside the prior (candPrior[j]==0) are not computed.
+ * If the distance can be rescaled, the overlaps <d|h> and <h|h> are stored in overlapHD,HH (see storeOverlapCache()).
+ * Return the number of heap allocations in the likelihoods, summed over the threads (counted with SPINSPIRAL_CHECKS only).
+ */
+// ****************************************************************************************************************************************************  
+long candidateLogLikelihoods(struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct MCMCchain *chain, const struct likelihoodPar *likePar, const double *cand, const int *candPrior, int nCand, double *logL, double *overlapHD, double *overlapHH)
+{
+  int j=0;
+  long nAlloc=0;
+  
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(mcmc->mtmThreads) schedule(dynamic) if(mcmc->mtmThreads>1) reduction(+:nAlloc)
+#endif
+  for(j=0;j<nCand;j++) {
+    int i=0, injectionWF=0;                                                        // Call netLogLikelihood with an MCMC waveform
+    double loctc[mcmc->networkSize], localti[mcmc->networkSize], locazi[mcmc->networkSize];
+    struct parSet state;                                                           // Scratch parameter set of this thread
+    struct interferometer **thisIfo = ifo;
+#ifdef _OPENMP
+    if(mcmc->mtmThreads>1) thisIfo = chain->threadIfo + omp_get_thread_num()*mcmc->networkSize;
+#endif
+    
+    logL[j] = -1.e30;
+    overlapHD[j] = 0.0;
+    overlapHH[j] = 0.0;
+    if(candPrior[j]==0) continue;
+    
+    long nAlloc0 = heapAllocations();                                              // Counted per thread
+    state.loctc = loctc;
+    state.localti = localti;
+    state.locazi = locazi;
+    state.nPar = mcmc->nMCMCpar;
+    for(i=0;i<mcmc->nMCMCpar;i++) state.par[i] = cand[j*mcmc->nMCMCpar+i];
+    localPar(&state, thisIfo, mcmc->networkSize, injectionWF, likePar);
+    if(mcmc->distParIndex>=0) {
+      logL[j] = netLogLikelihoodOverlaps(&state, mcmc->networkSize, thisIfo, mcmc->mcmcWaveform, injectionWF, likePar, &overlapHD[j], &overlapHH[j]);
+    } else {
+      logL[j] = netLogLikelihood(&state, mcmc->networkSize, thisIfo, mcmc->mcmcWaveform, injectionWF, likePar);
+    }
+    nAlloc += heapAllocations() - nAlloc0;
+  }
+  
+  return nAlloc;
+} // End candidateLogLikelihoods()
+// ****************************************************************************************************************************************************  
+
+
+
 
 
 
@@ -680,70 +1035,65 @@ void correlatedMCMCupdate(struct interferometer *ifo[], struct parSet *state, st
  * Use adaptation.
  */
 // ****************************************************************************************************************************************************  
-void uncorrelatedMCMCsingleUpdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run)
+void uncorrelatedMCMCsingleUpdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
 // ****************************************************************************************************************************************************  
 {
-  int p=0, tempi=mcmc->iTemp;
+  int p=0, k=0;
   double s_gamma=0.0;
   double ran=0.0, largejumpall=0.0;
-  
+
   largejumpall = 1.0;
-  ran = gsl_rng_uniform(mcmc->ran);
+  ran = gsl_rng_uniform(chain->ran);
   if(ran < 1.0e-3) largejumpall = 1.0e1;    //Every 1e3 iterations, take a 10x larger jump in all parameters
   if(ran < 1.0e-4) largejumpall = 1.0e2;    //Every 1e4 iterations, take a 100x larger jump in all parameters
-	
-  for(p=0;p<mcmc->nMCMCpar;p++) if(mcmc->parFix[p]==0) mcmc->nParam[tempi][p] = mcmc->param[tempi][p];	
-	
-  p=(int)gsl_rng_uniform_int(mcmc->ran,mcmc->nMCMCpar);
-  while(mcmc->parFix[p]!=0) p=(int)gsl_rng_uniform_int(mcmc->ran,mcmc->nMCMCpar); //random parameter for which we propose a jump
-      
-      mcmc->nParam[tempi][p] = mcmc->param[tempi][p] + gsl_ran_gaussian(mcmc->ran,mcmc->adaptSigma[tempi][p]) * largejumpall;
-      
-      /*
-      //Testing with sky position/orientation updates
-      if(p==6  && gsl_rng_uniform(mcmc->ran) < 0.3) mcmc->nParam[tempi][6]  = fmod(mcmc->nParam[tempi][6]+pi,tpi);  //Move RA over 12h
-      if(p==7  && gsl_rng_uniform(mcmc->ran) < 0.3) mcmc->nParam[tempi][7]  *= -1.0;                                //Flip declination
-      if(p==9  && gsl_rng_uniform(mcmc->ran) < 0.3) mcmc->nParam[tempi][9]  *= -1.0;                                //Flip theta_Jo
-      if(p==10 && gsl_rng_uniform(mcmc->ran) < 0.3) mcmc->nParam[tempi][10] = fmod(mcmc->nParam[tempi][10]+pi,tpi); //Move phi_Jo over 12h
-      */
-      
-      mcmc->acceptPrior[tempi] = (int)prior(&mcmc->nParam[tempi][p],p,*mcmc);
-      
-      if(mcmc->acceptPrior[tempi]==1) {
-        arr2par(mcmc->nParam, state, *mcmc);                                            //Get the parameters from their array
-        int injectionWF = 0;                                                 // Call netLogLikelihood with an MCMC waveform
-        localPar(state, ifo, mcmc->networkSize, injectionWF, run);
-        mcmc->nlogL[tempi] = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, run);   //Calculate the likelihood
-        par2arr(*state, mcmc->nParam, *mcmc);                                           //Put the variables back in their array
-	
-        if(exp(max(-30.0,min(0.0,mcmc->nlogL[tempi]-mcmc->logL[tempi]))) > pow(gsl_rng_uniform(mcmc->ran),mcmc->chTemp) && mcmc->nlogL[tempi] > mcmc->minlogL) {  //Accept proposal
-          mcmc->param[tempi][p] = mcmc->nParam[tempi][p];
-          mcmc->logL[tempi] = mcmc->nlogL[tempi];
-          if(mcmc->adaptiveMCMC==1){
-            s_gamma = mcmc->adaptScale[tempi][p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
-            mcmc->adaptSigma[tempi][p] = max(0.0,mcmc->adaptSigma[tempi][p] + s_gamma*(1.0 - mcmc->acceptRateTarget)); //Accept - increase sigma
-            sigmaPeriodicBoundaries(mcmc->adaptSigma[tempi][p], p, *mcmc);              //Bring the sigma between 0 and 2pi
-          }
-          mcmc->accepted[tempi][p] += 1;
-        } else {                                                                        //Reject proposal
-          mcmc->nParam[tempi][p] = mcmc->param[tempi][p];
-          if(mcmc->adaptiveMCMC==1){
-            s_gamma = mcmc->adaptScale[tempi][p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
-            mcmc->adaptSigma[tempi][p] = max(0.0,mcmc->adaptSigma[tempi][p] - s_gamma*mcmc->acceptRateTarget); //Reject - decrease sigma
-            sigmaPeriodicBoundaries(mcmc->adaptSigma[tempi][p], p, *mcmc);              //Bring the sigma between 0 and 2pi
-            //mcmc->adaptSigma[tempi][p] = max(0.01*mcmc->adaptSigma[tempi][p], mcmc->adaptSigma[tempi][p] - s_gamma*mcmc->acceptRateTarget);
-          }
-        }
-      } else {  //If new state not within boundaries
-        mcmc->nParam[tempi][p] = mcmc->param[tempi][p];
-        if(mcmc->adaptiveMCMC==1) {
-          s_gamma = mcmc->adaptScale[tempi][p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
-          mcmc->adaptSigma[tempi][p] = max(0.0,mcmc->adaptSigma[tempi][p] - s_gamma*mcmc->acceptRateTarget);   //Reject - decrease sigma
-          sigmaPeriodicBoundaries(mcmc->adaptSigma[tempi][p], p, *mcmc);                                     //Bring the sigma between 0 and 2pi
-        }
-      } //if(mcmc->acceptPrior[tempi]==1)
-    mcmc->adaptSigmaOut[tempi][p] = mcmc->adaptSigma[tempi][p]; //Save sigma for output
 
+  for(k=0;k<mcmc->nParFit;k++) chain->nParam[mcmc->parFree[k]] = chain->param[mcmc->parFree[k]];
+
+  p = mcmc->parFree[gsl_rng_uniform_int(chain->ran,mcmc->nParFit)];  //random free parameter for which we propose a jump
+
+  chain->nParam[p] = chain->param[p] + gsl_ran_gaussian(chain->ran,chain->adaptSigma[p]) * largejumpall;
+
+  /*
+  //Testing with sky position/orientation updates
+  if(p==6  && gsl_rng_uniform(chain->ran) < 0.3) chain->nParam[6]  = fmod(chain->nParam[6]+pi,tpi);  //Move RA over 12h
+  if(p==7  && gsl_rng_uniform(chain->ran) < 0.3) chain->nParam[7]  *= -1.0;                                //Flip declination
+  if(p==9  && gsl_rng_uniform(chain->ran) < 0.3) chain->nParam[9]  *= -1.0;                                //Flip theta_Jo
+  if(p==10 && gsl_rng_uniform(chain->ran) < 0.3) chain->nParam[10] = fmod(chain->nParam[10]+pi,tpi); //Move phi_Jo over 12h
+  */
+
+  chain->acceptPrior = (int)prior(&chain->nParam[p],p,mcmc);
+
+  if(chain->acceptPrior==1) {
+    chain->nlogL = proposalLogLikelihood(ifo, state, mcmc, chain, likePar, p);     //Calculate the likelihood;  only parameter p has changed
+
+    if(exp(max(-30.0,min(0.0,chain->nlogL-chain->logL))) > pow(gsl_rng_uniform(chain->ran),chain->chTemp) && chain->nlogL > mcmc->minlogL) {  //Accept proposal
+      chain->param[p] = chain->nParam[p];
+      chain->logL = chain->nlogL;
+      storeOverlapCache(mcmc, chain);
+      if(mcmc->adaptiveMCMC==1){
+        s_gamma = chain->adaptScale[p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
+        chain->adaptSigma[p] = max(0.0,chain->adaptSigma[p] + s_gamma*(1.0 - mcmc->acceptRateTarget)); //Accept - increase sigma
+        sigmaPeriodicBoundaries(chain->adaptSigma[p], p, mcmc);              //Bring the sigma between 0 and 2pi
+      }
+      chain->accepted[p] += 1;
+    } else {                                                                        //Reject proposal
+      chain->nParam[p] = chain->param[p];
+      if(mcmc->adaptiveMCMC==1){
+        s_gamma = chain->adaptScale[p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
+        chain->adaptSigma[p] = max(0.0,chain->adaptSigma[p] - s_gamma*mcmc->acceptRateTarget); //Reject - decrease sigma
+        sigmaPeriodicBoundaries(chain->adaptSigma[p], p, mcmc);              //Bring the sigma between 0 and 2pi
+        //chain->adaptSigma[p] = max(0.01*chain->adaptSigma[p], chain->adaptSigma[p] - s_gamma*mcmc->acceptRateTarget);
+      }
+    }
+  } else {  //If new state not within boundaries
+    chain->nParam[p] = chain->param[p];
+    if(mcmc->adaptiveMCMC==1) {
+      s_gamma = chain->adaptScale[p]*pow(1.0/((double)(mcmc->iIter+1)),1.0/6.0);
+      chain->adaptSigma[p] = max(0.0,chain->adaptSigma[p] - s_gamma*mcmc->acceptRateTarget);   //Reject - decrease sigma
+      sigmaPeriodicBoundaries(chain->adaptSigma[p], p, mcmc);                                     //Bring the sigma between 0 and 2pi
+    }
+  } //if(chain->acceptPrior==1)
+  chain->adaptSigmaOut[p] = chain->adaptSigma[p]; //Save sigma for output
 } // End uncorrelatedMCMCsingleUpdate
 // ****************************************************************************************************************************************************  
 
@@ -761,45 +1111,40 @@ void uncorrelatedMCMCsingleUpdate(struct interferometer *ifo[], struct parSet *s
  * No adaptation here, some experimenting with larger jumps every now and then.
  */
 // ****************************************************************************************************************************************************  
-void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, struct runPar run)
+void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
 // ****************************************************************************************************************************************************  
 {
-  int p=0;
+  int p=0, k=0;
   double ran=0.0, largejump1=0.0, largejumpall=0.0;
   
   largejumpall = 1.0;
-  ran = gsl_rng_uniform(mcmc->ran);
+  ran = gsl_rng_uniform(chain->ran);
   if(ran < 1.0e-3) largejumpall = 1.0e1;    //Every 1e3 iterations, take a 10x larger jump in all parameters
   if(ran < 1.0e-4) largejumpall = 1.0e2;    //Every 1e4 iterations, take a 100x larger jump in all parameters
   
-  mcmc->acceptPrior[mcmc->iTemp] = 1;
-  for(p=0;p<mcmc->nMCMCpar;p++){
-    if(mcmc->parFix[p]==0) {
-      largejump1 = 1.0;
-      ran = gsl_rng_uniform(mcmc->ran);
-      if(ran < 1.0e-2) largejump1 = 1.0e1;    //Every 1e2 iterations, take a 10x larger jump in this parameter
-      if(ran < 1.0e-3) largejump1 = 1.0e2;    //Every 1e3 iterations, take a 100x larger jump in this parameter
-      
-      mcmc->nParam[mcmc->iTemp][p] = mcmc->param[mcmc->iTemp][p] + gsl_ran_gaussian(mcmc->ran,mcmc->adaptSigma[mcmc->iTemp][p]) * largejump1 * largejumpall;
-      mcmc->acceptPrior[mcmc->iTemp] *= (int)prior(&mcmc->nParam[mcmc->iTemp][p],p,*mcmc);
-    }
+  chain->acceptPrior = 1;
+  for(k=0;k<mcmc->nParFit;k++){
+    p = mcmc->parFree[k];
+    largejump1 = 1.0;
+    ran = gsl_rng_uniform(chain->ran);
+    if(ran < 1.0e-2) largejump1 = 1.0e1;    //Every 1e2 iterations, take a 10x larger jump in this parameter
+    if(ran < 1.0e-3) largejump1 = 1.0e2;    //Every 1e3 iterations, take a 100x larger jump in this parameter
+    
+    chain->nParam[p] = chain->param[p] + gsl_ran_gaussian(chain->ran,chain->adaptSigma[p]) * largejump1 * largejumpall;
+    chain->acceptPrior *= (int)prior(&chain->nParam[p],p,mcmc);
   }
   
-  if(mcmc->acceptPrior[mcmc->iTemp]==1) {
-    arr2par(mcmc->nParam, state, *mcmc);                                      //Get the parameters from their array
-    int injectionWF = 0;                                                 // Call netLogLikelihood with an MCMC waveform
-    localPar(state, ifo, mcmc->networkSize, injectionWF, run);                               //Calculate local variables
-    mcmc->nlogL[mcmc->iTemp] = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, run);  //Calculate the likelihood
-    par2arr(*state, mcmc->nParam, *mcmc);                                     //Put the variables back in their array
+  if(chain->acceptPrior==1) {
+    chain->nlogL = proposalLogLikelihood(ifo, state, mcmc, chain, likePar, -1);  //Calculate the likelihood
     
-    if(exp(max(-30.0,min(0.0,mcmc->nlogL[mcmc->iTemp]-mcmc->logL[mcmc->iTemp]))) > pow(gsl_rng_uniform(mcmc->ran),mcmc->chTemp) && mcmc->nlogL[mcmc->iTemp] > mcmc->minlogL){  //Accept proposal if L>Lo
-      for(p=0;p<mcmc->nMCMCpar;p++){
-        if(mcmc->parFix[p]==0) {
-          mcmc->param[mcmc->iTemp][p] = mcmc->nParam[mcmc->iTemp][p];
-          mcmc->accepted[mcmc->iTemp][p] += 1;
-        }
+    if(exp(max(-30.0,min(0.0,chain->nlogL-chain->logL))) > pow(gsl_rng_uniform(chain->ran),chain->chTemp) && chain->nlogL > mcmc->minlogL){  //Accept proposal if L>Lo
+      for(k=0;k<mcmc->nParFit;k++){
+        p = mcmc->parFree[k];
+        chain->param[p] = chain->nParam[p];
+        chain->accepted[p] += 1;
       }
-      mcmc->logL[mcmc->iTemp] = mcmc->nlogL[mcmc->iTemp];
+      chain->logL = chain->nlogL;
+      storeOverlapCache(mcmc, chain);
     }
   }
 } // End uncorrelatedMCMCblockUpdate
@@ -810,14 +1155,77 @@ void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *st
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Do a differential-evolution update for the current T chain
+ *
+ * Propose x' = x + gamma (z1 - z2) + e, with z1 and z2 two different earlier states of the chain from its history (see storeDEhistory()),
+ * gamma = 2.38/sqrt(2 nParFit) and a small Gaussian e.  Once every ten updates gamma = 1, which allows jumps between modes.  The proposal
+ * follows the correlations between the parameters without a covariance matrix, and is symmetric, since z1 and z2 are as likely to be 
+ * drawn the other way around.
+ */
+// ****************************************************************************************************************************************************  
+void differentialEvolutionMCMCupdate(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
+{
+  int p=0, k=0, i1=0, i2=0, nFree=mcmc->nParFit;
+  double gamma=0.0, *z1=NULL, *z2=NULL;
+  
+  i1 = gsl_rng_uniform_int(chain->ran, chain->deN);        // Two different states from the history
+  i2 = gsl_rng_uniform_int(chain->ran, chain->deN-1);
+  if(i2>=i1) i2 += 1;
+  z1 = &chain->deHist[i1*nFree];
+  z2 = &chain->deHist[i2*nFree];
+  
+  gamma = 2.38/sqrt(2.0*(double)nFree);
+  if(gsl_rng_uniform(chain->ran) < 0.1) gamma = 1.0;                // Jump between modes
+  
+  chain->acceptPrior = 1;
+  for(k=0;k<nFree;k++) {
+    p = mcmc->parFree[k];
+    chain->nParam[p] = chain->param[p] + gamma*(z1[k]-z2[k]) + gsl_ran_gaussian(chain->ran, 1.e-4*mcmc->parSigma[p]);
+    chain->acceptPrior *= (int)prior(&chain->nParam[p],p,mcmc);
+  }
+  
+  if(chain->acceptPrior==1) {
+    chain->nlogL = proposalLogLikelihood(ifo, state, mcmc, chain, likePar, -1);  //Calculate the likelihood
+    
+    if(exp(max(-30.0,min(0.0,chain->nlogL-chain->logL))) > pow(gsl_rng_uniform(chain->ran),chain->chTemp) && chain->nlogL > mcmc->minlogL){  //Accept proposal
+      for(k=0;k<nFree;k++){
+        p = mcmc->parFree[k];
+        chain->param[p] = chain->nParam[p];
+        chain->accepted[p] += 1;
+      }
+      chain->logL = chain->nlogL;
+      storeOverlapCache(mcmc, chain);
+    }
+  }
+} // End differentialEvolutionMCMCupdate()
+// ****************************************************************************************************************************************************  
 
 
 
-
-
-
-
-
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Store the current state of the chain in its differential-evolution history
+ *
+ * The history is a ring buffer of the free parameters of the latest deHistorySize stored states, so that its memory does not grow
+ * during long runs.  Only every deHistoryThin-th iteration is stored, so that the states in the buffer are less correlated.
+ */
+// ****************************************************************************************************************************************************  
+void storeDEhistory(const struct MCMCvariables *mcmc, struct MCMCchain *chain)
+{
+  int k=0;
+  double *z = NULL;
+  
+  if((mcmc->iIter % deHistoryThin)!=0) return;
+  
+  z = &chain->deHist[chain->deNext*mcmc->nParFit];
+  for(k=0;k<mcmc->nParFit;k++) z[k] = chain->param[mcmc->parFree[k]];
+  
+  chain->deNext = (chain->deNext+1) % deHistorySize;
+  chain->deN = min(chain->deN+1, deHistorySize);
+} // End storeDEhistory()
+// ****************************************************************************************************************************************************  
 
 
 
@@ -826,55 +1234,557 @@ void uncorrelatedMCMCblockUpdate(struct interferometer *ifo[], struct parSet *st
 
 // ****************************************************************************************************************************************************  
 /**
- * \brief Write MCMC header to screen and file
+ * \brief Compute the log(Likelihood) of the proposal in chain->nParam
  *
+ * If only the distance parameter has changed (p = mcmc->distParIndex) and the overlaps <d|h> and <h|h> of the current state are cached,
+ * rescale them rather than computing a new template:  h scales as 1/d_L, hence log(L) = s<d|h> - s^2<h|h>/2, with s = d_L,old/d_L,new.
+ * Else, if mcmc->extrinsicCache==1, compute the likelihood from a cached intrinsic template (see extrinsicLogLikelihood()).  Each chain
+ * caches two:  that of the current state, and that of a recent proposal, which becomes the current one when such a proposal is accepted
+ * (see storeOverlapCache()).  A proposal that changes extrinsic parameters only hence needs no new template, and one that changes intrinsic
+ * parameters costs one template, as without the cache.
+ * Otherwise, compute the template and likelihood in full.  p is the only parameter that differs from the current state, or -1 if 
+ * several (may) have changed.  The overlaps of the proposal are stored in chain->nOverlapHD,HH;  see storeOverlapCache().
+ * If mcmc->likelihoodCache==2, or when compiled with SPINSPIRAL_CHECKS, every cached likelihood is checked against a full computation.
  */
 // ****************************************************************************************************************************************************  
-void writeMCMCheader(struct interferometer *ifo[], struct MCMCvariables mcmc, struct runPar run)
-// ****************************************************************************************************************************************************  
+double proposalLogLikelihood(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar, int p)
 {
-  int i=0, tempi=0;
-  // *** Print run parameters to screen ***
-  if(mcmc.offsetMCMC==0) printf("   Starting MCMC from the true initial parameters\n\n");
-  if(mcmc.offsetMCMC>=1) printf("   Starting MCMC from offset initial parameters\n\n");
+  int i=0, useCache=0, slot=0;
+  int injectionWF = 0;                                                             // Call netLogLikelihood with an MCMC waveform
+  int verify = (mcmc->likelihoodCache==2);                                         // Check the cached likelihoods against full computations
+  double logL=0.0, scale=1.0;
+  long nAlloc = heapAllocations();                                                 // Runtime checks:  the likelihood should not allocate
+#ifdef SPINSPIRAL_CHECKS
+  verify = 1;
+#endif
   
-  // *** Open the output file and write run parameters in the header ***
-  for(tempi=0;tempi<mcmc.nTemps;tempi++) {
-    if(tempi==0 || mcmc.saveHotChains>0) {
-      fprintf(mcmc.fouts[tempi], "  SPINspiral version:%8.2f\n\n",1.0);
-      fprintf(mcmc.fouts[tempi], "%10s  %10s  %6s  %20s  %6s %8s   %6s  %8s  %10s  %12s  %9s  %9s  %8s\n",
-              "nIter","Nburn","seed","null likelihood","Ndet","nCorr","nTemps","Tmax","Tchain","Network SNR","Waveform","pN order","Npar");
-      fprintf(mcmc.fouts[tempi], "%10d  %10d  %6d  %20.10lf  %6d %8d   %6d%10d%12.1f%14.6f  %9i  %9.1f  %8i\n",
-              mcmc.nIter,mcmc.annealNburn,mcmc.seed,0.0,run.networkSize,mcmc.nCorr,mcmc.nTemps,(int)mcmc.maxTemp,mcmc.tempLadder[tempi],run.netsnr,run.mcmcWaveform,run.mcmcPNorder,run.nMCMCpar);
-      fprintf(mcmc.fouts[tempi], "\n%16s  %16s  %10s  %10s  %10s  %10s  %20s  %15s  %12s  %12s  %12s\n",
-              "Detector","SNR","f_low","f_high","before tc","after tc","Sample start (GPS)","Sample length","Sample rate","Sample size","FT size");
-      for(i=0;i<run.networkSize;i++) {
-        fprintf(mcmc.fouts[tempi], "%16s  %16.8lf  %10.2lf  %10.2lf  %10.2lf  %10.2lf  %20.8lf  %15.7lf  %12d  %12d  %12d\n",
-                ifo[i]->name,ifo[i]->snr,ifo[i]->lowCut,ifo[i]->highCut,ifo[i]->before_tc,ifo[i]->after_tc,
-                ifo[i]->FTstart,ifo[i]->deltaFT,ifo[i]->samplerate,ifo[i]->samplesize,ifo[i]->FTsize);
+  // Can the cached overlaps of the current state be used?
+  if(p>=0 && p==mcmc->distParIndex && chain->cacheValid==1) {
+    useCache = 1;
+    for(i=0;i<mcmc->nMCMCpar;i++) {
+      if(chain->cachePar[i] != chain->param[i] || (i!=p && chain->nParam[i] != chain->param[i])) {
+        useCache = 0;
+        break;
       }
-      
+    }
+  }
+  
+  if(useCache==1) {
+    if(mcmc->distParID==22) {
+      scale = exp(chain->cachePar[p] - chain->nParam[p]);                           // 22: log(d_L)
+    } else {
+      scale = pow(chain->cachePar[p] / chain->nParam[p], c3rd);                     // 21: d_L^3
+    }
+    chain->nOverlapHD = scale*chain->cacheHD;
+    chain->nOverlapHH = scale*scale*chain->cacheHH;
+    logL = chain->nOverlapHD - 0.5*chain->nOverlapHH;
+    
+    if(verify==1) {                                                                // Debug mode: compare to the full computation
+      double overlaphd=0.0, overlaphh=0.0, fullLogL=0.0;
+      arr2par(chain->nParam, state, mcmc);
+      localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+      fullLogL = netLogLikelihoodOverlaps(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar, &overlaphd, &overlaphh);
+      par2arr(state, chain->nParam, mcmc);
+      if(fabs(fullLogL-logL) > 1.e-5*max(1.0,overlaphh)) {                        // LAL templates are single precision
+        printf("\n ***  Warning:  proposalLogLikelihood(): cached log(L) = %g differs from full log(L) = %g  (d_L scale factor %g) ***\n\n",
+               logL,fullLogL,scale);
+      }
+    }
+    
+  } else if(mcmc->extrinsicCache==1) {
+    // Find the cached intrinsic template with the intrinsic parameters of the proposal.  If there is none, compute it, in the slot of the
+    //   current state if that is out of date (as after a swap or the first proposal), otherwise in the other slot:
+    slot = intrinsicCacheSlot(mcmc, chain, chain->nParam);
+    arr2par(chain->nParam, state, mcmc);
+    if(slot<0) {
+      slot = chain->intrinsicCacheCur;
+      if(intrinsicCacheSlot(mcmc, chain, chain->param) == slot) slot = 1-slot;
+      intrinsicTemplateCache(state, ifo, mcmc->networkSize, mcmc->mcmcWaveform, likePar, 
+                             &chain->intrinsicCacheDH[slot*2*mcmc->intrinsicBins], &chain->intrinsicCacheHH[slot*mcmc->networkSize]);
+      for(i=0;i<mcmc->nMCMCpar;i++) chain->intrinsicCachePar[slot*mcmc->nMCMCpar+i] = chain->nParam[i];
+      chain->intrinsicCacheValid[slot] = 1;
+    }
+    
+    localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+    logL = extrinsicLogLikelihood(state, ifo, mcmc->networkSize, mcmc->mcmcWaveform, likePar, 
+                                  &chain->intrinsicCacheDH[slot*2*mcmc->intrinsicBins], &chain->intrinsicCacheHH[slot*mcmc->networkSize],
+                                  &chain->nOverlapHD, &chain->nOverlapHH);
+    
+    if(verify==1) {                                                                // Debug mode: compare to the full computation
+      double overlaphd=0.0, overlaphh=0.0, fullLogL=0.0;
+      fullLogL = netLogLikelihoodOverlaps(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar, &overlaphd, &overlaphh);
+      if(fabs(fullLogL-logL) > 1.e-8*max(1.0,overlaphh)) {
+        printf("\n ***  Warning:  proposalLogLikelihood(): log(L) = %g from the cached intrinsic template differs from full log(L) = %g ***\n\n",
+               logL,fullLogL);
+      }
+    }
+    par2arr(state, chain->nParam, mcmc);
+    
+  } else {
+    arr2par(chain->nParam, state, mcmc);                                            //Get the parameters from their array
+    localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);                  //Calculate local variables
+    if(mcmc->distParIndex>=0) {
+      logL = netLogLikelihoodOverlaps(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar, &chain->nOverlapHD, &chain->nOverlapHH);
+    } else {
+      logL = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar);
+    }
+    par2arr(state, chain->nParam, mcmc);                                            //Put the variables back in their array
+  }
+  
+  chain->likelihoodAllocations += heapAllocations() - nAlloc;
+  return logL;
+} // End proposalLogLikelihood
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Store the overlaps of an accepted proposal as the cached overlaps of the current state of the chain
+ */
+// ****************************************************************************************************************************************************  
+void storeOverlapCache(const struct MCMCvariables *mcmc, struct MCMCchain *chain)
+{
+  int i=0, slot=0;
+  
+  // The intrinsic template of the accepted proposal is cached in one of the two slots (see proposalLogLikelihood()):
+  if(mcmc->extrinsicCache==1) {
+    slot = intrinsicCacheSlot(mcmc, chain, chain->param);
+    if(slot>=0) chain->intrinsicCacheCur = slot;
+  }
+  
+  if(mcmc->distParIndex<0) return;
+  
+  chain->cacheHD = chain->nOverlapHD;
+  chain->cacheHH = chain->nOverlapHH;
+  for(i=0;i<mcmc->nMCMCpar;i++) chain->cachePar[i] = chain->param[i];
+  chain->cacheValid = 1;
+} // End storeOverlapCache
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the slot (0,1) of the cached intrinsic template with the intrinsic parameters in param, or -1 if neither has them
+ */
+// ****************************************************************************************************************************************************  
+int intrinsicCacheSlot(const struct MCMCvariables *mcmc, const struct MCMCchain *chain, const double *param)
+{
+  int i=0, slot=0, match=0;
+  
+  for(slot=0;slot<2;slot++) {
+    if(chain->intrinsicCacheValid[slot]==0) continue;
+    match = 1;
+    for(i=0;i<mcmc->nMCMCpar;i++) {
+      if(mcmc->parExtrinsic[i]==0 && chain->intrinsicCachePar[slot*mcmc->nMCMCpar+i] != param[i]) {
+        match = 0;
+        break;
+      }
+    }
+    if(match==1) return slot;
+  }
+  return -1;
+} // End intrinsicCacheSlot
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the relative-binning summary data around the fiducial MCMC parameters fidParam
+ */
+// ****************************************************************************************************************************************************  
+void setRelativeBinningFiducial(struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct likelihoodPar *likePar, const double *fidParam)
+{
+  int i=0;
+  int injectionWF = 0;                                                             // The fiducial template is an MCMC template
+  struct parSet fidPar;
+  
+  allocParset(&fidPar, mcmc->networkSize);
+  for(i=0;i<mcmc->nMCMCpar;i++) fidPar.par[i] = fidParam[i];
+  fidPar.nPar = mcmc->nMCMCpar;
+  
+  localPar(&fidPar, ifo, mcmc->networkSize, injectionWF, likePar);
+  relativeBinningSummaryData(&fidPar, mcmc->networkSize, ifo, mcmc->mcmcWaveform, likePar);
+  freeParset(&fidPar);
+  
+  if(mcmc->beVerbose>=1) printf("   Relative binning:  computed the summary data for %d bins around a fiducial template.\n",ifo[0]->relBinN);
+} // End setRelativeBinningFiducial
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Choose the knot spacing of the multirate template, so that it agrees with the full-rate template to likePar->multirateAccuracy
+ *
+ * The spacing, in GW cycles, is halved from 16 until the relative L2 difference between the multirate and full-rate templates with 
+ * parameters refParam is below the accuracy for all detectors;  coarser knots miss the precession (relative errors of 0.02 or more).
+ * Only the Apostolatos template (waveformVersion 1) has a multirate version.
+ */
+// ****************************************************************************************************************************************************  
+void setMultirateTemplate(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct likelihoodPar *likePar, const double *refParam)
+{
+  int i=0, ifonr=0;
+  int injectionWF = 0;                                                             // Multirate templates are MCMC templates
+  double cycles=0.0, err=0.0, maxErr=0.0, norm=0.0;
+  double **fullRate;
+  struct parSet refPar;
+  
+  likePar->multirateCycles = 0.0;
+  if(!waveformCapability(mcmc->mcmcWaveform, wfMultirate)) {
+    fprintf(stderr, "\n ***  Warning:  the multirate template is not available for waveformVersion %d;  computing all samples ***\n\n", mcmc->mcmcWaveform);
+    return;
+  }
+  
+  allocParset(&refPar, mcmc->networkSize);
+  for(i=0;i<mcmc->nMCMCpar;i++) refPar.par[i] = refParam[i];
+  refPar.nPar = mcmc->nMCMCpar;
+  localPar(&refPar, ifo, mcmc->networkSize, injectionWF, likePar);
+  
+  // Full-rate reference templates:
+  fullRate = (double**)calloc(mcmc->networkSize,sizeof(double*));
+  for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) {
+    waveformTemplate(&refPar, ifo, ifonr, mcmc->mcmcWaveform, injectionWF, likePar);
+    fullRate[ifonr] = (double*)malloc(sizeof(double)*ifo[ifonr]->samplesize);
+    for(i=0;i<ifo[ifonr]->samplesize;i++) fullRate[ifonr][i] = ifo[ifonr]->FTin[i];
+  }
+  
+  for(cycles=16.0; cycles>=0.124; cycles*=0.5) {
+    likePar->multirateCycles = cycles;
+    maxErr = 0.0;
+    for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) {
+      waveformTemplate(&refPar, ifo, ifonr, mcmc->mcmcWaveform, injectionWF, likePar);
+      err = 0.0;
+      norm = 0.0;
+      for(i=0;i<ifo[ifonr]->samplesize;i++) {
+        err  += (ifo[ifonr]->FTin[i]-fullRate[ifonr][i])*(ifo[ifonr]->FTin[i]-fullRate[ifonr][i]);
+        norm += fullRate[ifonr][i]*fullRate[ifonr][i];
+      }
+      if(norm > 0.0) maxErr = max(maxErr, sqrt(err/norm));
+    }
+    if(mcmc->beVerbose>=2) printf("   Multirate template:  knots every %g GW cycles,  relative error %.3e\n",cycles,maxErr);
+    if(maxErr <= likePar->multirateAccuracy) break;
+  }
+  
+  if(maxErr > likePar->multirateAccuracy) {
+    fprintf(stderr, "\n ***  Warning:  the multirate template does not reach an accuracy of %g;  computing all samples ***\n\n",likePar->multirateAccuracy);
+    likePar->multirateCycles = 0.0;
+  } else if(mcmc->beVerbose>=1) {
+    printf("   Multirate template:  knots every %g GW cycles for a relative error of %.3e.\n",likePar->multirateCycles,maxErr);
+  }
+  
+  for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) free(fullRate[ifonr]);
+  free(fullRate);
+  freeParset(&refPar);
+} // End setMultirateTemplate
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Check the relative-binning likelihood of the T=1 chain against the full likelihood
+ *
+ * If the two differ by more than mcmc->relBinTolerance, recompute the summary data around the best parameters of the T=1 chain 
+ * so far, and recompute the likelihoods of all chains with the new summary data.
+ */
+// ****************************************************************************************************************************************************  
+void checkRelativeBinning(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, const struct likelihoodPar *likePar)
+{
+  int i=0, ifonr=0, tempi=0;
+  int injectionWF = 0;                                                             // Call netLogLikelihood with an MCMC waveform
+  double fullLogL=0.0;
+  
+  // Full likelihood of the current state of the T=1 chain:
+  for(i=0;i<mcmc->nMCMCpar;i++) state->par[i] = mcmc->chain[0].param[i];
+  localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+  for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) ifo[ifonr]->relBinUse = 0;
+  fullLogL = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar);
+  for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) ifo[ifonr]->relBinUse = 1;
+  
+  if(mcmc->beVerbose>=2) printf("   Relative binning:  iteration %d,  log(L) = %.4f,  full log(L) = %.4f\n",mcmc->iIter,mcmc->chain[0].logL,fullLogL);
+  if(fabs(fullLogL-mcmc->chain[0].logL) <= mcmc->relBinTolerance || mcmc->chain[0].maxdlogL < -1.e29) return;
+  
+  
+  // Recompute the summary data around the best parameters so far, and the likelihoods of the current states:
+  if(mcmc->beVerbose>=1) printf("   Relative binning:  log(L) = %.4f differs from the full log(L) = %.4f at iteration %d;  recomputing the summary data.\n",
+                                mcmc->chain[0].logL,fullLogL,mcmc->iIter);
+  setRelativeBinningFiducial(ifo, mcmc, likePar, mcmc->chain[0].maxLparam);
+  
+  for(tempi=0;tempi<mcmc->nTemps;tempi++) {
+    for(i=0;i<mcmc->nMCMCpar;i++) state->par[i] = mcmc->chain[tempi].param[i];
+    localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+    mcmc->chain[tempi].logL = netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar);
+    mcmc->chain[tempi].cacheValid = 0;                                             // The cached overlaps were computed with the old summary data
+  }
+} // End checkRelativeBinning
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Add the conditional posterior of t_c for the current state of the T=1 chain to mcmc->tMargPost
+ *
+ * When the likelihood is marginalised over t_c, the chain does not sample t_c.  Its posterior is recovered by averaging
+ * L(t_c | other parameters), normalised over the prior range, over the saved states (Rao-Blackwellisation).
+ */
+// ****************************************************************************************************************************************************  
+void accumulateTimePosterior(struct interferometer *ifo[], struct parSet *state, struct MCMCvariables *mcmc, const struct likelihoodPar *likePar)
+{
+  int i=0, n=0, m=0, nLow=0, nUp=0;
+  int N = ifo[0]->tMargN;
+  int injectionWF = 0;                                                             // Call netLogLikelihood with an MCMC waveform
+  double maxhd=-1.e30, sum=0.0;
+  
+  // Fill ifo[0]->tMargOut for the current state:
+  for(i=0;i<mcmc->nMCMCpar;i++) state->par[i] = mcmc->chain[0].param[i];
+  localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+  netLogLikelihood(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar);
+  timeShiftRange(state, ifo[0], likePar, &nLow, &nUp);
+  
+  if(mcmc->tMargPost==NULL) {                                                      // t_c is fixed, so the range doesn't change
+    mcmc->tMargPostLow = nLow;
+    mcmc->tMargPostN = nUp-nLow+1;
+    mcmc->tMargPost = (double*)calloc(mcmc->tMargPostN,sizeof(double));
+  }
+  
+  for(n=nLow; n<=nUp; n++) {
+    m = ((n%N)+N)%N;
+    if(creal(ifo[0]->tMargOut[m]) > maxhd) maxhd = creal(ifo[0]->tMargOut[m]);
+  }
+  for(n=nLow; n<=nUp; n++) {
+    m = ((n%N)+N)%N;
+    sum += exp(creal(ifo[0]->tMargOut[m]) - maxhd);
+  }
+  for(n=nLow; n<=nUp; n++) {
+    m = ((n%N)+N)%N;
+    i = n - mcmc->tMargPostLow;
+    if(i>=0 && i<mcmc->tMargPostN) mcmc->tMargPost[i] += exp(creal(ifo[0]->tMargOut[m]) - maxhd)/sum;
+  }
+  mcmc->tMargPostCount += 1;
+  
+} // End accumulateTimePosterior
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Write the posterior of t_c from the time-marginalised likelihood to SPINspiral.output.<seed>.tc
+ */
+// ****************************************************************************************************************************************************  
+void writeTimePosterior(const struct MCMCvariables *mcmc, struct interferometer *ifo[], const char *outputPath)
+{
+  int i=0;
+  double dt = ifo[0]->deltaFT/(double)ifo[0]->tMargN;
+  double tc0 = mcmc->chain[0].param[mcmc->parRevID[11]];
+  char outfileName[99];
+  char outfilePath[512];
+  FILE *fout;
+  
+  if(outputPath) {
+    strcpy(outfilePath,outputPath);
+  } else {
+    sprintf(outfilePath,"./");
+  }
+  sprintf(outfileName,"SPINspiral.output.%6.6d.tc",mcmc->seed);
+  strcat(outfilePath,outfileName);
+  fout = fopen(outfilePath,"w");
+  if(fout == NULL) {
+    fprintf(stderr, "\n ***  Warning:  could not create the t_c posterior file %s ***\n\n",outfilePath);
+    return;
+  }
+  
+  fprintf(fout, "%% Posterior of t_c from the time-marginalised likelihood, averaged over %d states\n",mcmc->tMargPostCount);
+  fprintf(fout, "%%%19s %15s\n","t_c","density");
+  for(i=0;i<mcmc->tMargPostN;i++) {
+    fprintf(fout, "%20.6f %15.6e\n", tc0 + (double)(mcmc->tMargPostLow+i)*dt, mcmc->tMargPost[i]/((double)mcmc->tMargPostCount*dt));
+  }
+  fclose(fout);
+  
+  if(mcmc->beVerbose>=1) printf("   Time-marginalised likelihood:  the posterior of t_c was written to %s\n",outfilePath);
+} // End writeTimePosterior
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Draw phi_c and/or d_L of the current state of the (T=1) chain from their posterior, conditional on the other parameters
+ *
+ * For the phase- and distance-marginalised likelihood.  The state in chain->param has the fixed reference values, which are 
+ * left in state->par;  chain->param gets the drawn values, so that they can be written to the output file.  The distance is 
+ * drawn from the lookup table (and uniformly in log(d_L) within its cell), then the phase from a von Mises distribution.  That 
+ * is the phase of the GW harmonic, m phi_c (see getWaveformBackend()):  phi_c follows by dividing by m, and adding a multiple of 
+ * 2 pi/m drawn uniformly, since the m values of phi_c in [0,2 pi) that give the same GW phase are equally likely.
+ */
+// ****************************************************************************************************************************************************  
+void drawPhaseDistance(struct interferometer *ifo[], struct parSet *state, const struct MCMCvariables *mcmc, struct MCMCchain *chain, const struct likelihoodPar *likePar)
+{
+  int i=0, ifonr=0;
+  int injectionWF = 0;                                                             // Call netLogLikelihood with an MCMC waveform
+  int margPhase = (mcmc->marginalisePhaseDist!=2);
+  int margDist = (mcmc->marginalisePhaseDist>=2);
+  double hd=0.0, hdImag=0.0, hh=0.0, absZ=0.0;
+  double d0=0.0, d=0.0, rho=1.0, maxLogP=-1.e30, sum=0.0, ran=0.0, dLogD=0.0, dPhi=0.0;
+  struct likelihoodPar refPar = *likePar;
+  
+  // Overlaps of the reference template;  the unmarginalised likelihood leaves the templates in the bands of ifo[]->FTout:
+  for(i=0;i<mcmc->nMCMCpar;i++) state->par[i] = chain->param[i];
+  localPar(state, ifo, mcmc->networkSize, injectionWF, likePar);
+  refPar.marginalisePhaseDist = 0;
+  netLogLikelihoodOverlaps(state, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, &refPar, &hd, &hh);
+  for(ifonr=0;ifonr<mcmc->networkSize;ifonr++) hdImag += bandOverlapImag(ifo[ifonr]);
+  absZ = sqrt(hd*hd + hdImag*hdImag);
+  
+  // Distance:
+  if(margDist) {
+    double *logP = (double*)malloc(sizeof(double) * likePar->distMargN);
+    d0 = templateDistance(state, likePar);
+    for(i=0;i<likePar->distMargN;i++) {
+      rho = d0/likePar->distMargD[i];
+      logP[i] = (margPhase ? logBesselI0(rho*absZ) : rho*hd) - 0.5*rho*rho*hh + likePar->distMargLogW[i];
+      maxLogP = max(maxLogP, logP[i]);
+    }
+    for(i=0;i<likePar->distMargN;i++) sum += exp(logP[i]-maxLogP);
+    ran = gsl_rng_uniform(chain->ran) * sum;
+    for(i=0;i<likePar->distMargN-1;i++) {
+      ran -= exp(logP[i]-maxLogP);
+      if(ran<=0.0) break;
+    }
+    free(logP);
+    
+    dLogD = log(likePar->distMargD[likePar->distMargN-1]/likePar->distMargD[0]) / (double)(likePar->distMargN-1);
+    d = likePar->distMargD[i] * exp((gsl_rng_uniform(chain->ran)-0.5)*dLogD);
+    rho = d0/d;
+    if(mcmc->parRevID[22]>=0) {
+      chain->param[mcmc->parRevID[22]] = log(d);                                 // 22: log(d_L)
+    } else {
+      chain->param[mcmc->parRevID[21]] = d*d*d;                                  // 21: d_L^3
+    }
+  }
+  
+  // Phase:  <d|h>(phi_c+dphi/m) = rho |Z| cos(dphi - arg Z),  a von Mises distribution in the GW phase dphi:
+  if(margPhase) {
+    int m = getWaveformBackend(mcmc->mcmcWaveform)->phaseFactor;
+    i = mcmc->parRevID[41];
+    dPhi = drawVonMises(chain->ran, atan2(hdImag,hd), rho*absZ);
+    if(m>1) dPhi = (dPhi + tpi*(double)gsl_rng_uniform_int(chain->ran, m)) / (double)m;   // GW phase -> phi_c
+    chain->param[i] = state->par[i] + dPhi;
+    while(chain->param[i] <  mcmc->priorBoundLow[i]) chain->param[i] += tpi;
+    while(chain->param[i] >= mcmc->priorBoundLow[i]+tpi) chain->param[i] -= tpi;
+  }
+  
+} // End drawPhaseDistance
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Draw a random number from a von Mises distribution with mean mu and concentration kappa
+ *
+ * Rejection method of Best & Fisher (1979).
+ */
+// ****************************************************************************************************************************************************  
+double drawVonMises(gsl_rng *ran, double mu, double kappa)
+{
+  double tau=0.0, rho=0.0, r=0.0, z=0.0, f=0.0, c=0.0, u2=0.0, theta=0.0;
+  
+  if(kappa < 1.e-6) return mu + tpi*(gsl_rng_uniform(ran)-0.5);                    // Flat
+  
+  tau = 1.0 + sqrt(1.0 + 4.0*kappa*kappa);
+  rho = (tau - sqrt(2.0*tau)) / (2.0*kappa);
+  r = (1.0 + rho*rho) / (2.0*rho);
+  
+  while(1) {
+    z = cos(pi*gsl_rng_uniform(ran));
+    f = (1.0 + r*z) / (r + z);
+    c = kappa * (r - f);
+    u2 = gsl_rng_uniform(ran);
+    if(c*(2.0-c) - u2 > 0.0 || log(c/u2) + 1.0 - c >= 0.0) break;
+  }
+  
+  theta = acos(f);
+  if(gsl_rng_uniform(ran) < 0.5) theta = -theta;
+  
+  return mu + theta;
+} // End drawVonMises
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Write MCMC header to screen and file
+ *
+ */
+// ****************************************************************************************************************************************************  
+void writeMCMCheader(struct interferometer *ifo[], const struct MCMCvariables *mcmc, struct runPar run)
+// ****************************************************************************************************************************************************  
+{
+  int i=0, tempi=0;
+  // *** Print run parameters to screen ***
+  if(mcmc->offsetMCMC==0) printf("   Starting MCMC from the true initial parameters\n\n");
+  if(mcmc->offsetMCMC>=1) printf("   Starting MCMC from offset initial parameters\n\n");
+  
+  // *** Open the output file and write run parameters in the header ***
+  for(tempi=0;tempi<mcmc->nTemps;tempi++) {
+    if(tempi==0 || mcmc->saveHotChains>0) {
+      fprintf(mcmc->fouts[tempi], "  SPINspiral version:%8.2f\n\n",1.0);
+      fprintf(mcmc->fouts[tempi], "%10s  %10s  %6s  %20s  %6s %8s   %6s  %8s  %10s  %12s  %9s  %9s  %8s\n",
+              "nIter","Nburn","seed","null likelihood","Ndet","nCorr","nTemps","Tmax","Tchain","Network SNR","Waveform","pN order","Npar");
+      fprintf(mcmc->fouts[tempi], "%10d  %10d  %6d  %20.10lf  %6d %8d   %6d%10d%12.1f%14.6f  %9i  %9.1f  %8i\n",
+              mcmc->nIter,mcmc->annealNburn,mcmc->seed,0.0,run.networkSize,mcmc->nCorr,mcmc->nTemps,(int)mcmc->maxTemp,mcmc->tempLadder[tempi],run.netsnr,run.mcmcWaveform,run.mcmcPNorder,run.nMCMCpar);
+      fprintf(mcmc->fouts[tempi], "\n%16s  %16s  %10s  %10s  %10s  %10s  %20s  %15s  %12s  %12s  %12s\n",
+              "Detector","SNR","f_low","f_high","before tc","after tc","Sample start (GPS)","Sample length","Sample rate","Sample size","FT size");
+      for(i=0;i<run.networkSize;i++) {
+        fprintf(mcmc->fouts[tempi], "%16s  %16.8lf  %10.2lf  %10.2lf  %10.2lf  %10.2lf  %20.8lf  %15.7lf  %12d  %12d  %12d\n",
+                ifo[i]->name,ifo[i]->snr,ifo[i]->lowCut,ifo[i]->highCut,ifo[i]->before_tc,ifo[i]->after_tc,
+                ifo[i]->FTstart,ifo[i]->deltaFT,ifo[i]->samplerate,ifo[i]->samplesize,ifo[i]->FTsize);
+      }
+      
       //Parameter numbers:
-      for(i=0;i<mcmc.nMCMCpar;i++) {
-        if(mcmc.parID[i]>=11 && mcmc.parID[i]<=19) {  //GPS time
-          fprintf(mcmc.fouts[tempi], " %17i",mcmc.parID[i]);
+      for(i=0;i<mcmc->nMCMCpar;i++) {
+        if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
+          fprintf(mcmc->fouts[tempi], " %17i",mcmc->parID[i]);
         } else {
-          fprintf(mcmc.fouts[tempi], " %9i",mcmc.parID[i]);
+          fprintf(mcmc->fouts[tempi], " %9i",mcmc->parID[i]);
         }
       }
-      fprintf(mcmc.fouts[tempi],"\n");
+      fprintf(mcmc->fouts[tempi],"\n");
       
       //Parameter symbols:
-      for(i=0;i<mcmc.nMCMCpar;i++) {
-        if(mcmc.parID[i]>=11 && mcmc.parID[i]<=19) {  //GPS time
-          fprintf(mcmc.fouts[tempi], " %17s",mcmc.parAbrev[mcmc.parID[i]]);
+      for(i=0;i<mcmc->nMCMCpar;i++) {
+        if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
+          fprintf(mcmc->fouts[tempi], " %17s",mcmc->parAbrev[mcmc->parID[i]]);
         } else {
-          fprintf(mcmc.fouts[tempi], " %9s",mcmc.parAbrev[mcmc.parID[i]]);
+          fprintf(mcmc->fouts[tempi], " %9s",mcmc->parAbrev[mcmc->parID[i]]);
         }
       }
-      fprintf(mcmc.fouts[tempi],"\n");
+      fprintf(mcmc->fouts[tempi],"\n");
       
-      fflush(mcmc.fouts[tempi]);
+      fflush(mcmc->fouts[tempi]);
     }
   }
 } // End writeMCMCheader
@@ -891,10 +1801,10 @@ void writeMCMCheader(struct interferometer *ifo[], struct MCMCvariables mcmc, st
  *
  */
 // ****************************************************************************************************************************************************  
-void writeMCMCoutput(struct MCMCvariables mcmc, struct interferometer *ifo[])
+void writeMCMCoutput(const struct MCMCvariables *mcmc, const struct MCMCchain *chain, struct interferometer *ifo[])
 // ****************************************************************************************************************************************************  
 {
-  int p=0, tempi=mcmc.iTemp, iIter=mcmc.iIter, i=0;
+  int p=0, tempi=chain->iTemp, iIter=mcmc->iIter, i=0;
   
   //printf("%d  %d",tempi,iIter);
   
@@ -902,29 +1812,29 @@ void writeMCMCoutput(struct MCMCvariables mcmc, struct interferometer *ifo[])
   if(tempi==0) { //Only for the T=1 chain
     /*ILYA*/
     // if((iIter % (50*thinScreenOutput))==0 || iIter<0) printf("Previous iteration has match of %10g with true signal\n\n", 
-    // matchBetweenParameterArrayAndTrueParameters(mcmc.param[tempi], ifo, mcmc); //CHECK need support for two different waveforms
+    // matchBetweenParameterArrayAndTrueParameters(chain->param, ifo, mcmc); //CHECK need support for two different waveforms
     // While the above is commented out, get rid of 'not used' warnings for the ifo struct from icc:
     ifo[0]->index = ifo[0]->index;
     
-    if((iIter % (50*mcmc.thinScreenOutput))==0 || iIter<0) {
+    if((iIter % (50*mcmc->thinScreenOutput))==0 || iIter<0) {
       printf("\n%9s%10s","Cycle","logL");
-      for(i=0;i<mcmc.nMCMCpar;i++) {
-        if(mcmc.parID[i]>=11 && mcmc.parID[i]<=19) {  //GPS time
-          printf(" %18s",mcmc.parAbrev[mcmc.parID[i]]);
+      for(i=0;i<mcmc->nMCMCpar;i++) {
+        if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
+          printf(" %18s",mcmc->parAbrev[mcmc->parID[i]]);
         } else {
-          printf(" %9s",mcmc.parAbrev[mcmc.parID[i]]);
+          printf(" %9s",mcmc->parAbrev[mcmc->parID[i]]);
         }
       }
       printf("\n");
     }
     
     
-    if((iIter % mcmc.thinScreenOutput)==0 || iIter<0){  printf("%9d%10.3lf",iIter,mcmc.logL[tempi]);
-      for(i=0;i<mcmc.nMCMCpar;i++) {
-        if(mcmc.parID[i]>=11 && mcmc.parID[i]<=19) {  //GPS time
-          printf(" %18.4f",mcmc.param[tempi][i]);
+    if((iIter % mcmc->thinScreenOutput)==0 || iIter<0){  printf("%9d%10.3lf",iIter,chain->logL);
+      for(i=0;i<mcmc->nMCMCpar;i++) {
+        if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
+          printf(" %18.4f",chain->param[i]);
         } else {
-          printf(" %9.4f",mcmc.param[tempi][i]);
+          printf(" %9.4f",chain->param[i]);
         }
       }
       printf("\n");}
@@ -934,31 +1844,31 @@ void writeMCMCoutput(struct MCMCvariables mcmc, struct interferometer *ifo[])
   
   
   double *accrat;
-  accrat = (double*)calloc(mcmc.nMCMCpar,sizeof(double));
-  for(p=0;p<mcmc.nMCMCpar;p++) accrat[p] = 0.0;
+  accrat = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
+  for(p=0;p<mcmc->nMCMCpar;p++) accrat[p] = 0.0;
   if(iIter > 0) {
-    for(p=0;p<mcmc.nMCMCpar;p++) accrat[p] = mcmc.accepted[tempi][p]/(double)iIter;
+    for(p=0;p<mcmc->nMCMCpar;p++) accrat[p] = chain->accepted[p]/(double)iIter;
   }
   
   // *** Write output to file ***
-  if(tempi==0 || mcmc.saveHotChains>0) { //For all T-chains if desired, otherwise the T=1 chain only
-    if((iIter % mcmc.thinOutput)==0 || iIter<=0){
-      if(iIter<=0 || tempi==0 || (iIter % (mcmc.thinOutput*mcmc.saveHotChains))==0) { //Save every mcmc.thinOutput-th line for the T=1 chain, but every (mcmc.thinOutput*mcmc.saveHotChains)-th line for the T>1 ones
-        fprintf(mcmc.fouts[tempi], "%8d %12.5lf %9.6lf", iIter,mcmc.logL[tempi],1.0);
-        for(i=0;i<mcmc.nMCMCpar;i++) {
-          if(mcmc.parID[i]>=11 && mcmc.parID[i]<=19) {  //GPS time
-            fprintf(mcmc.fouts[tempi]," %17.6f",mcmc.param[tempi][i]);
+  if(tempi==0 || mcmc->saveHotChains>0) { //For all T-chains if desired, otherwise the T=1 chain only
+    if((iIter % mcmc->thinOutput)==0 || iIter<=0){
+      if(iIter<=0 || tempi==0 || (iIter % (mcmc->thinOutput*mcmc->saveHotChains))==0) { //Save every mcmc->thinOutput-th line for the T=1 chain, but every (mcmc->thinOutput*mcmc->saveHotChains)-th line for the T>1 ones
+        fprintf(mcmc->fouts[tempi], "%8d %12.5lf %9.6lf", iIter,chain->logL,1.0);
+        for(i=0;i<mcmc->nMCMCpar;i++) {
+          if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
+            fprintf(mcmc->fouts[tempi]," %17.6f",chain->param[i]);
           } else {
-            fprintf(mcmc.fouts[tempi]," %9.5f",mcmc.param[tempi][i]);
+            fprintf(mcmc->fouts[tempi]," %9.5f",chain->param[i]);
           }
         }
-        fprintf(mcmc.fouts[tempi],"\n");
+        fprintf(mcmc->fouts[tempi],"\n");
 	
 	
-        fflush(mcmc.fouts[tempi]); //Make sure any 'snapshot' you take halfway is complete
+        fflush(mcmc->fouts[tempi]); //Make sure any 'snapshot' you take halfway is complete
 	
-      } //if(tempi==0 || (iIter % (mcmc.thinOutput*mcmc.saveHotChains))==0)
-    } //if((iIter % mcmc.thinOutput)==0 || iIter<0)
+      } //if(tempi==0 || (iIter % (mcmc->thinOutput*mcmc->saveHotChains))==0)
+    } //if((iIter % mcmc->thinOutput)==0 || iIter<0)
   } //if(tempi==0)
   
   free(accrat);
@@ -975,89 +1885,108 @@ void writeMCMCoutput(struct MCMCvariables mcmc, struct interferometer *ifo[])
 
 // ****************************************************************************************************************************************************  
 /**
- * \brief Allocate memory for the MCMCvariables struct.
+ * \brief Allocate memory for the MCMCvariables struct and the state of its chains.
  *
- * Allocate memory for the MCMCvariables struct.  Don't forget to deallocate whatever you put here in freeMCMCvariables()
+ * Allocate memory for the MCMCvariables struct and the MCMCchain structs in mcmc->chain.  Don't forget to deallocate whatever you put here 
+ * in freeMCMCvariables()
  */
 // ****************************************************************************************************************************************************  
 void allocateMCMCvariables(struct MCMCvariables *mcmc)
 // ****************************************************************************************************************************************************  
 {
-  int i=0, j=0, nPar=0;
+  int i=0, j=0, tempi=0, nPar=0, nFree=0;
+  struct MCMCchain *chain = NULL;
   
   nPar = max(mcmc->nMCMCpar, mcmc->nInjectPar);  // param[] and nParam[] may be used for injection parameters at initialisation...
   
+  //Determine the parameters that are actually fitted/varied (i.e. not kept fixed at the true values);  the proposals, covariance
+  //  matrices and their Cholesky decompositions work in the dense subspace of these nParFit parameters, parFree[0..nParFit-1]
   mcmc->nParFit=0;
-  
-  mcmc->histMean  = (double*)calloc(mcmc->nMCMCpar,sizeof(double));     // Mean of hist block of iterations, used to get the covariance matrix
-  mcmc->histDev = (double*)calloc(mcmc->nMCMCpar,sizeof(double));       // Standard deviation of hist block of iterations, used to get the covariance matrix
   for(i=0;i<mcmc->nMCMCpar;i++) {
-    mcmc->histMean[i] = 0;
-    mcmc->histDev[i] = 0;
-  }
-  
-  mcmc->corrUpdate = (int*)calloc(mcmc->nTemps,sizeof(int));
-  mcmc->acceptElems = (int*)calloc(mcmc->nTemps,sizeof(int));
-  for(i=0;i<mcmc->nTemps;i++) {
-    mcmc->corrUpdate[i] = 0;
-    mcmc->acceptElems[i] = 0;
+    if(mcmc->parFix[i]==0) {
+      mcmc->parFree[mcmc->nParFit] = i;
+      mcmc->nParFit += 1;
+    }
   }
+  nFree = max(mcmc->nParFit,1);
   
   mcmc->tempAmpl = (double*)calloc(mcmc->nTemps,sizeof(double));     // Temperature amplitudes for sinusoid T in parallel tempering                                                     
-  mcmc->logL = (double*)calloc(mcmc->nTemps,sizeof(double));         // Current log(L)                                                                                          
-  mcmc->nlogL = (double*)calloc(mcmc->nTemps,sizeof(double));        // New log(L)                                                                                                      
-  mcmc->dlogL = (double*)calloc(mcmc->nTemps,sizeof(double));        // log(L)-log(Lo)                                                                                          
-  mcmc->maxdlogL = (double*)calloc(mcmc->nTemps,sizeof(double));     // Remember the maximum dlog(L)                                                                                    
+  mcmc->swapTs1 = (int*)calloc(mcmc->nTemps,sizeof(int));            // Totals for the columns in the chain-swap matrix                                        
+  mcmc->swapTs2 = (int*)calloc(mcmc->nTemps,sizeof(int));            // Totals for the rows in the chain-swap matrix                                              
+  mcmc->swapTss = (int**)calloc(mcmc->nTemps,sizeof(int*));          // Count swaps between chains
   for(i=0;i<mcmc->nTemps;i++) {
     mcmc->tempAmpl[i] = 0.0;
-    mcmc->logL[i] = 0.0;
-    mcmc->nlogL[i] = 0.0;
-    mcmc->dlogL[i] = 0.0;
-    mcmc->maxdlogL[i] = -1.e30;
-  }
-  
-  mcmc->corrSig = (double*)calloc(mcmc->nTemps,sizeof(double));      // Sigma for correlated update proposals                                                
-  mcmc->swapTs1 = (int*)calloc(mcmc->nTemps,sizeof(int));                  // Totals for the columns in the chain-swap matrix                                        
-  mcmc->swapTs2 = (int*)calloc(mcmc->nTemps,sizeof(int));                  // Totals for the rows in the chain-swap matrix                                              
-  mcmc->acceptPrior = (int*)calloc(mcmc->nTemps,sizeof(int));        // Check boundary conditions and choose to accept (1) or not(0)                                 
-  mcmc->iHist = (int*)calloc(mcmc->nTemps,sizeof(int));            // Count the iteration number in the current history block to calculate the covar matrix from
-  for(i=0;i<mcmc->nTemps;i++) {
-    mcmc->corrSig[i] = 1.0;
     mcmc->swapTs1[i] = 0;
     mcmc->swapTs2[i] = 0;
-    mcmc->acceptPrior[i] = 1;
-    mcmc->iHist[i] = 0;
-  }
-  
-  mcmc->accepted = (int**)calloc(mcmc->nTemps,sizeof(int*));         // Count accepted proposals
-  mcmc->swapTss = (int**)calloc(mcmc->nTemps,sizeof(int*));          // Count swaps between chains
-  mcmc->param = (double**)calloc(mcmc->nTemps,sizeof(double*));      // The old parameters for all chains
-  mcmc->nParam = (double**)calloc(mcmc->nTemps,sizeof(double*));     // The new parameters for all chains
-  mcmc->maxLparam = (double**)calloc(mcmc->nTemps,sizeof(double*));   // The best parameters for all chains (max logL)
-  mcmc->adaptSigma = (double**)calloc(mcmc->nTemps,sizeof(double*));        // The standard deviation of the gaussian to draw the jump size from
-  mcmc->adaptSigmaOut = (double**)calloc(mcmc->nTemps,sizeof(double*));     // The sigma that gets written to output
-  mcmc->adaptScale = (double**)calloc(mcmc->nTemps,sizeof(double*));      // The rate of adaptation
-  for(i=0;i<mcmc->nTemps;i++) {
-    mcmc->accepted[i] = (int*)calloc(mcmc->nMCMCpar,sizeof(int));
     mcmc->swapTss[i] = (int*)calloc(mcmc->nTemps,sizeof(int));
-    mcmc->param[i] = (double*)calloc(nPar,sizeof(double));
-    mcmc->nParam[i] = (double*)calloc(nPar,sizeof(double));
-    mcmc->maxLparam[i] = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
-    mcmc->adaptSigma[i] = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
-    mcmc->adaptSigmaOut[i] = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
-    mcmc->adaptScale[i] = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
   }
   
-  mcmc->hist    = (double***)calloc(mcmc->nTemps,sizeof(double**));  // Store a block of iterations, to calculate the covariances
-  mcmc->covar  = (double***)calloc(mcmc->nTemps,sizeof(double**));   // The Cholesky-decomposed covariance matrix
-  for(i=0;i<mcmc->nTemps;i++) {
-    mcmc->hist[i]    = (double**)calloc(mcmc->nMCMCpar,sizeof(double*));
-    mcmc->covar[i]  = (double**)calloc(mcmc->nMCMCpar,sizeof(double*));
-    for(j=0;j<mcmc->nMCMCpar;j++) {
-      mcmc->hist[i][j]    = (double*)calloc(mcmc->nCorr,sizeof(double));
-      mcmc->covar[i][j]  = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
+  mcmc->tMargPost = NULL;                                            // Allocated in accumulateTimePosterior()
+  mcmc->tMargPostLow = 0;
+  mcmc->tMargPostN = 0;
+  mcmc->tMargPostCount = 0;
+  
+  
+  // The state of each chain:
+  mcmc->chain = (struct MCMCchain*)calloc(mcmc->nTemps,sizeof(struct MCMCchain));
+  for(tempi=0;tempi<mcmc->nTemps;tempi++) {
+    chain = &mcmc->chain[tempi];
+    chain->iTemp = tempi;
+    chain->chTemp = max(mcmc->annealTemp0,1.0);                     // Current temperature
+    chain->ran = NULL;                                               // Set in MCMC()
+    
+    chain->param = (double*)calloc(nPar,sizeof(double));             // The old parameters
+    chain->nParam = (double*)calloc(nPar,sizeof(double));            // The new parameters
+    chain->maxLparam = (double*)calloc(mcmc->nMCMCpar,sizeof(double));   // The best parameters (max logL)
+    chain->accepted = (int*)calloc(mcmc->nMCMCpar,sizeof(int));      // Count accepted proposals
+    chain->adaptSigma = (double*)calloc(mcmc->nMCMCpar,sizeof(double));      // The standard deviation of the gaussian to draw the jump size from
+    chain->adaptSigmaOut = (double*)calloc(mcmc->nMCMCpar,sizeof(double));   // The sigma that gets written to output
+    chain->adaptScale = (double*)calloc(mcmc->nMCMCpar,sizeof(double));      // The rate of adaptation
+    chain->logL = 0.0;
+    chain->nlogL = 0.0;
+    chain->dlogL = 0.0;
+    chain->maxdlogL = -1.e30;
+    chain->acceptPrior = 1;
+    chain->corrSig = 1.0;
+    
+    chain->corrUpdate = 0;
+    chain->acceptElems = 0;
+    chain->iHist = 0;
+    chain->histMean = (double*)calloc(mcmc->nMCMCpar,sizeof(double));  // Running mean of the chain, at the latest covariance-matrix update
+    chain->histDev = (double*)calloc(mcmc->nMCMCpar,sizeof(double));   // Running standard deviation of the chain, at the latest covariance-matrix update
+    
+    chain->covN = 0;                                                 // Number of states in the running covariance matrix
+    chain->covMean = (double*)calloc(nFree,sizeof(double));          // Running mean of the states
+    chain->covChol = (double**)calloc(nFree,sizeof(double*));        // The Cholesky-decomposed running covariance matrix
+    chain->covar  = (double**)calloc(nFree,sizeof(double*));         // The Cholesky-decomposed covariance matrix
+    chain->covChol[0] = (double*)calloc(nFree*nFree,sizeof(double)); // Contiguous nParFit x nParFit matrices, with pointers to their rows
+    chain->covar[0]  = (double*)calloc(nFree*nFree,sizeof(double));
+    for(j=1;j<nFree;j++) {
+      chain->covChol[j] = chain->covChol[0] + j*nFree;
+      chain->covar[j]  = chain->covar[0] + j*nFree;
     }
-  }  
+    
+    chain->deN = 0;                                                  // Number of states in the differential-evolution history
+    chain->deNext = 0;                                               // Position of the next state in the ring buffer
+    chain->deHist = NULL;                                            // Ring buffer of deHistorySize states
+    if(mcmc->deFrac>0.0) chain->deHist = (double*)calloc(deHistorySize*nFree,sizeof(double));
+    
+    chain->cacheValid = 0;                                           // Cached overlaps of the current state
+    chain->cacheHD = 0.0;
+    chain->cacheHH = 0.0;
+    chain->cachePar = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
+    chain->nOverlapHD = 0.0;
+    chain->nOverlapHH = 0.0;
+    
+    chain->likelihoodAllocations = 0;
+    chain->threadIfo = NULL;                                         // Set in MCMC()
+    for(j=0;j<nUpdateTypes;j++) {
+      chain->updateProposed[j] = 0;
+      chain->updateAccepted[j] = 0;
+      chain->updateTime[j] = 0.0;
+      chain->updateJump[j] = 0.0;
+    }
+  }
 } // End allocateMCMCvariables
 // ****************************************************************************************************************************************************  
 
@@ -1066,63 +1995,53 @@ void allocateMCMCvariables(struct MCMCvariables *mcmc)
 
 // ****************************************************************************************************************************************************  
 /**
- * \brief Deallocate memory for the MCMCvariables struct
+ * \brief Deallocate memory for the MCMCvariables struct and the state of its chains
  *
  */
 // ****************************************************************************************************************************************************  
 void freeMCMCvariables(struct MCMCvariables *mcmc)
 // ****************************************************************************************************************************************************  
 {
-  int i=0, j=0;
-  gsl_rng_free(mcmc->ran);
+  int i=0, tempi=0;
+  struct MCMCchain *chain = NULL;
   
-  free(mcmc->histMean);
-  free(mcmc->histDev);
+  for(tempi=0;tempi<mcmc->nTemps;tempi++) {
+    chain = &mcmc->chain[tempi];
+    if(chain->ran != NULL && chain->ran != mcmc->ran) gsl_rng_free(chain->ran);  // The T=1 chain uses mcmc->ran
+    
+    free(chain->param);
+    free(chain->nParam);
+    free(chain->maxLparam);
+    free(chain->accepted);
+    free(chain->adaptSigma);
+    free(chain->adaptSigmaOut);
+    free(chain->adaptScale);
+    
+    free(chain->histMean);
+    free(chain->histDev);
+    free(chain->covMean);
+    free(chain->covChol[0]);
+    free(chain->covar[0]);
+    free(chain->covChol);
+    free(chain->covar);
+    
+    free(chain->deHist);
+    free(chain->cachePar);
+    free(chain->intrinsicCachePar);
+    free(chain->intrinsicCacheDH);
+    free(chain->intrinsicCacheHH);
+  }
+  free(mcmc->chain);
   
-  free(mcmc->corrUpdate);
-  free(mcmc->acceptElems);
+  gsl_rng_free(mcmc->ran);
   
   free(mcmc->tempAmpl);
-  free(mcmc->logL);
-  free(mcmc->nlogL);
-  free(mcmc->dlogL);
-  free(mcmc->maxdlogL);
-  
-  free(mcmc->corrSig);
-  free(mcmc->acceptPrior);
-  free(mcmc->iHist);
+  for(i=0;i<mcmc->nTemps;i++) free(mcmc->swapTss[i]);
+  free(mcmc->swapTss);
   free(mcmc->swapTs1);
   free(mcmc->swapTs2);
   
-  for(i=0;i<mcmc->nTemps;i++) {
-    free(mcmc->accepted[i]);
-    free(mcmc->swapTss[i]);
-    free(mcmc->param[i]);
-    free(mcmc->nParam[i]);
-    free(mcmc->maxLparam[i]);
-    free(mcmc->adaptSigma[i]);
-    free(mcmc->adaptSigmaOut[i]);
-    free(mcmc->adaptScale[i]);
-  }
-  free(mcmc->accepted);
-  free(mcmc->swapTss);
-  free(mcmc->param);
-  free(mcmc->nParam);
-  free(mcmc->maxLparam);
-  free(mcmc->adaptSigma);
-  free(mcmc->adaptSigmaOut);
-  free(mcmc->adaptScale);
-  
-  for(i=0;i<mcmc->nTemps;i++) {
-    for(j=0;j<mcmc->nMCMCpar;j++) {
-      free(mcmc->hist[i][j]);
-      free(mcmc->covar[i][j]);
-    }
-    free(mcmc->hist[i]);
-    free(mcmc->covar[i]);
-  }
-  free(mcmc->hist);
-  free(mcmc->covar);
+  free(mcmc->tMargPost);
 } // End freeMCMCvariables
 // ****************************************************************************************************************************************************  
 
@@ -1139,117 +2058,122 @@ void freeMCMCvariables(struct MCMCvariables *mcmc)
 
 // ****************************************************************************************************************************************************  
 /**
- * \brief Calculate the new covariance matrix and determine whether the new matrix should be accepted
+ * \brief Add the current state of the chain to its running mean and covariance matrix
  *
- * Compute the new covariance matrix for the current T chain. Determine by the 'improvement' of the new matrix whether it should be accepted.
+ * The first nCorr states are added with Welford's algorithm,  C_n = (n-2)/(n-1) C_{n-1} + d d^T/n,  with d the difference between the
+ * state and the previous mean.  After that, older states are forgotten exponentially with weight gamma = 1/nCorr:
+ * C = (1-gamma) (C + gamma d d^T).  The covariance matrix is kept in its Cholesky-decomposed form in chain->covChol, which is scaled and 
+ * then updated with the rank-1 term (see CholeskyRankOneUpdate()), in O(n^2) operations and without allocation.  The mean and covariance
+ * matrix are kept for the free parameters only (see parFree).
  */
 // ****************************************************************************************************************************************************  
-void updateCovarianceMatrix(struct MCMCvariables *mcmc)
-// ****************************************************************************************************************************************************  
+void accumulateCovariance(const struct MCMCvariables *mcmc, struct MCMCchain *chain)
 {
-  int i=0, j=0, i1=0, p1=0, p2=0;
-  double **tempcovar;
-  tempcovar = (double**)calloc(mcmc->nMCMCpar,sizeof(double*));           // A temp Cholesky-decomposed matrix
-  for(i=0;i<mcmc->nMCMCpar;i++) tempcovar[i] = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
-  double ***covar1;
-  covar1  = (double***)calloc(mcmc->nTemps,sizeof(double**));   // The actual covariance matrix
-  for(i=0;i<mcmc->nTemps;i++) {
-    covar1[i]  = (double**)calloc(mcmc->nMCMCpar,sizeof(double*));
-    for(j=0;j<mcmc->nMCMCpar;j++) covar1[i][j]  = (double*)calloc(mcmc->nMCMCpar,sizeof(double));
-  }
+  int p1=0, p2=0, n=0;
+  double d[mcmc->nParFit], gamma=0.0, scale=0.0, dScale=0.0;
   
+  chain->covN += 1;
+  n = chain->covN;
+  gamma = 1.0/(double)min(n, mcmc->nCorr);
   
-  //Calculate the mean
-  for(p1=0;p1<mcmc->nMCMCpar;p1++){
-    mcmc->histMean[p1]=0.0;
-    for(i1=0;i1<mcmc->nCorr;i1++) mcmc->histMean[p1]+=mcmc->hist[mcmc->iTemp][p1][i1];
-    mcmc->histMean[p1]/=((double)mcmc->nCorr);
+  for(p1=0;p1<mcmc->nParFit;p1++) {
+    d[p1] = chain->param[mcmc->parFree[p1]] - chain->covMean[p1];
+    chain->covMean[p1] += gamma*d[p1];
   }
-  
-  //Calculate the standard deviation. Only for printing, not used in the code
-  for(p1=0;p1<mcmc->nMCMCpar;p1++){
-    mcmc->histDev[p1]=0.0;
-    for(i1=0;i1<mcmc->nCorr;i1++) mcmc->histDev[p1] += (mcmc->hist[mcmc->iTemp][p1][i1]-mcmc->histMean[p1])*(mcmc->hist[mcmc->iTemp][p1][i1]-mcmc->histMean[p1]);
-    mcmc->histDev[p1] = sqrt(mcmc->histDev[p1]/(double)(mcmc->nCorr-1));
+  if(n==1) return;                                                                 // A single state has no covariance
+  
+  if(n<=mcmc->nCorr) {                                                             // Welford
+    scale  = sqrt((double)(n-2)/(double)(n-1));
+    dScale = sqrt(1.0/(double)n);
+  } else {                                                                         // Exponential forgetting
+    scale  = sqrt(1.0-gamma);
+    dScale = sqrt(gamma*(1.0-gamma));
   }
   
-  //Calculate the covariances and save them in covar1
-  for(p1=0;p1<mcmc->nMCMCpar;p1++){
-    for(p2=0;p2<=p1;p2++){
-      covar1[mcmc->iTemp][p1][p2]=0.0;
-      for(i1=0;i1<mcmc->nCorr;i1++) covar1[mcmc->iTemp][p1][p2] += (mcmc->hist[mcmc->iTemp][p1][i1] - mcmc->histMean[p1]) * (mcmc->hist[mcmc->iTemp][p2][i1] - mcmc->histMean[p2]);
-      covar1[mcmc->iTemp][p1][p2] /= (double)(mcmc->nCorr-1);
-    }
+  for(p1=0;p1<mcmc->nParFit;p1++) {
+    for(p2=0;p2<=p1;p2++) chain->covChol[p1][p2] *= scale;
+    d[p1] *= dScale;
   }
-  
-  //Store the covariance matrix in a temporary variable tempcovar, for Cholesky decomposition
-  for(p1=0;p1<mcmc->nMCMCpar;p1++){
-    for(p2=0;p2<=p1;p2++) tempcovar[p1][p2] = covar1[mcmc->iTemp][p1][p2];
+  CholeskyRankOneUpdate(chain->covChol, d, 1.0, mcmc->nParFit);
+} // End accumulateCovariance()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine whether the running covariance matrix should replace the proposal matrix
+ *
+ * The proposal matrix of the chain is refreshed from its running estimate (see accumulateCovariance()) every corrRefresh
+ * iterations.  Determine by the 'improvement' of the new matrix whether it should be accepted.
+ */
+// ****************************************************************************************************************************************************  
+void updateCovarianceMatrix(const struct MCMCvariables *mcmc, struct MCMCchain *chain)
+// ****************************************************************************************************************************************************  
+{
+  int p1=0, p2=0, p3=0;
+  double **newCovar = chain->covChol;                                  // The Cholesky-decomposed running covariance matrix
+  double cov=0.0;
+  
+  
+  //Get the mean and the standard deviation (from the length of the rows of the Cholesky-decomposed matrix). Only for printing, not used in the code
+  for(p1=0;p1<mcmc->nParFit;p1++){
+    p3 = mcmc->parFree[p1];
+    chain->histMean[p3] = chain->covMean[p1];
+    chain->histDev[p3] = 0.0;
+    for(p2=0;p2<=p1;p2++) chain->histDev[p3] += newCovar[p1][p2]*newCovar[p1][p2];
+    chain->histDev[p3] = sqrt(chain->histDev[p3]);
   }
   
-  if(mcmc->iTemp==0 && mcmc->prMatrixInfo>0) printf("\n\n");
-  
-  //Do Cholesky decomposition
-  CholeskyDecompose(tempcovar,mcmc);
+  if(chain->iTemp==0 && mcmc->prMatrixInfo>0) printf("\n\n");
   
   //Get conditions to decide whether to accept the new matrix or not
-  mcmc->acceptElems[mcmc->iTemp] = 0;
-  for(p1=0;p1<mcmc->nMCMCpar;p1++) {
-    if(mcmc->parFix[p1]==0) {
-      if(tempcovar[p1][p1] < mcmc->covar[mcmc->iTemp][p1][p1]) mcmc->acceptElems[mcmc->iTemp] += 1; //Smaller diagonal element is better; count for how many this is the case
-      if(tempcovar[p1][p1]<=0.0 || isnan(tempcovar[p1][p1])!=0 || isinf(tempcovar[p1][p1])!=0) mcmc->acceptElems[mcmc->iTemp] -= 9999;  //If diagonal element is <0, NaN or Inf
-    }
+  chain->acceptElems = 0;
+  for(p1=0;p1<mcmc->nParFit;p1++) {
+    if(newCovar[p1][p1] < chain->covar[p1][p1]) chain->acceptElems += 1; //Smaller diagonal element is better; count for how many this is the case
+    if(newCovar[p1][p1]<=0.0 || isnan(newCovar[p1][p1])!=0 || isinf(newCovar[p1][p1])!=0) chain->acceptElems -= 9999;  //If diagonal element is <0, NaN or Inf
   }
-  mcmc->acceptElems[mcmc->iTemp] = max(mcmc->acceptElems[mcmc->iTemp],-1); //Now -1 means there is a diagonal element that is 0, NaN or Inf
+  chain->acceptElems = max(chain->acceptElems,-1); //Now -1 means there is a diagonal element that is 0, NaN or Inf
   
   //Print matrix information  
-  if(mcmc->prMatrixInfo==2 && mcmc->iTemp==0){
+  if(mcmc->prMatrixInfo==2 && chain->iTemp==0){
     printf("\n  Update for the covariance matrix proposed at iteration:  %10d\n",mcmc->iIter);
-    printf("\n    AcceptElems: %d\n",mcmc->acceptElems[mcmc->iTemp]);
-    printf("\n    Covariance matrix:\n");
-    for(p1=0;p1<mcmc->nMCMCpar;p1++){
-      for(p2=0;p2<=p1;p2++) printf("    %10.3g",covar1[mcmc->iTemp][p1][p2]);
+    printf("\n    AcceptElems: %d\n",chain->acceptElems);
+    printf("\n    Covariance matrix (free parameters only):\n");
+    for(p1=0;p1<mcmc->nParFit;p1++){
+      for(p2=0;p2<=p1;p2++) {
+        cov = 0.0;
+        for(p3=0;p3<=p2;p3++) cov += newCovar[p1][p3]*newCovar[p2][p3];
+        printf("    %10.3g",cov);
+      }
       printf("\n");
     }
     printf("\n    Old Cholesky-decomposed matrix:\n");
-    for(p1=0;p1<mcmc->nMCMCpar;p1++){
-      for(p2=0;p2<=p1;p2++) printf("    %10.3g",mcmc->covar[mcmc->iTemp][p1][p2]);
+    for(p1=0;p1<mcmc->nParFit;p1++){
+      for(p2=0;p2<=p1;p2++) printf("    %10.3g",chain->covar[p1][p2]);
       printf("\n");
     }
     printf("\n    New Cholesky-decomposed matrix:\n");
-    for(p1=0;p1<mcmc->nMCMCpar;p1++){
-      for(p2=0;p2<=p1;p2++) printf("    %10.3g",tempcovar[p1][p2]);
-      //for(p2=0;p2<mcmc->nMCMCpar;p2++) printf("    %10.3g",tempcovar[p1][p2]);
+    for(p1=0;p1<mcmc->nParFit;p1++){
+      for(p2=0;p2<=p1;p2++) printf("    %10.3g",newCovar[p1][p2]);
       printf("\n");
     }
   }
   
-  // Copy the new covariance matrix from tempcovar into mcmc->covar
-  if(mcmc->acceptElems[mcmc->iTemp]>=0) { //Accept new matrix only if no Infs, NaNs, 0s occur.
-    if(mcmc->corrUpdate[mcmc->iTemp]<=2 || (double)mcmc->acceptElems[mcmc->iTemp] >= (double)mcmc->nParFit*mcmc->matAccFr) { //Always accept the new matrix on the first update, otherwise only if the fraction matAccFr of diagonal elements are better (smaller) than before
-      for(p1=0;p1<mcmc->nMCMCpar;p1++){
-        for(p2=0;p2<=p1;p2++) mcmc->covar[mcmc->iTemp][p1][p2] = tempcovar[p1][p2]; 
+  // Copy the new covariance matrix from newCovar into chain->covar
+  if(chain->acceptElems>=0) { //Accept new matrix only if no Infs, NaNs, 0s occur.
+    if(chain->corrUpdate<=2 || (double)chain->acceptElems >= (double)mcmc->nParFit*mcmc->matAccFr) { //Always accept the new matrix on the first update, otherwise only if the fraction matAccFr of diagonal elements are better (smaller) than before
+      for(p1=0;p1<mcmc->nParFit;p1++){
+        for(p2=0;p2<=p1;p2++) chain->covar[p1][p2] = newCovar[p1][p2]; 
       }
-      mcmc->corrUpdate[mcmc->iTemp] += 1;
-      if(mcmc->prMatrixInfo>0 && mcmc->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d accepted.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, mcmc->acceptElems[mcmc->iTemp], mcmc->corrUpdate[mcmc->iTemp]-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
+      chain->corrUpdate += 1;
+      if(mcmc->prMatrixInfo>0 && chain->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d accepted.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, chain->acceptElems, chain->corrUpdate-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
     } else {
-      if(mcmc->prMatrixInfo>0 && mcmc->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d rejected.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, mcmc->acceptElems[mcmc->iTemp], mcmc->corrUpdate[mcmc->iTemp]-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
+      if(mcmc->prMatrixInfo>0 && chain->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d rejected.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, chain->acceptElems, chain->corrUpdate-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
     }
   } else {
-    if(mcmc->prMatrixInfo>0 && mcmc->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d rejected.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, mcmc->acceptElems[mcmc->iTemp], mcmc->corrUpdate[mcmc->iTemp]-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
-  }
-  
-  
-  
-  //Deallocate memory
-  for(i=0;i<mcmc->nMCMCpar;i++) free(tempcovar[i]);
-  free(tempcovar);
-  
-  for(i=0;i<mcmc->nTemps;i++) {
-    for(j=0;j<mcmc->nMCMCpar;j++) free(covar1[i][j]);
-    free(covar1[i]);
+    if(mcmc->prMatrixInfo>0 && chain->iTemp==0) printf("  Proposed covariance-matrix update at iteration %d rejected.  AcceptElems: %d.  Accepted matrices: %d/%d \n", mcmc->iIter, chain->acceptElems, chain->corrUpdate-2, (int)((double)mcmc->iIter/(double)mcmc->nCorr));  // -2 since you start with 2
   }
-  free(covar1);
   
 } // End updateCovarianceMatrix
 // ****************************************************************************************************************************************************  
@@ -1262,53 +2186,97 @@ void updateCovarianceMatrix(struct MCMCvariables *mcmc)
 
 // ****************************************************************************************************************************************************  
 /**
- * \brief Compute Cholesky decomposition matrix
+ * \brief Rank-1 update (sign = 1) or downdate (sign = -1) of a Cholesky-decomposed matrix
  *
- * Performs Cholesky decompositon of matrix A and returns result in the same matrix - adapted from PJG Fortran function
- * If matrix is not positive definite, return zeroes
+ * Replace the lower-triangular n x n matrix L, with A = L L^T, by the Cholesky decomposition of A + sign x x^T, using Givens (update) 
+ * or hyperbolic (downdate) rotations, in O(n^2) operations.  x is overwritten.  Returns 1 if a downdate would make the matrix not
+ * positive definite (L is then only partly updated), 0 otherwise.
  */
 // ****************************************************************************************************************************************************  
-void CholeskyDecompose(double **A, struct MCMCvariables *mcmc)
+int CholeskyRankOneUpdate(double **L, double *x, double sign, int n)
 {
-  int j_1=0,j_2=0,j_3=0,notposdef=0;
-  int n=mcmc->nMCMCpar;
-  double sum=0.0;
+  int i=0, k=0;
+  double r=0.0, c=0.0, s=0.0, tmp=0.0;
   
-  for(j_1=0;j_1<n;j_1++){
-    if(mcmc->parFix[j_1]==0) {
-      sum = A[j_1][j_1];
-      for(j_2=0;j_2<j_1;j_2++){
-        if(mcmc->parFix[j_2]==0) {
-          sum -= A[j_1][j_2]*A[j_1][j_2];
-        }
+  for(k=0;k<n;k++) {
+    if(x[k]==0.0) continue;                                                        // Nothing to rotate into column k
+    
+    r = L[k][k]*L[k][k] + sign*x[k]*x[k];
+    if(r<=0.0) return 1;
+    r = sqrt(r);
+    
+    if(sign>0.0) {                                                                 // Update:  Givens rotation
+      c = L[k][k]/r;
+      s = x[k]/r;
+      L[k][k] = r;
+      for(i=k+1;i<n;i++) {
+        tmp = L[i][k];
+        L[i][k] = c*tmp + s*x[i];
+        x[i] = c*x[i] - s*tmp;
       }
-      if(sum<0.0) {
-        notposdef=1;
-      } else {
-        A[j_1][j_1]=sqrt(sum);
-        for(j_2=j_1+1;j_2<n;j_2++){
-          if(mcmc->parFix[j_2]==0){
-            sum = A[j_2][j_1];
-            for(j_3=0;j_3<j_1;j_3++){
-              if(mcmc->parFix[j_3]==0){
-                sum -= A[j_2][j_3]*A[j_1][j_3];
-              }
-            }
-          }
-          A[j_2][j_1] = sum/A[j_1][j_1];
-        }
+    } else {                                                                       // Downdate:  hyperbolic rotation
+      c = r/L[k][k];
+      s = x[k]/L[k][k];
+      L[k][k] = r;
+      for(i=k+1;i<n;i++) {
+        L[i][k] = (L[i][k] - s*x[i])/c;
+        x[i] = c*x[i] - s*L[i][k];
       }
     }
   }
-  if(notposdef==1) {
-    //printf("  CholeskyDecompose():  Matrix %i is not positive definite\n",mcmc->iTemp);
-    for(j_1=0;j_1<n;j_1++){
-      for(j_2=0;j_2<n;j_2++){
-        A[j_1][j_2] = 0.0;
-      }
-    }
+  return 0;
+} // End CholeskyRankOneUpdate()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute out = L z for a lower-triangular n x n matrix L, with a fixed-size kernel for n = 9, 12 or 15
+ */
+// ****************************************************************************************************************************************************  
+static inline void lowerTriangularProductN(double **L, const double *z, double *out, const int n)
+{
+  int i=0, j=0;
+  double sum=0.0;
+  
+  for(i=0;i<n;i++) {
+    sum = 0.0;
+    for(j=0;j<=i;j++) sum += L[i][j]*z[j];
+    out[i] = sum;
   }
-} // End CholeskyDecompose()
+} // End lowerTriangularProductN()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute out = L z for the lower-triangular (Cholesky-decomposed) n x n matrix L and the vector z
+ *
+ * This is the product of the proposal matrix and a vector of Gaussian random numbers in every correlated update.  For the numbers of 
+ * free parameters used in practice, 9 (non-spinning), 12 (one spin) and 15 (two spins), the kernel is inlined with a constant size, 
+ * so that the compiler can unroll its loops completely.
+ */
+// ****************************************************************************************************************************************************  
+void lowerTriangularProduct(double **L, const double *z, double *out, int n)
+{
+  switch(n) {
+  case 9:
+    lowerTriangularProductN(L, z, out, 9);
+    break;
+  case 12:
+    lowerTriangularProductN(L, z, out, 12);
+    break;
+  case 15:
+    lowerTriangularProductN(L, z, out, 15);
+    break;
+  default:
+    lowerTriangularProductN(L, z, out, n);
+  }
+} // End lowerTriangularProduct()
 // ****************************************************************************************************************************************************  
 
 
@@ -1365,22 +2333,41 @@ double annealTemperature(double temp0, int nburn, int nburn0, int iIter)
 void swapChains(struct MCMCvariables *mcmc)
 // ****************************************************************************************************************************************************  
 {
-  int i=0, tempi=0, tempj=0;
-  double tmpdbl = 0.0;
+  int i=0, tempi=0, tempj=0, tmpint=0;
+  double tmpdbl = 0.0, *tmpPtr=NULL;
+  struct MCMCchain *chi=NULL, *chj=NULL;
   
   //Swap parameters and likelihood between any two chains
   for(tempi=0;tempi<mcmc->nTemps-1;tempi++) {
     for(tempj=tempi+1;tempj<mcmc->nTemps;tempj++) {
+      chi = &mcmc->chain[tempi];
+      chj = &mcmc->chain[tempj];
       
-      if(exp(max(-30.0,min(0.0, (1.0/mcmc->tempLadder[tempi]-1.0/mcmc->tempLadder[tempj]) * (mcmc->logL[tempj]-mcmc->logL[tempi]) ))) > gsl_rng_uniform(mcmc->ran)) { //Then swap...
+      if(exp(max(-30.0,min(0.0, (1.0/mcmc->tempLadder[tempi]-1.0/mcmc->tempLadder[tempj]) * (chj->logL-chi->logL) ))) > gsl_rng_uniform(mcmc->ran)) { //Then swap...
         for(i=0;i<mcmc->nMCMCpar;i++) {
-          tmpdbl = mcmc->param[tempj][i]; //Temp var
-          mcmc->param[tempj][i] = mcmc->param[tempi][i];
-          mcmc->param[tempi][i] = tmpdbl;
+          tmpdbl = chj->param[i]; //Temp var
+          chj->param[i] = chi->param[i];
+          chi->param[i] = tmpdbl;
+        }
+        tmpdbl = chj->logL;
+        chj->logL = chi->logL;
+        chi->logL = tmpdbl;
+        
+        //Swap the cached overlaps along with the states
+        tmpPtr = chj->cachePar;
+        chj->cachePar = chi->cachePar;
+        chi->cachePar = tmpPtr;
+        tmpdbl = chj->cacheHD;  chj->cacheHD = chi->cacheHD;  chi->cacheHD = tmpdbl;
+        tmpdbl = chj->cacheHH;  chj->cacheHH = chi->cacheHH;  chi->cacheHH = tmpdbl;
+        tmpint = chj->cacheValid;  chj->cacheValid = chi->cacheValid;  chi->cacheValid = tmpint;
+        tmpPtr = chj->intrinsicCachePar;  chj->intrinsicCachePar = chi->intrinsicCachePar;  chi->intrinsicCachePar = tmpPtr;
+        tmpPtr = chj->intrinsicCacheDH;   chj->intrinsicCacheDH  = chi->intrinsicCacheDH;   chi->intrinsicCacheDH  = tmpPtr;
+        tmpPtr = chj->intrinsicCacheHH;   chj->intrinsicCacheHH  = chi->intrinsicCacheHH;   chi->intrinsicCacheHH  = tmpPtr;
+        tmpint = chj->intrinsicCacheCur;  chj->intrinsicCacheCur = chi->intrinsicCacheCur;  chi->intrinsicCacheCur = tmpint;
+        for(i=0;i<2;i++) {
+          tmpint = chj->intrinsicCacheValid[i];  chj->intrinsicCacheValid[i] = chi->intrinsicCacheValid[i];  chi->intrinsicCacheValid[i] = tmpint;
         }
-        tmpdbl = mcmc->logL[tempj];
-        mcmc->logL[tempj] = mcmc->logL[tempi];
-        mcmc->logL[tempi] = tmpdbl;
+        
         mcmc->swapTss[tempi][tempj] += 1;
         mcmc->swapTs1[tempi] += 1;
         mcmc->swapTs2[tempj] += 1;
@@ -1402,47 +2389,47 @@ void swapChains(struct MCMCvariables *mcmc)
  * \brief Parallel tempering: Print chain and swap info to screen
  */
 // ****************************************************************************************************************************************************  
-void writeChainInfo(struct MCMCvariables mcmc)
+void writeChainInfo(const struct MCMCvariables *mcmc, const struct MCMCchain *chain)
 // ****************************************************************************************************************************************************  
 {
-  int tempi=mcmc.iTemp, p=0, t1=0, t2=0;
+  int tempi=chain->iTemp, p=0, t1=0, t2=0;
   double tmpdbl = 0.0;
   
   if(tempi==0) {
     printf("\n\n      Chain  log(T)   AccEls AccMat    Swap  AccRat    lgStdv:");
-    for(p=0;p<mcmc.nMCMCpar;p++) printf(" %6s",mcmc.parAbrv[mcmc.parID[p]]);
+    for(p=0;p<mcmc->nMCMCpar;p++) printf(" %6s",mcmc->parAbrv[mcmc->parID[p]]);
     printf("\n");
   }
   
   printf("        %3d   %5.3f     %3d    %3d   %6.4f  %6.4f           ",
-         tempi,log10(mcmc.chTemp),mcmc.acceptElems[tempi],mcmc.corrUpdate[tempi]-2,  (double)mcmc.swapTs1[tempi]/(double)mcmc.iIter,(double)mcmc.accepted[tempi][0]/(double)mcmc.iIter);
-  for(p=0;p<mcmc.nMCMCpar;p++) {
-    tmpdbl = log10(mcmc.histDev[p]+1.e-30);
+         tempi,log10(chain->chTemp),chain->acceptElems,chain->corrUpdate-2,  (double)mcmc->swapTs1[tempi]/(double)mcmc->iIter,(double)chain->accepted[0]/(double)mcmc->iIter);
+  for(p=0;p<mcmc->nMCMCpar;p++) {
+    tmpdbl = log10(chain->histDev[p]+1.e-30);
     if(tmpdbl<-9.99) tmpdbl = 0.0;
     printf(" %6.3f",tmpdbl);
   }
   printf("\n");
   
   
-  if(mcmc.prParTempInfo==2 && tempi==mcmc.nTemps-1) { //Print swap-rate matrix for parallel tempering
+  if(mcmc->prParTempInfo==2 && tempi==mcmc->nTemps-1) { //Print swap-rate matrix for parallel tempering
     printf("\n   Chain swap: ");
-    for(t1=0;t1<mcmc.nTemps-1;t1++) printf("  %6d",t1);
+    for(t1=0;t1<mcmc->nTemps-1;t1++) printf("  %6d",t1);
     printf("   total\n");
-    for(t1=1;t1<mcmc.nTemps;t1++) {
+    for(t1=1;t1<mcmc->nTemps;t1++) {
       printf("            %3d",t1);
-      for(t2=0;t2<mcmc.nTemps-1;t2++) {
+      for(t2=0;t2<mcmc->nTemps-1;t2++) {
         if(t2<t1) {
-          printf("  %6.4f",(double)mcmc.swapTss[t2][t1]/(double)mcmc.iIter);
+          printf("  %6.4f",(double)mcmc->swapTss[t2][t1]/(double)mcmc->iIter);
         } else {
           printf("        ");
         }
       }
-      printf("  %6.4f\n",(double)mcmc.swapTs2[t1]/(double)mcmc.iIter);
+      printf("  %6.4f\n",(double)mcmc->swapTs2[t1]/(double)mcmc->iIter);
     }
     printf("          total");
-    for(t1=0;t1<mcmc.nTemps-1;t1++) printf("  %6.4f",(double)mcmc.swapTs1[t1]/(double)mcmc.iIter);
+    for(t1=0;t1<mcmc->nTemps-1;t1++) printf("  %6.4f",(double)mcmc->swapTs1[t1]/(double)mcmc->iIter);
     printf("\n\n");
-  } //if(mcmc.prParTempInfo==2 && tempi==mcmc.nTemps-1)
+  } //if(mcmc->prParTempInfo==2 && tempi==mcmc->nTemps-1)
 } // End writeChainInfo
 // ****************************************************************************************************************************************************  
 
@@ -1463,13 +2450,13 @@ void writeChainInfo(struct MCMCvariables mcmc)
  * Finally, print the selected starting values to screen.
  */
 // ****************************************************************************************************************************************************  
-void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct interferometer *ifo[], struct runPar run)
+void startMCMCOffset(struct parSet *par, const struct MCMCvariables *mcmc, struct MCMCchain *chain, struct interferometer *ifo[], const struct likelihoodPar *likePar)
 {
   int i=0, iInj=0, nStart=0, nDiffPar=0;
   double db = 0.0;
   
   printf("\n");
-  mcmc->logL[mcmc->iTemp] = -9999.999;
+  chain->logL = -9999.999;
   
   
   // *** Set each MCMC parameter to either the best-guess value or the injection value, depending on the per-parameter settings - nothing random about this bit
@@ -1478,28 +2465,28 @@ void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct inte
     for(i=0;i<mcmc->nMCMCpar;i++) {
       
       //Start at or around BestValue:
-      if(mcmc->parStartMCMC[i]==1 || mcmc->parStartMCMC[i]==2) mcmc->param[mcmc->iTemp][i] = mcmc->parBestVal[i];
+      if(mcmc->parStartMCMC[i]==1 || mcmc->parStartMCMC[i]==2) chain->param[i] = mcmc->parBestVal[i];
       
       //Start at or around the injection value where possible:
       if(mcmc->offsetMCMC == 0 || mcmc->parStartMCMC[i]==3 || mcmc->parStartMCMC[i]==4) {
         iInj = mcmc->injRevID[mcmc->parID[i]];  //Get the index of this parameter in the injection set.  -1 if not available.
 	
         if(mcmc->injParUse[mcmc->parID[i]] == 1) {
-          mcmc->param[mcmc->iTemp][i] = mcmc->injParVal[iInj];  //Start at or around the injection value
+          chain->param[i] = mcmc->injParVal[iInj];  //Start at or around the injection value
         } else {
           if(mcmc->parID[i]==21 && mcmc->injID[i]==22) {
-            mcmc->param[mcmc->iTemp][i] = exp(3.0*mcmc->nParam[mcmc->iTemp][i]);  // Injection uses log(d), MCMC uses d^3
-            if(mcmc->beVerbose>=1) printf("   I translated  log(d_L/Mpc) = %lf  to  d_L^3 = %lf Mpc^3\n",mcmc->nParam[mcmc->iTemp][i],mcmc->param[mcmc->iTemp][i]);
+            chain->param[i] = exp(3.0*chain->nParam[i]);  // Injection uses log(d), MCMC uses d^3
+            if(mcmc->beVerbose>=1) printf("   I translated  log(d_L/Mpc) = %lf  to  d_L^3 = %lf Mpc^3\n",chain->nParam[i],chain->param[i]);
           } else if(mcmc->parID[i]==22 && mcmc->injID[i]==21) {
-            mcmc->param[mcmc->iTemp][i] = log(mcmc->nParam[mcmc->iTemp][i])/3.0;  // Injection uses d^3, MCMC uses log(d)
-            if(mcmc->beVerbose>=1) printf("   I translated  d_L^3 = %lf  to  log(d_L/Mpc) = %lf Mpc^3\n",mcmc->nParam[mcmc->iTemp][i],mcmc->param[mcmc->iTemp][i]);
+            chain->param[i] = log(chain->nParam[i])/3.0;  // Injection uses d^3, MCMC uses log(d)
+            if(mcmc->beVerbose>=1) printf("   I translated  d_L^3 = %lf  to  log(d_L/Mpc) = %lf Mpc^3\n",chain->nParam[i],chain->param[i]);
           } else {
-            mcmc->param[mcmc->iTemp][i] = mcmc->parBestVal[i];        // Set the MCMC parameter to BestValue - this should only happen if the injection waveform has different parameters than the MCMC waveform
+            chain->param[i] = mcmc->parBestVal[i];        // Set the MCMC parameter to BestValue - this should only happen if the injection waveform has different parameters than the MCMC waveform
             nDiffPar += 1;
           }
         }
       }
-      mcmc->nParam[mcmc->iTemp][i] = mcmc->param[mcmc->iTemp][i];
+      chain->nParam[i] = chain->param[i];
     } // for i...
     
     
@@ -1514,8 +2501,8 @@ void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct inte
     
   } else {  // if(mcmc->injectSignal <= 0), i.e., no signal injected; always use bestValue
     for(i=0;i<mcmc->nMCMCpar;i++) {
-      mcmc->nParam[mcmc->iTemp][i] = mcmc->parBestVal[i];
-      mcmc->param[mcmc->iTemp][i] = mcmc->nParam[mcmc->iTemp][i];
+      chain->nParam[i] = mcmc->parBestVal[i];
+      chain->param[i] = chain->nParam[i];
     }
   }
   
@@ -1525,41 +2512,41 @@ void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct inte
   
   // *** Add a random offset to the MCMC starting parameters:
   if(mcmc->offsetMCMC != 0) {
-    //while(mcmc->logL[mcmc->iTemp] < mcmc->minlogL+1.0) { // Accept only good starting values *** don't do this for starting values - only for updates later on ***
-    while(mcmc->logL[mcmc->iTemp] < 0.1) {   // Accept only good starting values
-      mcmc->acceptPrior[mcmc->iTemp] = 1;
+    //while(chain->logL < mcmc->minlogL+1.0) { // Accept only good starting values *** don't do this for starting values - only for updates later on ***
+    while(chain->logL < 0.1) {   // Accept only good starting values
+      chain->acceptPrior = 1;
       
       for(i=0;i<mcmc->nMCMCpar;i++) {  //For each MCMC parameter
         if(mcmc->parStartMCMC[i]==2 || mcmc->parStartMCMC[i]==4 || mcmc->parStartMCMC[i]==5) {  //Then find random offset parameters
 	  
           if(mcmc->parStartMCMC[i]==2 || mcmc->parStartMCMC[i]==4) {
-            mcmc->param[mcmc->iTemp][i] = mcmc->nParam[mcmc->iTemp][i] + gsl_ran_gaussian(mcmc->ran, mcmc->offsetX*mcmc->parSigma[i]);  //Gaussian with width offsetX*parSigma around either Injection or BestValue
+            chain->param[i] = chain->nParam[i] + gsl_ran_gaussian(mcmc->ran, mcmc->offsetX*mcmc->parSigma[i]);  //Gaussian with width offsetX*parSigma around either Injection or BestValue
           } else if(mcmc->parStartMCMC[i]==5) {
             db = mcmc->priorBoundUp[i]-mcmc->priorBoundLow[i];                                     // Width of range
-            mcmc->param[mcmc->iTemp][i] = mcmc->priorBoundLow[i] + gsl_rng_uniform(mcmc->ran)*db;        // Draw random number uniform on range with width db
+            chain->param[i] = mcmc->priorBoundLow[i] + gsl_rng_uniform(mcmc->ran)*db;        // Draw random number uniform on range with width db
           }
-          mcmc->acceptPrior[mcmc->iTemp] *= (int)prior(&mcmc->param[mcmc->iTemp][i],i,*mcmc);
+          chain->acceptPrior *= (int)prior(&chain->param[i],i,mcmc);
 	  
         } // if(mcmc->parStartMCMC[i]==2 || mcmc->parStartMCMC[i]==4 || mcmc->parStartMCMC[i]==5) {  //Then find random offset parameters
       } //i
       
-      if(mcmc->acceptPrior[mcmc->iTemp]==1) {                     //Check the value of the likelihood for this draw
-        arr2par(mcmc->param, par, *mcmc);                             //Get the parameters from their array
+      if(chain->acceptPrior==1) {                     //Check the value of the likelihood for this draw
+        arr2par(chain->param, par, mcmc);                            //Get the parameters from their array
         int injectionWF = 0;                                                 // Call netLogLikelihood with an MCMC waveform
-        localPar(par, ifo, mcmc->networkSize, injectionWF, run);
-        mcmc->logL[mcmc->iTemp] = netLogLikelihood(par, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, run);  //Calculate the likelihood
+        localPar(par, ifo, mcmc->networkSize, injectionWF, likePar);
+        chain->logL = netLogLikelihood(par, mcmc->networkSize, ifo, mcmc->mcmcWaveform, injectionWF, likePar);  //Calculate the likelihood
       }
       nStart = nStart + 1;
       
       
       // Print trial starting values to screen:
       if(mcmc->beVerbose>=1 && (nStart % mcmc->thinScreenOutput)==0) {
-        printf("%9d%10.3lf",nStart,max(mcmc->logL[mcmc->iTemp],-99999.999));
+        printf("%9d%10.3lf",nStart,max(chain->logL,-99999.999));
         for(i=0;i<mcmc->nMCMCpar;i++) {
           if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
-            printf(" %18.4f",mcmc->param[mcmc->iTemp][i]);
+            printf(" %18.4f",chain->param[i]);
           } else {
-            printf(" %9.4f",mcmc->param[mcmc->iTemp][i]);
+            printf(" %9.4f",chain->param[i]);
           }
         }
         printf("\n");
@@ -1567,7 +2554,7 @@ void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct inte
       
       if(mcmc->mcmcWaveform != mcmc->injectionWaveform && nDiffPar != 0 && nStart > 1e4) break;  //Don't require good logL if not all parameters match between injection and MCMC waveforms  *** This gives starting values much farther from the signal! *** -> do it after 10^4 trials
       
-    }  //while(mcmc->logL[mcmc->iTemp] < mcmc->minlogL+1.0) // Accept only good starting values
+    }  //while(chain->logL < mcmc->minlogL+1.0) // Accept only good starting values
   } //if(mcmc->offsetMCMC != 0)
   
   
@@ -1585,12 +2572,12 @@ void startMCMCOffset(struct parSet *par, struct MCMCvariables *mcmc, struct inte
   printf("\n");
   
   //Print parameter values:
-  printf("%9d%10.3lf",nStart,mcmc->logL[mcmc->iTemp]);
+  printf("%9d%10.3lf",nStart,chain->logL);
   for(i=0;i<mcmc->nMCMCpar;i++) {
     if(mcmc->parID[i]>=11 && mcmc->parID[i]<=19) {  //GPS time
-      printf(" %18.4f",mcmc->param[mcmc->iTemp][i]);
+      printf(" %18.4f",chain->param[i]);
     } else {
-      printf(" %9.4f",mcmc->param[mcmc->iTemp][i]);
+      printf(" %9.4f",chain->param[i]);
     }
   }
   printf("\n");
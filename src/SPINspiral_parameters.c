@@ -192,12 +192,16 @@ void readCommandLineOptions(int argc, char* argv[], struct runPar *run)
 		} else if (run->mcmcWaveform == 4) {
 			printf("    - From command line, mcmc template\t\t\t\t= %d\t 9-parameter NO SPIN LAL (Unless specified otherwise in an input file)\n",run->mcmcWaveform);
 			run->nMCMCpar=9;
+		} else if (run->mcmcWaveform == 6) {
+			printf("    - From command line, mcmc template\t\t\t\t= %d\t 9-parameter NO SPIN frequency-domain TaylorF2 (Unless specified otherwise in an input file)\n",run->mcmcWaveform);
+			run->nMCMCpar=9;
 		} else {
 			fprintf(stderr,"    - unknown waveform chosen as MCMC template: %d.   Available tested waveforms are:\n",run->mcmcWaveform);
 			fprintf(stderr,"        1: Apostolatos, simple precession, 12 parameters\n");
 			fprintf(stderr,"        2: LAL, single spin, 12 parameters\n");
 			fprintf(stderr,"        3: LAL, double spin, 15 parameters\n");
 			fprintf(stderr,"        4: LAL, non-spinnig, 9 parameters\n");
+			fprintf(stderr,"        6: TaylorF2, non-spinning, frequency domain, 9 parameters\n");
 			fprintf(stderr,"      Please set mcmcWaveform in %s to one of these values. Input file or default DOUBLE SPIN will be choosen.\n\n",run->mcmcFilename);
 		}
 		break;
@@ -506,9 +510,13 @@ void readMCMCinputfile(struct runPar *run)
 		//Correlated update proposals:
 		run->correlatedUpdates = 0;
 		run->corrFrac = 0.7;
+		run->deFrac = 0.0;
 		run->nCorr = 1000;
+		run->corrRefresh = 0;
 		run->matAccFr = 0.5;
 		run->prMatrixInfo = 0;
+		run->mtmFrac = 0.0;
+		run->mtmCandidates = 1;
 		
 		
 		//Annealing:
@@ -522,6 +530,22 @@ void readMCMCinputfile(struct runPar *run)
 		run->maxTemp = 40.0;
 		run->saveHotChains = 100;
 		run->prParTempInfo = 1;
+		run->nThreads = 1;
+		
+		//Likelihood:
+		run->likelihoodCache = 1;
+		run->relativeBinning = 0;
+		run->relBinEpsilon = 0.1;
+		run->relBinCheck = 1000;
+		run->relBinTolerance = 0.1;
+		run->likelihoodROQ = 0;
+		sprintf(run->roqFilename,"SPINspiral.roq");
+		run->roqTrainingSize = 1000;
+		run->roqTolerance = 1.e-8;
+		run->marginaliseTime = 0;
+		run->marginalisePhaseDist = 0;
+		run->multirateAccuracy = 0.0;
+		run->singlePrecision = 0;
 		
 		//Manual temperature ladder for parallel tempering:
 		run->tempLadder[0] = 1.00;
@@ -574,10 +598,39 @@ void readMCMCinputfile(struct runPar *run)
   cstatus = fgets(tmpStr,500,fin); cstatus = fgets(tmpStr,500,fin);  //Read the empty and comment line
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->correlatedUpdates);
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->corrFrac);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->deFrac);
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lg",&tmpdbl);
   run->nCorr = (int)tmpdbl;
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lg",&tmpdbl);
+  run->corrRefresh = (int)tmpdbl;
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->matAccFr);
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->prMatrixInfo);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->mtmFrac);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->mtmCandidates);
+  
+  // deFrac was inserted after corrFrac:  an input file of an older version would have its nCorr read as deFrac:
+  if(run->deFrac<0.0 || run->deFrac>1.0 || (run->deFrac>0.0 && run->deFrac + max(run->blockFrac,0.0) > 1.0)) {
+    fprintf(stderr, "\n\n   ERROR reading MCMC input file %s:  deFrac = %g must lie in [0,1], and deFrac + blockFrac (%g) must not exceed 1.\n", 
+            run->mcmcFilename, run->deFrac, run->blockFrac);
+    fprintf(stderr, "   Input files from older versions need the line deFrac after corrFrac, see doc/input_all/SPINspiral.input.mcmc.\n   Aborting...\n\n");
+    exit(1);
+  }
+  
+  // corrRefresh was inserted after nCorr;  it is a number of iterations (>=1), or 0 for nCorr:
+  if(run->corrRefresh<0 || (run->corrRefresh==0 && run->nCorr<1)) {
+    fprintf(stderr, "\n\n   ERROR reading MCMC input file %s:  corrRefresh = %d must be >= 1, or 0 with nCorr = %d >= 1.\n", 
+            run->mcmcFilename, run->corrRefresh, run->nCorr);
+    fprintf(stderr, "   Input files from older versions need the line corrRefresh after nCorr, see doc/input_all/SPINspiral.input.mcmc.\n   Aborting...\n\n");
+    exit(1);
+  }
+  
+  // mtmFrac and mtmCandidates were added after prMatrixInfo, and feed straight into multipleTryMCMCupdate():
+  if(run->mtmFrac<0.0 || run->mtmFrac>1.0 || run->mtmCandidates<1) {
+    fprintf(stderr, "\n\n   ERROR reading MCMC input file %s:  mtmFrac = %g must lie in [0,1], and mtmCandidates = %d must be >= 1.\n", 
+            run->mcmcFilename, run->mtmFrac, run->mtmCandidates);
+    fprintf(stderr, "   Input files from older versions need the lines mtmFrac and mtmCandidates after prMatrixInfo, see doc/input_all/SPINspiral.input.mcmc.\n   Aborting...\n\n");
+    exit(1);
+  }
   
   
   //Annealing:
@@ -595,6 +648,54 @@ void readMCMCinputfile(struct runPar *run)
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->maxTemp);
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->saveHotChains);
   cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->prParTempInfo);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->nThreads);
+  
+  //Likelihood:
+  cstatus = fgets(tmpStr,500,fin); cstatus = fgets(tmpStr,500,fin);  //Read the empty and comment line
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->likelihoodCache);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->relativeBinning);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->relBinEpsilon);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->relBinCheck);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->relBinTolerance);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->likelihoodROQ);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%s",run->roqFilename);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->roqTrainingSize);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->roqTolerance);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->marginaliseTime);
+  
+  // The time-marginalised likelihood needs <d|h> at all time shifts, which the shortcuts above don't provide:
+  if(run->marginaliseTime>=1) {
+    if(run->likelihoodCache>=1 || run->relativeBinning>=1 || run->likelihoodROQ==1) {
+      fprintf(stderr, "\n ***  Warning:  marginaliseTime switches off likelihoodCache, relativeBinning and likelihoodROQ ***\n\n");
+      run->likelihoodCache = 0;
+      run->relativeBinning = 0;
+      if(run->likelihoodROQ==1) run->likelihoodROQ = 0;
+    }
+  }
+  
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->marginalisePhaseDist);
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%lf",&run->multirateAccuracy);
+  
+  // The phase- and distance-marginalised likelihood needs the complex overlap <d|h> of the whole band:
+  if(run->marginalisePhaseDist>=1) {
+    if(run->marginaliseTime>=1) {
+      fprintf(stderr, "\n ***  Warning:  marginalisePhaseDist cannot be combined with marginaliseTime;  sampling phi_c and d_L ***\n\n");
+      run->marginalisePhaseDist = 0;
+    } else if(run->likelihoodCache>=1 || run->relativeBinning>=1 || run->likelihoodROQ==1) {
+      fprintf(stderr, "\n ***  Warning:  marginalisePhaseDist switches off likelihoodCache, relativeBinning and likelihoodROQ ***\n\n");
+      run->likelihoodCache = 0;
+      run->relativeBinning = 0;
+      if(run->likelihoodROQ==1) run->likelihoodROQ = 0;
+    }
+  }
+  
+  cstatus = fgets(tmpStr,500,fin);  sscanf(tmpStr,"%d",&run->singlePrecision);
+  
+  // The marginalised likelihoods use the double-precision template FFT:
+  if(run->singlePrecision==1 && (run->marginaliseTime>=1 || run->marginalisePhaseDist>=1)) {
+    fprintf(stderr, "\n ***  Warning:  singlePrecision cannot be combined with marginaliseTime or marginalisePhaseDist;  using double precision ***\n\n");
+    run->singlePrecision = 0;
+  }
   
   //Manual temperature ladder for parallel tempering:
   cstatus = fgets(tmpStr,500,fin); cstatus = fgets(tmpStr,500,fin); //Read the empty and comment line
@@ -928,6 +1029,10 @@ void readInjectionInputfile(struct runPar *run)
 	} else if(run->injectionWaveform==9) {
 	  if(run->beVerbose>=1) printf("    - using analytic Likelihood.\n");
 	  run->nInjectPar=15;		
+    } else if(frequencyDomainTemplate(run->injectionWaveform)) {
+      fprintf(stderr,"    - waveform %d is computed in the frequency domain and cannot be used for a software injection.\n",run->injectionWaveform);
+      fprintf(stderr,"      Please set injectionWaveform in %s to 4 for a non-spinning injection.\n\n",run->injectionFilename);
+      exit(1);
     } else {
       fprintf(stderr,"    - unknown waveform chosen as MCMC template: %d.   Available waveforms are:\n",run->injectionWaveform);
       fprintf(stderr,"        1: Apostolatos, simple precession, 12 parameters\n");
@@ -1099,9 +1204,10 @@ void readParameterInputfile(struct runPar *run)
 		run->offsetMCMC = 1;
 		run->offsetX = 10.0;	
 		
-		if(run->commandSettingsFlag[17] == 1 && run->mcmcWaveform == 4) {
+		if(run->commandSettingsFlag[17] == 1 && (run->mcmcWaveform == 4 || run->mcmcWaveform == 6)) {
 			
-			if(run->beVerbose>=1) printf("    - using LAL,%4.1f-pN, 9-parameter non-spinning waveform as the MCMC template.\n",run->mcmcPNorder);
+			if(run->beVerbose>=1 && run->mcmcWaveform == 4) printf("    - using LAL,%4.1f-pN, 9-parameter non-spinning waveform as the MCMC template.\n",run->mcmcPNorder);
+			if(run->beVerbose>=1 && run->mcmcWaveform == 6) printf("    - using TaylorF2,%4.1f-pN, 9-parameter non-spinning frequency-domain waveform as the MCMC template.\n",run->mcmcPNorder);
 			run->nMCMCpar=9;
 			
 			for(i=0;i<run->nMCMCpar;i++) {
@@ -1335,6 +1441,9 @@ void readParameterInputfile(struct runPar *run)
   } else if(run->mcmcWaveform==5) {
 	if(run->beVerbose>=1) printf("    - using LAL,%4.1f-pN, 15-parameter PhenSpinTaylorRD waveform as the MCMC template.\n",run->mcmcPNorder);
 	run->nMCMCpar=15;	  
+  } else if(run->mcmcWaveform==6) {
+    if(run->beVerbose>=1) printf("    - using TaylorF2,%4.1f-pN, non-spinning frequency-domain waveform as the MCMC template.\n",run->mcmcPNorder);
+    run->nMCMCpar=9;
   } else if(run->mcmcWaveform==9) {
 	if(run->beVerbose>=1) printf("    - using analytic Likelihood.\n");
 	run->nMCMCpar=15;			  
@@ -1344,6 +1453,7 @@ void readParameterInputfile(struct runPar *run)
     fprintf(stderr,"        2: LAL, single spin, 12 parameters\n");
     fprintf(stderr,"        3: LAL, double spin, 15 parameters\n");
     fprintf(stderr,"        4: LAL, non-spinnig, 9 parameters\n");
+    fprintf(stderr,"        6: TaylorF2, non-spinning, frequency domain, 9 parameters\n");
 	fprintf(stderr,"        9: LAL, analytic Likelihood\n");
     fprintf(stderr,"      Please set mcmcWaveform in %s to one of these values.\n\n",run->mcmcFilename);
     exit(1);
@@ -1516,6 +1626,59 @@ void readParameterInputfile(struct runPar *run)
 	}
   
   
+  // Time-marginalised likelihood:  t_c is no longer sampled, but fixed at its starting value, which serves as the reference for the time 
+  //   shifts.  The marginalisation covers the prior range of t_c:
+  run->tMargLow = 0.0;
+  run->tMargUp = 0.0;
+  if(run->marginaliseTime>=1) {
+    i = run->parRevID[11];
+    if(i<0) {
+      fprintf(stderr, "\n\n   ERROR:  marginaliseTime needs t_c (parameter ID 11) as an MCMC parameter.\n   Aborting...\n\n");
+      exit(1);
+    }
+    if(run->parFix[i]==0) run->parFix[i] = 1;
+    if(run->parStartMCMC[i]==2 || run->parStartMCMC[i]==4) run->parStartMCMC[i] -= 1;   // Start at the best or injection value, without an offset
+    if(run->parStartMCMC[i]==5) run->parStartMCMC[i] = 1;
+    run->tMargLow = run->priorBoundLow[i];
+    run->tMargUp  = run->priorBoundUp[i];
+    if(run->beVerbose>=1) printf("    - %s the likelihood over t_c, which is therefore not sampled.\n", run->marginaliseTime==2 ? "maximising" : "marginalising");
+  }
+  
+  // Phase- and distance-marginalised likelihood:  phi_c and/or d_L are fixed at their starting values, which define the reference 
+  //   template, and are drawn from their conditional posterior when the chain is written to disc (see drawPhaseDistance()):
+  if(run->marginalisePhaseDist>=1) {
+    int margID[2] = {0,0};
+    // The phase integral assumes h(f) = h_0(f) exp(i m phi_c), the distance integral h(f) = h_0(f) / d_L:
+    int phaseOK = (run->marginalisePhaseDist==2 || waveformCapability(run->mcmcWaveform, wfPhaseFactor));
+    int distOK  = (run->marginalisePhaseDist<2  || waveformCapability(run->mcmcWaveform, wfDistanceScaling));
+    if(!phaseOK || !distOK) {
+      fprintf(stderr, "\n\n   ERROR:  marginalisePhaseDist=%d is not available for mcmcWaveform %d, whose template does not scale as %s.\n   Aborting...\n\n",
+              run->marginalisePhaseDist, run->mcmcWaveform, phaseOK ? "1/d_L" : "exp(i m phi_c)");
+      exit(1);
+    }
+    if(run->marginalisePhaseDist!=2) margID[0] = 41;                                  // 41: phi_c
+    if(run->marginalisePhaseDist>=2) {
+      margID[1] = 22;                                                                 // 22: log(d_L)
+      if(run->parRevID[22]<0) margID[1] = 21;                                         // 21: d_L^3
+    }
+    for(iInj=0;iInj<2;iInj++) {
+      if(margID[iInj]==0) continue;
+      i = run->parRevID[margID[iInj]];
+      if(i<0) {
+        fprintf(stderr, "\n\n   ERROR:  marginalisePhaseDist=%d needs %s as an MCMC parameter.\n   Aborting...\n\n",
+                run->marginalisePhaseDist, iInj==0 ? "phi_c (parameter ID 41)" : "d_L (parameter ID 21 or 22)");
+        exit(1);
+      }
+      if(run->parFix[i]==0) run->parFix[i] = 1;
+      if(run->parStartMCMC[i]==2 || run->parStartMCMC[i]==4) run->parStartMCMC[i] -= 1;   // Start at the best or injection value, without an offset
+      if(run->parStartMCMC[i]==5) run->parStartMCMC[i] = 1;
+    }
+    if(run->beVerbose>=1) printf("    - marginalising the likelihood over %s, which %s therefore not sampled.\n", 
+                                 run->marginalisePhaseDist==1 ? "phi_c" : (run->marginalisePhaseDist==2 ? "d_L" : "phi_c and d_L"),
+                                 run->marginalisePhaseDist==3 ? "are" : "is");
+  }
+  
+  
   //Print MCMC parameters and prior ranges to screen:
   char FixStr[3][99];
   strcpy(FixStr[0],"No, let it free");
@@ -2013,6 +2176,80 @@ void setParameterNames(struct runPar * run)
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Copy the elements of the struct runPar that are needed to compute templates and likelihoods to run->likePar
+ *
+ * This must be called after all input files have been read, and before the first template is computed (i.e., before IFOinit()).
+ */
+// ****************************************************************************************************************************************************  
+void setLikelihoodPar(struct runPar *run)
+{
+  int i=0;
+  struct likelihoodPar *likePar = &run->likePar;
+  
+  likePar->nMCMCpar = run->nMCMCpar;                    // Number of mcmc/template parameters
+  likePar->nInjectPar = run->nInjectPar;                // Number of injection parameters
+  likePar->mcmcPNorder = run->mcmcPNorder;              // pN order used for MCMC template
+  likePar->injectionPNorder = run->injectionPNorder;    // pN order used for injection template
+  likePar->tukey1 = run->tukey1;                        // Parameters of the modified Tukey window applied to the templates
+  likePar->tukey2 = run->tukey2;
+  likePar->marginaliseTime = run->marginaliseTime;      // Marginalise or maximise the likelihood over t_c
+  likePar->tMargLow = run->tMargLow;                    // Prior range of t_c for that
+  likePar->tMargUp = run->tMargUp;
+  likePar->marginalisePhaseDist = run->marginalisePhaseDist;  // Marginalise over phi_c and/or d_L
+  likePar->multirateAccuracy = run->multirateAccuracy;  // Accuracy of the multirate template
+  likePar->multirateCycles = 0.0;                       // Full rate, until setMultirateTemplate() has checked the multirate template
+  
+  //Parameter database:
+  for(i=0;i<run->parDBn;i++) {
+    likePar->injRevID[i] = run->injRevID[i];
+    likePar->parRevID[i] = run->parRevID[i];
+    likePar->mcmcParUse[i] = run->mcmcParUse[i];
+    likePar->injParUse[i]  = run->injParUse[i];
+  }
+  
+  // Lookup table for the distance marginalisation, evenly spaced in log(d_L) over the prior range, with the prior as weights:
+  likePar->distMargN = 0;
+  likePar->distMargD = NULL;
+  likePar->distMargLogW = NULL;
+  if(run->marginalisePhaseDist>=2) {
+    int distID = (run->parRevID[22]>=0) ? 22 : 21;
+    double logDlow=0.0, logDup=0.0, maxW=-1.e30, sumW=0.0;
+    
+    i = run->parRevID[distID];
+    if(distID==22) {                                                                  // 22: log(d_L), flat prior in log(d_L)
+      logDlow = run->priorBoundLow[i];
+      logDup  = run->priorBoundUp[i];
+    } else {                                                                          // 21: d_L^3, flat prior in d_L^3
+      logDup  = log(run->priorBoundUp[i])/3.0;
+      logDlow = (run->priorBoundLow[i] > 0.0) ? log(run->priorBoundLow[i])/3.0 : logDup - log(1000.0);
+    }
+    
+    likePar->distMargN = 1000;
+    likePar->distMargD = (double*)malloc(sizeof(double) * likePar->distMargN);
+    likePar->distMargLogW = (double*)malloc(sizeof(double) * likePar->distMargN);
+    for(i=0;i<likePar->distMargN;i++) {
+      likePar->distMargD[i] = exp(logDlow + (i+0.5)/(double)likePar->distMargN * (logDup-logDlow));
+      likePar->distMargLogW[i] = (distID==22) ? 0.0 : 3.0*log(likePar->distMargD[i]);   // p(log d_L) is constant or proportional to d_L^3
+      maxW = max(maxW, likePar->distMargLogW[i]);
+    }
+    for(i=0;i<likePar->distMargN;i++) sumW += exp(likePar->distMargLogW[i]-maxW);
+    for(i=0;i<likePar->distMargN;i++) likePar->distMargLogW[i] -= maxW + log(sumW);
+  }
+  
+} // End setLikelihoodPar()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+
+
+
+
 // ****************************************************************************************************************************************************  
 /**
  * \brief Copy some of the elements of the struct runPar to the struct MCMCvariables
@@ -2038,6 +2275,9 @@ void copyRun2MCMC(struct runPar run, struct MCMCvariables *mcmc)
   mcmc->seed = run.MCMCseed;                            // MCMC seed
   mcmc->blockFrac = run.blockFrac;                      // Fraction of non-correlated updates that is a block update
   mcmc->corrFrac = run.corrFrac;                        // Fraction of MCMC updates that used the correlation matrix
+  mcmc->deFrac = run.deFrac;                            // Fraction of uncorrelated MCMC updates that is a differential-evolution update
+  mcmc->mtmFrac = run.mtmFrac;                          // Fraction of correlated updates that is a multiple-try Metropolis update
+  mcmc->mtmCandidates = run.mtmCandidates;              // Number of candidates of a multiple-try Metropolis update
   mcmc->matAccFr = run.matAccFr;                        // Fraction of elements on the diagonal that must 'improve' in order to accept a new covariance matrix
   mcmc->offsetMCMC = run.offsetMCMC;                    // Start MCMC offset (i.e., not from injection values) or not
   mcmc->offsetX = run.offsetX;                          // Start offset chains from a Gaussian distribution offsetX times wider than parSigma
@@ -2052,6 +2292,7 @@ void copyRun2MCMC(struct runPar run, struct MCMCvariables *mcmc)
   
   mcmc->correlatedUpdates = run.correlatedUpdates;      // Switch to do correlated update proposals
   mcmc->nCorr = run.nCorr;                              // Number of iterations for which the covariance matrix is calculated
+  mcmc->corrRefresh = (run.corrRefresh>0) ? run.corrRefresh : run.nCorr;  // Number of iterations between updates of the proposal matrix
   mcmc->prMatrixInfo = run.prMatrixInfo;                // Print information to screen on proposed matrix updates
   
   mcmc->annealTemp0 = run.annealTemp0;                  // Starting temperature of the annealed chain
@@ -2062,9 +2303,15 @@ void copyRun2MCMC(struct runPar run, struct MCMCvariables *mcmc)
   mcmc->maxTemp = run.maxTemp;                          // Maximum temperature in automatic parallel-tempering ladder
   mcmc->saveHotChains = run.saveHotChains;              // Save hot (T>1) parallel-tempering chains
   mcmc->prParTempInfo = run.prParTempInfo;              // Print information on the temperature chains
+  mcmc->nThreads = run.nThreads;                        // Number of threads to update the temperature chains on
   
+  mcmc->likelihoodCache = run.likelihoodCache;          // Reuse <d|h> and <h|h> for distance-only proposals, the intrinsic template for extrinsic ones
+  mcmc->relativeBinning = run.relativeBinning;          // Use the relative-binning likelihood
+  mcmc->relBinCheck = run.relBinCheck;                  // Check the relative-binning likelihood every relBinCheck iterations
+  mcmc->relBinTolerance = run.relBinTolerance;          // Maximum difference in log(L) for that check
+  mcmc->marginaliseTime = run.marginaliseTime;          // Marginalise or maximise the likelihood over t_c
+  mcmc->marginalisePhaseDist = run.marginalisePhaseDist;  // Marginalise the likelihood over phi_c and/or d_L
   
-  mcmc->chTemp = max(mcmc->annealTemp0,1.0);            // Current temperature
   
   mcmc->geocentricTc = run.geocentricTc;                // Geocentric Tc
   mcmc->baseTime = (double)((floor)(mcmc->geocentricTc/100.0)*100);  //'Base' time, gets rid of the first 6-7 digits of GPS time
@@ -2120,37 +2367,6 @@ void copyRun2MCMC(struct runPar run, struct MCMCvariables *mcmc)
 
 
 
-// ****************************************************************************************************************************************************  
-/** 
- * \brief Set global variables
- *
- * \todo This routine should eventually contain mathematical and (astro)physical constants only.
- */
-// ****************************************************************************************************************************************************  
-void setConstants()
-{
-  // Mathematical constants:
-  pi   = 3.141592653589793;   // pi
-  tpi  = 6.283185307179586;   // 2 pi
-  mtpi = 6.283185307179586e6; // Large multiple of 2 pi (2 megapi)
-  
-  // Define some physical constants:
-  G    = 6.67259e-11;         // 6.674215e-11; */ /* gravity constant (SI)
-  c    = 299792458.0;         // speed of light (m/s)
-  
-  Ms   = 1.9889194662e30;     // solar mass (kg)
-  Mpc  = 3.08568025e22;       // metres in a Mpc  (LAL: 3.0856775807e22)
-  Mpcs = 1.029272137e14;      // seconds in a Mpc  (Mpc/c)
-} // End setConstants
-// ****************************************************************************************************************************************************  
-
-
-
-
-
-
-
-
 // ****************************************************************************************************************************************************  
 /** 
  * \brief Returns the 'injection values' to the parameter set par
@@ -2158,7 +2374,7 @@ void setConstants()
  * \todo Remove par->mc etc. struct elements
  */
 // ****************************************************************************************************************************************************  
-void getInjectionParameters(struct parSet *par, int nInjectionPar, double *injParVal)
+void getInjectionParameters(struct parSet *par, int nInjectionPar, const double *injParVal)
 {
   int i=0;
   for(i=0;i<nInjectionPar;i++) {
@@ -0,0 +1,516 @@
+/* 
+   
+   SPINspiral:                parameter estimation on binary inspirals detected by LIGO, including spins of the binary members
+   SPINspiral_roq.c:          routines to build, read and use a reduced-order-quadrature basis for the likelihood
+   
+   
+   Copyright 2007-2011 Christian Roever, Marc van der Sluys, Vivien Raymond, Ilya Mandel
+   
+   
+   This file is part of SPINspiral.
+   
+   SPINspiral is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   
+   SPINspiral is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with SPINspiral.  If not, see <http://www.gnu.org/licenses/>.
+   
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <SPINspiral.h>
+
+
+/**
+ * \file SPINspiral_roq.c
+ * \brief Contains routines to build, read and use a reduced-order-quadrature (ROQ) basis for the likelihood
+ *
+ * With an ROQ basis (Canizares et al. 2013, 2015), a template h on the Fourier frequencies f_k of the band is interpolated from its
+ * values at a small number of nodes F_j:  h(f_k) = sum_j B_j(f_k) h(F_j), and similarly |h(f_k)|^2 = sum_j C_j(f_k) |h(G_j)|^2.
+ * The data and noise weights can then be contracted with the interpolants once, so that <d|h> and <h|h> follow from the template
+ * at the nodes only.
+ *
+ * The basis is built offline (likelihoodROQ = 2) and saved to a binary file in the native byte order:
+ *   - char[8] "SPINROQ", int file version, int waveformVersion, int number of IFOs;
+ *   - for each IFO:  char[16] name, int lowIndex, int indexRange, double deltaFT, then the linear and quadratic interpolants, each as
+ *     int nNodes, int[nNodes] node indices in the band, and nNodes rows of indexRange values (complex (re,im) pairs for B, doubles for C).
+ */
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Build the ROQ basis for the current IFOs, frequency band and prior ranges, and save it to run.roqFilename
+ *
+ * The training set consists of run.roqTrainingSize MCMC templates with parameters drawn uniformly from the prior ranges;  fixed parameters
+ * are kept at their best values.
+ */
+// ****************************************************************************************************************************************************  
+void buildROQbasis(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int i=0, p=0, ifonr=0, nLin=0, nQuad=0;
+  int fileVersion = 1;
+  int nTrain = run.roqTrainingSize;
+  char magic[8] = "SPINROQ";
+  FILE *fout;
+  
+  if(!frequencyDomainTemplate(run.mcmcWaveform)) {
+    fprintf(stderr,"\n\n   ERROR:  a reduced-order-quadrature basis can only be built for a frequency-domain MCMC template (mcmcWaveform 6).\n   Aborting...\n\n");
+    exit(1);
+  }
+  if(nTrain < 1) {
+    fprintf(stderr,"\n\n   ERROR:  roqTrainingSize must be positive to build a reduced-order-quadrature basis.\n   Aborting...\n\n");
+    exit(1);
+  }
+  
+  
+  // Draw the training parameter sets from the prior ranges:
+  gsl_rng *ran = gsl_rng_alloc(gsl_rng_mt19937);
+  gsl_rng_set(ran, run.MCMCseed);
+  double **trainPar = (double**)calloc(nTrain,sizeof(double*));
+  for(i=0;i<nTrain;i++) {
+    trainPar[i] = (double*)calloc(run.nMCMCpar,sizeof(double));
+    for(p=0;p<run.nMCMCpar;p++) {
+      if(run.parFix[p]==0) {
+        trainPar[i][p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+      } else {
+        trainPar[i][p] = run.parBestVal[p];
+      }
+    }
+  }
+  gsl_rng_free(ran);
+  
+  
+  fout = fopen(run.roqFilename,"wb");
+  if(fout==NULL) {
+    fprintf(stderr,"\n\n   ERROR opening the ROQ basis file %s for writing.\n   Aborting...\n\n",run.roqFilename);
+    exit(1);
+  }
+  fwrite(magic, sizeof(char), 8, fout);
+  fwrite(&fileVersion, sizeof(int), 1, fout);
+  fwrite(&run.mcmcWaveform, sizeof(int), 1, fout);
+  fwrite(&networkSize, sizeof(int), 1, fout);
+  
+  for(ifonr=0;ifonr<networkSize;ifonr++) {
+    printf("   Building the ROQ basis for %s from %d training templates (%d frequencies)...\n",ifo[ifonr]->name,nTrain,ifo[ifonr]->indexRange);
+    fwrite(ifo[ifonr]->name, sizeof(char), 16, fout);
+    fwrite(&ifo[ifonr]->lowIndex, sizeof(int), 1, fout);
+    fwrite(&ifo[ifonr]->indexRange, sizeof(int), 1, fout);
+    fwrite(&ifo[ifonr]->deltaFT, sizeof(double), 1, fout);
+  
+    nLin  = buildROQinterpolant(ifo, networkSize, ifonr, trainPar, nTrain, 0, run, fout);
+    nQuad = buildROQinterpolant(ifo, networkSize, ifonr, trainPar, nTrain, 1, run, fout);
+    printf("   %s:  %d linear and %d quadratic ROQ nodes.\n",ifo[ifonr]->name,nLin,nQuad);
+  }
+  
+  fclose(fout);
+  printf("   ROQ basis saved to %s.\n\n",run.roqFilename);
+  
+  for(i=0;i<nTrain;i++) free(trainPar[i]);
+  free(trainPar);
+} // End buildROQbasis()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Build a reduced basis and its empirical interpolant for IFO ifonr, and write the interpolant to fout
+ *
+ * The reduced basis is built with a greedy algorithm:  add the training template with the largest projection error onto the current
+ * basis until that error is below run.roqTolerance.  The training templates are recomputed rather than stored, so that the memory use
+ * does not scale with the size of the training set.  The interpolation nodes are then chosen with the empirical interpolation method.
+ * For quadratic=0 the basis is for h, for quadratic=1 it is for |h|^2.  Returns the number of nodes.
+ */
+// ****************************************************************************************************************************************************  
+int buildROQinterpolant(struct interferometer *ifo[], int networkSize, int ifonr, double **trainPar, int nTrain, int quadratic, struct runPar run, FILE *fout)
+{
+  int i=0, j=0, k=0, m=0, iter=0, iPick=0, nBasis=0;
+  int nFreq = ifo[ifonr]->indexRange;
+  int nMax = min(nTrain, nFreq);
+  double norm=0.0, maxErr=0.0, absMax=0.0, value=0.0;
+  fftw_complex c;
+  struct parSet par;
+  
+  allocParset(&par, networkSize);
+  fftw_complex *h = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * nFreq);
+  fftw_complex **basis = (fftw_complex**)calloc(nMax,sizeof(fftw_complex*));
+  double *err = (double*)calloc(nTrain,sizeof(double));
+  
+  
+  // Templates that vanish in the band (e.g. f_ISCO < f_low) don't need to be represented:
+  iPick = -1;
+  for(i=0;i<nTrain;i++) {
+    err[i] = (roqTrainingTemplate(&par, trainPar[i], ifo, networkSize, ifonr, quadratic, run, h) > 0.0) ? 1.0 : 0.0;
+    if(iPick<0 && err[i]>0.0) iPick = i;
+  }
+  if(iPick<0) {
+    fprintf(stderr,"\n\n   ERROR:  all ROQ training templates vanish in the frequency band of %s.\n   Aborting...\n\n",ifo[ifonr]->name);
+    exit(1);
+  }
+  
+  
+  // Greedy reduced basis:
+  while(nBasis<nMax) {
+    roqTrainingTemplate(&par, trainPar[iPick], ifo, networkSize, ifonr, quadratic, run, h);
+  
+    for(iter=0;iter<2;iter++) {                                                    // Modified Gram-Schmidt, twice for numerical stability
+      for(m=0;m<nBasis;m++) {
+        c = 0.0;
+        for(k=0;k<nFreq;k++) c += conj(basis[m][k])*h[k];
+        for(k=0;k<nFreq;k++) h[k] -= c*basis[m][k];
+      }
+    }
+    norm = 0.0;
+    for(k=0;k<nFreq;k++) norm += creal(h[k]*conj(h[k]));
+    norm = sqrt(norm);
+    if(norm < 1.e-10) break;                                                       // The training set is spanned to machine precision
+  
+    basis[nBasis] = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * nFreq);
+    for(k=0;k<nFreq;k++) basis[nBasis][k] = h[k]/norm;
+    nBasis += 1;
+  
+    // Update the projection errors of the training templates with the new basis vector, and pick the worst one:
+    maxErr = 0.0;
+    for(i=0;i<nTrain;i++) {
+      if(err[i]<=0.0) continue;
+      roqTrainingTemplate(&par, trainPar[i], ifo, networkSize, ifonr, quadratic, run, h);
+      c = 0.0;
+      for(k=0;k<nFreq;k++) c += conj(basis[nBasis-1][k])*h[k];
+      err[i] -= creal(c*conj(c));
+      if(err[i] > maxErr) {
+        maxErr = err[i];
+        iPick = i;
+      }
+    }
+    if(run.beVerbose>=2) printf("     %s basis vector %4d:  maximum squared projection error %10.3e\n",quadratic?"quadratic":"linear",nBasis,maxErr);
+    if(maxErr < run.roqTolerance) break;
+  }
+  if(maxErr >= run.roqTolerance) fprintf(stderr, "\n ***  Warning:  the ROQ basis for %s reached %d vectors with a maximum squared projection error of %g ***\n\n",
+                                         ifo[ifonr]->name,nBasis,maxErr);
+  
+  
+  // Empirical interpolation:  each new node is where the interpolant of the next basis vector on the current nodes is worst:
+  int *node = (int*)calloc(nBasis,sizeof(int));
+  int *perm = (int*)calloc(nBasis,sizeof(int));
+  fftw_complex *V = (fftw_complex*)malloc(sizeof(fftw_complex) * nBasis*nBasis);
+  fftw_complex *coef = (fftw_complex*)malloc(sizeof(fftw_complex) * nBasis);
+  
+  for(j=0;j<nBasis;j++) {
+    for(i=0;i<j;i++) {
+      for(m=0;m<j;m++) V[i*j+m] = basis[m][node[i]];
+      coef[i] = basis[j][node[i]];
+    }
+    if(j>0) {
+      complexLUdecompose(V, j, perm);
+      complexLUsolve(V, j, perm, coef);
+    }
+  
+    absMax = -1.0;
+    for(k=0;k<nFreq;k++) {
+      c = basis[j][k];
+      for(m=0;m<j;m++) c -= coef[m]*basis[m][k];
+      if(cabs(c) > absMax) {
+        absMax = cabs(c);
+        node[j] = k;
+      }
+    }
+  }
+  
+  
+  // The interpolant B = E V^-1, with E the basis and V_jm = E_m(F_j), satisfies B_j(F_m) = delta_jm.  Write it one B_j at a time:
+  for(i=0;i<nBasis;i++) for(m=0;m<nBasis;m++) V[i*nBasis+m] = basis[m][node[i]];
+  complexLUdecompose(V, nBasis, perm);
+  
+  fwrite(&nBasis, sizeof(int), 1, fout);
+  fwrite(node, sizeof(int), nBasis, fout);
+  for(j=0;j<nBasis;j++) {
+    for(m=0;m<nBasis;m++) coef[m] = (m==j) ? 1.0 : 0.0;
+    complexLUsolve(V, nBasis, perm, coef);                                         // Column j of V^-1
+    for(k=0;k<nFreq;k++) {
+      c = 0.0;
+      for(m=0;m<nBasis;m++) c += basis[m][k]*coef[m];
+      if(quadratic) {
+        value = creal(c);
+        fwrite(&value, sizeof(double), 1, fout);
+      } else {
+        fwrite((double*)&c, sizeof(double), 2, fout);
+      }
+    }
+  }
+  
+  
+  for(m=0;m<nBasis;m++) fftw_free(basis[m]);
+  free(basis);
+  free(node);
+  free(perm);
+  free(V);
+  free(coef);
+  free(err);
+  fftw_free(h);
+  freeParset(&par);
+  
+  return nBasis;
+} // End buildROQinterpolant()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute a normalised ROQ training template on the frequency band of IFO ifonr
+ *
+ * For quadratic=1, h contains |h|^2 (as a real number).  Returns the norm of h (or |h|^2) before normalisation.
+ */
+// ****************************************************************************************************************************************************  
+double roqTrainingTemplate(struct parSet *par, const double *trainPar, struct interferometer *ifo[], int networkSize, int ifonr, int quadratic, struct runPar run, fftw_complex *h)
+{
+  int i=0, k=0;
+  int injectionWF = 0;                                                             // The training templates are MCMC templates
+  int nFreq = ifo[ifonr]->indexRange;
+  double norm=0.0;
+  
+  for(i=0;i<run.nMCMCpar;i++) par->par[i] = trainPar[i];
+  par->nPar = run.nMCMCpar;
+  localPar(par, ifo, networkSize, injectionWF, &run.likePar);
+  waveformTemplateFDfreq(par, ifo, ifonr, run.mcmcWaveform, injectionWF, &run.likePar, ifo[ifonr]->bandFreq, nFreq, (double*)h);
+  
+  if(quadratic) for(k=0;k<nFreq;k++) h[k] = creal(h[k]*conj(h[k]));
+  
+  for(k=0;k<nFreq;k++) norm += creal(h[k]*conj(h[k]));
+  norm = sqrt(norm);
+  if(norm > 0.0) for(k=0;k<nFreq;k++) h[k] /= norm;
+  
+  return norm;
+} // End roqTrainingTemplate()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Read the ROQ basis for this IFO from run.roqFilename, and contract it with the data and noise weights
+ *
+ * Must be called after the weighted data have been computed in IFOinit().  The interpolants themselves are not kept in memory.
+ */
+// ****************************************************************************************************************************************************  
+void readROQbasis(struct interferometer *ifo, struct runPar run)
+{
+  int b=0, j=0, k=0, n=0, fileVersion=0, waveformVersion=0, nIFO=0, lowIndex=0, indexRange=0, found=0;
+  size_t nRead = 0;
+  double deltaFT=0.0;
+  char magic[8], name[16];
+  FILE *fin;
+  
+  fin = fopen(run.roqFilename,"rb");
+  if(fin==NULL) {
+    fprintf(stderr,"\n\n   ERROR opening the ROQ basis file %s.  Build it first with likelihoodROQ = 2.\n   Aborting...\n\n",run.roqFilename);
+    exit(1);
+  }
+  nRead += fread(magic, sizeof(char), 8, fin);
+  nRead += fread(&fileVersion, sizeof(int), 1, fin);
+  nRead += fread(&waveformVersion, sizeof(int), 1, fin);
+  nRead += fread(&nIFO, sizeof(int), 1, fin);
+  if(nRead != 11 || strncmp(magic,"SPINROQ",8)!=0 || fileVersion!=1) {
+    fprintf(stderr,"\n\n   ERROR:  %s is not a SPINspiral ROQ basis file (version 1).\n   Aborting...\n\n",run.roqFilename);
+    exit(1);
+  }
+  if(waveformVersion != run.mcmcWaveform) {
+    fprintf(stderr,"\n\n   ERROR:  the ROQ basis in %s was built for waveform %d, not for mcmcWaveform %d.\n   Aborting...\n\n",
+            run.roqFilename,waveformVersion,run.mcmcWaveform);
+    exit(1);
+  }
+  
+  
+  for(b=0;b<nIFO;b++) {
+    nRead  = fread(name, sizeof(char), 16, fin);
+    nRead += fread(&lowIndex, sizeof(int), 1, fin);
+    nRead += fread(&indexRange, sizeof(int), 1, fin);
+    nRead += fread(&deltaFT, sizeof(double), 1, fin);
+    if(nRead != 19) break;
+  
+    if(strncmp(name,ifo->name,16)!=0) {                                            // Skip the interpolants of this IFO
+      nRead = fread(&n, sizeof(int), 1, fin);
+      fseek(fin, (long)n*sizeof(int) + (long)n*indexRange*2*sizeof(double), SEEK_CUR);
+      nRead += fread(&n, sizeof(int), 1, fin);
+      fseek(fin, (long)n*sizeof(int) + (long)n*indexRange*sizeof(double), SEEK_CUR);
+      if(nRead != 2) break;
+      continue;
+    }
+  
+    if(lowIndex != ifo->lowIndex || indexRange != ifo->indexRange || fabs(deltaFT-ifo->deltaFT) > 1.e-9*ifo->deltaFT) {
+      fprintf(stderr,"\n\n   ERROR:  the ROQ basis in %s was built for a different frequency band or data length for %s:\n",run.roqFilename,ifo->name);
+      fprintf(stderr,"     basis:  %d frequencies from index %d, %g s;  data:  %d frequencies from index %d, %g s.\n",
+              indexRange,lowIndex,deltaFT,ifo->indexRange,ifo->lowIndex,ifo->deltaFT);
+      fprintf(stderr,"   Rebuild the basis with likelihoodROQ = 2.\n   Aborting...\n\n");
+      exit(1);
+    }
+    found = 1;
+    break;
+  }
+  if(!found) {
+    fprintf(stderr,"\n\n   ERROR:  no ROQ basis for %s in %s.\n   Aborting...\n\n",ifo->name,run.roqFilename);
+    exit(1);
+  }
+  
+  int *node = NULL;
+  fftw_complex *B = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * ifo->indexRange);
+  double *C = (double*)malloc(sizeof(double) * ifo->indexRange);
+  const fftw_complex *data = (const fftw_complex*)ifo->weightedData;               // weightedData holds (re,im) pairs
+  
+  
+  // Linear interpolant:  roqLinWeight_j = sum_k d_k B_j(f_k)*
+  nRead = fread(&ifo->roqNlin, sizeof(int), 1, fin);
+  node = (int*)malloc(sizeof(int) * ifo->roqNlin);
+  nRead += fread(node, sizeof(int), ifo->roqNlin, fin);
+  ifo->roqLinFreq   = (double*)malloc(sizeof(double) * ifo->roqNlin);
+  ifo->roqLinWeight = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * ifo->roqNlin);
+  for(j=0;j<ifo->roqNlin;j++) {
+    ifo->roqLinFreq[j] = ifo->bandFreq[node[j]];
+    nRead += fread((double*)B, sizeof(double), 2*ifo->indexRange, fin);
+    ifo->roqLinWeight[j] = 0.0;
+    for(k=0;k<ifo->indexRange;k++) ifo->roqLinWeight[j] += data[k]*conj(B[k]);
+  }
+  if(nRead != (size_t)(1 + ifo->roqNlin*(1 + 2*ifo->indexRange))) {
+    fprintf(stderr,"\n\n   ERROR reading the linear ROQ interpolant for %s from %s.\n   Aborting...\n\n",ifo->name,run.roqFilename);
+    exit(1);
+  }
+  free(node);
+  
+  
+  // Quadratic interpolant:  roqQuadWeight_j = sum_k w_k C_j(f_k)
+  nRead = fread(&ifo->roqNquad, sizeof(int), 1, fin);
+  node = (int*)malloc(sizeof(int) * ifo->roqNquad);
+  nRead += fread(node, sizeof(int), ifo->roqNquad, fin);
+  ifo->roqQuadFreq   = (double*)malloc(sizeof(double) * ifo->roqNquad);
+  ifo->roqQuadWeight = (double*)malloc(sizeof(double) * ifo->roqNquad);
+  for(j=0;j<ifo->roqNquad;j++) {
+    ifo->roqQuadFreq[j] = ifo->bandFreq[node[j]];
+    nRead += fread(C, sizeof(double), ifo->indexRange, fin);
+    ifo->roqQuadWeight[j] = 0.0;
+    for(k=0;k<ifo->indexRange;k++) ifo->roqQuadWeight[j] += ifo->noiseWeight[2*k]*C[k];
+  }
+  if(nRead != (size_t)(1 + ifo->roqNquad*(1 + ifo->indexRange))) {
+    fprintf(stderr,"\n\n   ERROR reading the quadratic ROQ interpolant for %s from %s.\n   Aborting...\n\n",ifo->name,run.roqFilename);
+    exit(1);
+  }
+  free(node);
+  
+  fclose(fin);
+  fftw_free(B);
+  free(C);
+  
+  ifo->roqH = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * max(ifo->roqNlin,ifo->roqNquad));
+} // End readROQbasis()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> for a single IFO with the reduced-order-quadrature likelihood
+ *
+ * The template is computed at the linear and quadratic interpolation nodes only.
+ */
+// ****************************************************************************************************************************************************  
+void roqOverlaps(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh)
+{
+  int j=0;
+  fftw_complex *h = ifo[ifonr]->roqH;
+  double hd=0.0, hh=0.0;
+  
+  waveformTemplateFDfreq(par, ifo, ifonr, waveformVersion, injectionWF, likePar, ifo[ifonr]->roqLinFreq, ifo[ifonr]->roqNlin, (double*)h);
+  for(j=0;j<ifo[ifonr]->roqNlin;j++) hd += creal(ifo[ifonr]->roqLinWeight[j]*conj(h[j]));
+  
+  waveformTemplateFDfreq(par, ifo, ifonr, waveformVersion, injectionWF, likePar, ifo[ifonr]->roqQuadFreq, ifo[ifonr]->roqNquad, (double*)h);
+  for(j=0;j<ifo[ifonr]->roqNquad;j++) hh += ifo[ifonr]->roqQuadWeight[j]*creal(h[j]*conj(h[j]));
+  
+  *overlaphd = hd;
+  *overlaphh = hh;
+} // End roqOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief LU decomposition with partial pivoting of the complex n x n matrix A (row major), in place
+ */
+// ****************************************************************************************************************************************************  
+void complexLUdecompose(fftw_complex *A, int n, int *perm)
+{
+  int i=0, j=0, k=0, iMax=0;
+  double absMax=0.0;
+  fftw_complex tmp;
+  
+  for(i=0;i<n;i++) perm[i] = i;
+  for(k=0;k<n;k++) {
+    absMax = 0.0;
+    iMax = k;
+    for(i=k;i<n;i++) {
+      if(cabs(A[i*n+k]) > absMax) {
+        absMax = cabs(A[i*n+k]);
+        iMax = i;
+      }
+    }
+    if(absMax <= 0.0) {
+      fprintf(stderr,"\n\n   ERROR:  singular matrix in complexLUdecompose().\n   Aborting...\n\n");
+      exit(1);
+    }
+    if(iMax != k) {
+      for(j=0;j<n;j++) {
+        tmp = A[k*n+j];
+        A[k*n+j] = A[iMax*n+j];
+        A[iMax*n+j] = tmp;
+      }
+      j = perm[k];  perm[k] = perm[iMax];  perm[iMax] = j;
+    }
+    for(i=k+1;i<n;i++) {
+      A[i*n+k] /= A[k*n+k];
+      for(j=k+1;j<n;j++) A[i*n+j] -= A[i*n+k]*A[k*n+j];
+    }
+  }
+} // End complexLUdecompose()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Solve A x = b for x, with the LU decomposition of A from complexLUdecompose();  b is overwritten with x
+ */
+// ****************************************************************************************************************************************************  
+void complexLUsolve(const fftw_complex *LU, int n, const int *perm, fftw_complex *b)
+{
+  int i=0, j=0;
+  fftw_complex *x = (fftw_complex*)malloc(sizeof(fftw_complex) * n);
+  
+  for(i=0;i<n;i++) {                                                               // Forward substitution, L has a unit diagonal
+    x[i] = b[perm[i]];
+    for(j=0;j<i;j++) x[i] -= LU[i*n+j]*x[j];
+  }
+  for(i=n-1;i>=0;i--) {                                                            // Back substitution
+    for(j=i+1;j<n;j++) x[i] -= LU[i*n+j]*x[j];
+    x[i] /= LU[i*n+i];
+  }
+  for(i=0;i<n;i++) b[i] = x[i];
+  
+  free(x);
+} // End complexLUsolve()
+// ****************************************************************************************************************************************************  
+
+
@@ -39,6 +39,21 @@
  */
 
 
+#ifdef SPINSPIRAL_CHECKS
+static long heapAllocationCount = 0;  // Number of heap allocations by this thread, see heapAllocations()
+#ifdef _OPENMP
+#pragma omp threadprivate(heapAllocationCount)
+#endif
+
+// The parentheses around the function names bypass the macros in SPINspiral.h:
+void *countedMalloc(size_t size)             { heapAllocationCount++;  return (malloc)(size); }
+void *countedCalloc(size_t n, size_t size)   { heapAllocationCount++;  return (calloc)(n,size); }
+void *countedRealloc(void *ptr, size_t size) { heapAllocationCount++;  return (realloc)(ptr,size); }
+void *countedFFTWmalloc(size_t size)         { heapAllocationCount++;  return (fftw_malloc)(size); }
+void *countedFFTWFmalloc(size_t size)        { heapAllocationCount++;  return (fftwf_malloc)(size); }
+#endif
+
+
 
 //*** MASSES ***//
 
@@ -414,3 +429,25 @@ void setSeed(int *seed)
 // ****************************************************************************************************************************************************  
 
 
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the number of heap allocations made by SPINspiral on the calling thread so far, or 0 if they are not counted
+ * 
+ * When compiled with SPINSPIRAL_CHECKS (cmake -DWANT_CHECKS=on), SPINspiral.h redirects malloc(), calloc(), realloc(), fftw_malloc()
+ * and fftwf_malloc() to the counting versions at the top of this file (countedMalloc() etc.).  Allocations inside LAL are not counted.
+ * The count is kept per (OpenMP) thread, so that the difference between two calls on a thread counts the allocations of that thread 
+ * only, whatever the other threads do.
+ */
+// ****************************************************************************************************************************************************  
+long heapAllocations(void)
+{
+#ifdef SPINSPIRAL_CHECKS
+  return heapAllocationCount;
+#else
+  return 0;
+#endif
+}
+// ****************************************************************************************************************************************************  
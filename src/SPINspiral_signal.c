@@ -32,6 +32,12 @@
 
 #include <SPINspiral.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>  // AVX2 intrinsics for vecOverlapFused() and vecOverlapFusedFloat()
+#elif defined(__SSE2__)
+#include <emmintrin.h>  // SSE2 intrinsics for vecOverlapFused() and vecOverlapFusedFloat()
+#endif
+
 
 /**
  * \file SPINspiral_signal.c
@@ -45,85 +51,1217 @@
  * \brief Compute the log(Likelihood) for a network of IFOs
  */
 // ****************************************************************************************************************************************************  
-double netLogLikelihood(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, struct runPar run)
+double netLogLikelihood(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
 {
 	  double result = 0.0;
 	if(waveformVersion==9){
-		return result = logLikelihood_nine(par, waveformVersion, injectionWF, run);
+		return result = logLikelihood_nine(par, waveformVersion, injectionWF, likePar);
 	} else{
-  int i;
-  for (i=0; i<networkSize; ++i){
-    result += IFOlogLikelihood(par, ifo, i, waveformVersion, injectionWF, run);
-  }
+  double overlaphd=0.0, overlaphh=0.0;
+  result = netLogLikelihoodOverlaps(par, networkSize, ifo, waveformVersion, injectionWF, likePar, &overlaphd, &overlaphh);
 	return result;}
 } // End of netLogLikelihood()
 // ****************************************************************************************************************************************************  
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(Likelihood) for a network of IFOs, and return the network overlaps <d|h> and <h|h>
+ * 
+ * log(L) = <d|h> - <h|h>/2, summed over the detectors.  The overlaps allow the likelihood to be rescaled for a different distance 
+ * (see proposalLogLikelihood()).  Not for the analytic likelihood (waveformVersion 9).
+ */
+// ****************************************************************************************************************************************************  
+double netLogLikelihoodOverlaps(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh)
+{
+  int i, k;
+  double hd=0.0, hh=0.0;
+  int networkTemplate = networkTemplateAllowed(ifo, networkSize, waveformVersion);
+  int fdTemplate = frequencyDomainTemplate(waveformVersion);
+  int timeMarg = (likePar->marginaliseTime>=1 && injectionWF==0 && ifo[0]->tMargN>0);
+  int phaseDistMarg = (likePar->marginalisePhaseDist>=1 && injectionWF==0);
+  double overlaphdImag = 0.0;
+  
+  *overlaphd = 0.0;
+  *overlaphh = 0.0;
+  
+  // Clear the network cross-correlation for the time-marginalised likelihood:
+  if(timeMarg) {
+    for(i=0; i<networkSize; ++i) {
+      for(k=ifo[i]->lowIndex; k<=ifo[i]->highIndex; ++k) ifo[0]->tMargIn[k] = 0.0;
+    }
+  }
+  
+  // Compute h_+,h_x once and project them onto all detectors if possible, then compute the overlaps per detector:
+  if(networkTemplate) networkWaveformTemplate(par, ifo, networkSize, waveformVersion, injectionWF, likePar);
+  
+  for (i=0; i<networkSize; ++i){
+    if(fdTemplate && injectionWF==0 && ifo[i]->roqNlin>0) {
+      roqOverlaps(par, ifo, i, waveformVersion, injectionWF, likePar, &hd, &hh);              // Compute the template at the ROQ nodes only
+    } else if(fdTemplate && injectionWF==0 && ifo[i]->relBinUse==1) {
+      relativeBinningOverlaps(par, ifo, i, waveformVersion, injectionWF, likePar, &hd, &hh);  // Compute the template at the bin edges only
+    } else if(fdTemplate) {
+      waveformTemplateFD(par, ifo, i, waveformVersion, injectionWF, likePar);                  // Fill the band of ifo[i]->FTout directly, no FFT needed
+      bandOverlaps(ifo[i], &hd, &hh);
+    } else {
+      if(!networkTemplate) waveformTemplate(par, ifo, i, waveformVersion, injectionWF, likePar);  // Fill ifo[i]->FTin with time-domain template
+      templateOverlaps(ifo[i], &hd, &hh);
+    }
+    if(timeMarg) addTimeCorrelation(ifo, i);                                   // The band of ifo[i]->FTout holds the template
+    if(phaseDistMarg) overlaphdImag += bandOverlapImag(ifo[i]);
+    *overlaphd += hd;
+    *overlaphh += hh;
+  }
+  
+  if(timeMarg) return timeMarginalisedLogLikelihood(par, ifo, likePar, *overlaphh);
+  if(phaseDistMarg) return phaseDistMarginalisedLogLikelihood(par, likePar, *overlaphd, overlaphdImag, *overlaphh);
+  
+  return (*overlaphd - 0.5*(*overlaphh));
+} // End of netLogLikelihoodOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
 // ****************************************************************************************************************************************************  
 /**
  * \brief Compute the log(Likelihood) for a single IFO
  */
 // ****************************************************************************************************************************************************  
-double IFOlogLikelihood(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run)
+double IFOlogLikelihood(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
+{
+  // Frequency-domain template:  fill the band of ifo[ifonr]->FTout directly and skip the FFT:
+  if(frequencyDomainTemplate(waveformVersion)) {
+    double overlaphd=0.0, overlaphh=0.0;
+    waveformTemplateFD(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+    bandOverlaps(ifo[ifonr], &overlaphd, &overlaphh);
+    return (overlaphd-0.5*overlaphh);
+  }
+  
+  // Fill ifo[ifonr]->FTin with time-domain template:
+  waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+  
+  return templateLogLikelihood(ifo[ifonr]);
+  
+} // End IFOlogLikelihood()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(Likelihood) for a single IFO from the time-domain template already in ifo->FTin
+ * 
+ * Used by IFOlogLikelihood() and, for a template computed for the whole network at once, by netLogLikelihood().
+ */
+// ****************************************************************************************************************************************************  
+double templateLogLikelihood(struct interferometer *ifo)
 {
-  //int j=0;
-  //int tStart, tEnd;     // Start and end of templatea
-  //int tLength;          // Template length
   double overlaphd=0.0;
   double overlaphh=0.0;
   
-  // Fill ifo[ifonr]->FTin with time-domain template:
-  waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, run);
+  templateOverlaps(ifo, &overlaphd, &overlaphh);
+  
+  return (overlaphd-0.5*overlaphh);
   
-  //printf("tStart: %d\n tEnd: %d\n", tStart, tEnd);
+} // End templateLogLikelihood()
+// ****************************************************************************************************************************************************  
 
 
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> for a single IFO from the time-domain template already in ifo->FTin
+ */
+// ****************************************************************************************************************************************************  
+void templateOverlaps(struct interferometer *ifo, double *overlaphd, double *overlaphh)
+{
+  if(ifo->singlePrecision) {
+    templateOverlapsFloat(ifo, overlaphd, overlaphh);
+    return;
+  }
+  
   /*
   // Window template, FTwindow is a Tukey window:
-  for(j=0; j<ifo[ifonr]->samplesize; ++j) 
-    ifo[ifonr]->FTin[j] *= ifo[ifonr]->FTwindow[j];
+  for(j=0; j<ifo->samplesize; ++j) 
+    ifo->FTin[j] *= ifo->FTwindow[j];
   */
  
-  // Execute Fourier transform of signal template:
-  fftw_execute(ifo[ifonr]->FTplan);
+  // Execute Fourier transform of signal template, for the band only:
+  templateFFT(ifo);
+
+  bandOverlaps(ifo, overlaphd, overlaphh);
   
-  // Compute the overlap between waveform and data:
-  overlaphd = vecOverlap(ifo[ifonr]->raw_dataTrafo, 
-                                ifo[ifonr]->FTout, ifo[ifonr]->noisePSD,
-                                ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
-  //correct FFT for sampling rate of waveform
-  overlaphd/=((double)ifo[ifonr]->samplerate);  
+} // End templateOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Fourier transform the time-domain template in ifo->FTin into the band lowIndex..highIndex of ifo->FTout
+ * 
+ * The rest of FTout is not set.  If setBandFFT() found a pruned transform that is faster than the full FFT, split the samplesize 
+ * N = n1*n2 and compute the real FFTs Y_m of length n1 of the n2 subsequences x[m], x[m+n2], x[m+2n2], ...  For the bins k in the band 
+ * only, combine them as X[k] = sum_m Y_m[k mod n1] exp(-2 pi i m k/N), with Horner's rule.  Otherwise use the full FFT.
+ */
+// ****************************************************************************************************************************************************  
+void templateFFT(struct interferometer *ifo)
+{
+  int j=0, m=0, k1=0;
+  int n1 = ifo->bandFFTn1, n2 = ifo->bandFFTn2, nk = ifo->bandFFTn1/2+1;
+  double *X = (double*)(ifo->FTout + ifo->lowIndex);                                     // (re,im) pairs
+  const double *w = ifo->bandFFTtwiddle;
+  const double *Y = NULL;
+  double xr=0.0, yr=0.0, yi=0.0;
   
-  // Compute the overlap between waveform and itself:
-  overlaphh = vecOverlap(ifo[ifonr]->FTout,
-                                ifo[ifonr]->FTout, ifo[ifonr]->noisePSD,
-                                ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
-  //correct FFT for sampling rate of waveform
-  overlaphh/=((double)ifo[ifonr]->samplerate);
-  overlaphh/=((double)ifo[ifonr]->samplerate);
+  if(n2==0) {
+    fftw_execute_dft_r2c(ifo->FTplan, ifo->FTin, ifo->FTout);                           // The arrays of this (thread's) IFO, see IFOthreadInit()
+    return;
+  }
   
-  return (overlaphd-0.5*overlaphh);
+  fftw_execute_dft_r2c(ifo->bandFFTplan, ifo->FTin, ifo->bandFFTout);
   
-  /*
-  //Alternative: about 8% slower because of extra copies of FFT output
-  //   and division of each FFT point by ((double)ifo[ifonr]->samplerate)
-  fftw_complex *FFTwaveform =
-  fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
-  signalFFT(FFTwaveform, par, ifo, ifonr, waveformVersion, injectionWF, run);                             
-  // Compute the overlap between waveform and data:
-  double overlaphd = vecOverlap(ifo[ifonr]->raw_dataTrafo,
-  FFTwaveform, ifo[ifonr]->noisePSD,
-  ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
-  // Compute the overlap between waveform and itself:
-  double overlaphh = vecOverlap(
-  FFTwaveform, FFTwaveform, ifo[ifonr]->noisePSD,
-  ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
-  return (overlaphd-0.5*overlaphh);
-  */
+  for(j=0; j<2*ifo->indexRange; j++) X[j] = 0.0;
+  for(m=n2-1; m>=0; m--) {
+    Y  = (const double*)(ifo->bandFFTout + m*nk);
+    k1 = ifo->lowIndex % n1;
+    for(j=0; j<ifo->indexRange; j++) {
+      if(k1<nk) {                                                                          // The FFTs of real data store bins 0..n1/2 only
+        yr =  Y[2*k1];
+        yi =  Y[2*k1+1];
+      } else {
+        yr =  Y[2*(n1-k1)];
+        yi = -Y[2*(n1-k1)+1];
+      }
+      xr       = X[2*j]*w[2*j]   - X[2*j+1]*w[2*j+1] + yr;
+      X[2*j+1] = X[2*j]*w[2*j+1] + X[2*j+1]*w[2*j]   + yi;
+      X[2*j]   = xr;
+      if(++k1==n1) k1 = 0;
+    }
+  }
   
-} // End IFOlogLikelihood()
+} // End templateFFT()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> for a single IFO from the time-domain template in ifo->FTin, in single precision
+ * 
+ * Convert the support of the template to float (see setTemplateSupport()), transform it with a single-precision FFT and compute the
+ * overlaps with the single-precision weights of setSinglePrecision().  The sums are accumulated in double precision.
+ */
+// ****************************************************************************************************************************************************  
+void templateOverlapsFloat(struct interferometer *ifo, double *overlaphd, double *overlaphh)
+{
+  int j=0;
+  int tStart = ifo->tStart, tEnd = ifo->tEnd;
+  
+  if(tStart<0) {                                                                         // Unknown support
+    tStart = 0;
+    tEnd = ifo->samplesize-1;
+  }
+  
+  // Zero what is left of the previous template, and convert the new one:
+  for(j=ifo->floatStart; j<=ifo->floatEnd && j<tStart; j++) ifo->FTinF[j] = 0.0;
+  for(j=max(ifo->floatStart,tEnd+1); j<=ifo->floatEnd; j++) ifo->FTinF[j] = 0.0;
+  for(j=tStart; j<=tEnd; j++) ifo->FTinF[j] = (float)(ifo->FTin[j] * ifo->floatScale);
+  ifo->floatStart = tStart;
+  ifo->floatEnd = tEnd;
+  
+  fftwf_execute_dft_r2c(ifo->FTplanF, ifo->FTinF, ifo->FToutF);
+  
+  vecOverlapFusedFloat((float*)(ifo->FToutF + ifo->lowIndex), ifo->weightedDataF, ifo->noiseWeightF,
+                       ifo->indexRange, overlaphd, overlaphh);
+  
+} // End templateOverlapsFloat()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compare the single- and double-precision likelihoods on random parameter sets, and report the differences and timings
+ * 
+ * Use the best-guess parameter values and singlePrecisionTestSize-1 sets drawn uniformly from the prior ranges (fixed parameters are 
+ * kept at their best values), so that one can decide per MCMC waveform whether single precision is accurate enough.  Report the 
+ * likelihoods per second in either precision, and for each IFO the time of the FFT and overlaps alone (templateOverlaps()) for the 
+ * last template, which is the part that single precision speeds up.
+ */
+// ****************************************************************************************************************************************************  
+void compareSinglePrecision(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int i=0, p=0, ifonr=0, nUsed=0;
+  int injectionWF = 0;
+  double logL=0.0, logLf=0.0, dlogL=0.0, maxDlogL=0.0, sumDlogL2=0.0, logLatMax=0.0;
+  double hd=0.0, hh=0.0, tDouble=0.0, tSingle=0.0;
+  struct parSet par;
+  struct timeval start, end;
+  
+  if(ifo[0]->FTinF == NULL) return;                                                      // Not set up, e.g. for a frequency-domain template
+  
+  allocParset(&par, networkSize);
+  par.nPar = run.nMCMCpar;
+  gsl_rng *ran = gsl_rng_alloc(gsl_rng_mt19937);
+  gsl_rng_set(ran, run.MCMCseed);
+  
+  printf("   Comparing the single- and double-precision likelihoods for %d parameter sets...\n", singlePrecisionTestSize);
+  for(i=0; i<singlePrecisionTestSize; i++) {
+    for(p=0; p<run.nMCMCpar; p++) {
+      if(i==0 || run.parFix[p]!=0) {
+        par.par[p] = run.parBestVal[p];
+      } else {
+        par.par[p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+      }
+    }
+    localPar(&par, ifo, networkSize, injectionWF, &run.likePar);
+    
+    for(ifonr=0; ifonr<networkSize; ifonr++) ifo[ifonr]->singlePrecision = 0;
+    gettimeofday(&start, NULL);
+    logL = netLogLikelihood(&par, networkSize, ifo, run.mcmcWaveform, injectionWF, &run.likePar);
+    gettimeofday(&end, NULL);
+    tDouble += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    for(ifonr=0; ifonr<networkSize; ifonr++) ifo[ifonr]->singlePrecision = 1;
+    gettimeofday(&start, NULL);
+    logLf = netLogLikelihood(&par, networkSize, ifo, run.mcmcWaveform, injectionWF, &run.likePar);
+    gettimeofday(&end, NULL);
+    tSingle += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    if(!isfinite(logL) || logL==0.0) continue;                                           // E.g. no signal in the band
+    
+    dlogL = logLf - logL;
+    if(i==0 && run.beVerbose>=1) printf("   Best-guess parameters:  log(L) = %.6f (double),  %.6f (single)\n", logL, logLf);
+    if(fabs(dlogL) >= maxDlogL) {
+      maxDlogL = fabs(dlogL);
+      logLatMax = logL;
+    }
+    sumDlogL2 += dlogL*dlogL;
+    nUsed++;
+  }
+  
+  if(nUsed>0) {
+    printf("   Single - double precision, mcmcWaveform %d, %d parameter sets:  max |dlog(L)| = %.3g (at log(L) = %.3g),  rms dlog(L) = %.3g\n", 
+           run.mcmcWaveform, nUsed, maxDlogL, logLatMax, sqrt(sumDlogL2/(double)nUsed));
+  } else {
+    printf("   None of the %d parameter sets gives a signal in the band.\n", singlePrecisionTestSize);
+  }
+  printf("   Likelihoods per second:  %.3g (double),  %.3g (single)\n", 
+         (double)singlePrecisionTestSize/max(tDouble,1.e-9), (double)singlePrecisionTestSize/max(tSingle,1.e-9));
+  
+  // The FFT and overlaps alone, for the template of the last parameter set that is still in FTin:
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    ifo[ifonr]->singlePrecision = 0;
+    gettimeofday(&start, NULL);
+    for(i=0; i<singlePrecisionTestSize; i++) templateOverlaps(ifo[ifonr], &hd, &hh);
+    gettimeofday(&end, NULL);
+    tDouble = (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    ifo[ifonr]->singlePrecision = 1;
+    gettimeofday(&start, NULL);
+    for(i=0; i<singlePrecisionTestSize; i++) templateOverlaps(ifo[ifonr], &hd, &hh);
+    gettimeofday(&end, NULL);
+    tSingle = (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    ifo[ifonr]->singlePrecision = 0;
+    printf("   %-8s FFT and overlaps of %d samples:  %.3g ms (double),  %.3g ms (single),  %.2fx\n", ifo[ifonr]->name, ifo[ifonr]->samplesize,
+           tDouble*1000.0/(double)singlePrecisionTestSize, tSingle*1000.0/(double)singlePrecisionTestSize, tDouble/max(tSingle,1.e-9));
+  }
+  printf("\n");
+  
+  gsl_rng_free(ran);
+  freeParset(&par);
+} // End compareSinglePrecision()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compare the likelihoods computed on several threads with those computed serially, and report the differences
+ * 
+ * Draw threadTestSize parameter sets as in compareSinglePrecision() and compute their likelihoods with ifo.  Then give each (OpenMP)
+ * thread its own copy of the network (see IFOthreadInit()), and compute the likelihoods again on all threads at once, in the reverse
+ * order and dynamically scheduled, so that the threads see different sequences of templates.  The template and likelihood code is 
+ * reentrant if the results are identical, bit for bit;  abort if they are not.  This includes the LAL waveforms LAL12, LAL15 and 
+ * LALnonSpinning when LAL was built thread safe (see getWaveformBackend()).  Without OpenMP, or for a waveform that is not 
+ * flagged wfThreadSafe, a single copy of the network is tested, since the MCMC computes such a waveform on a single thread 
+ * (see mcmcThreads()).
+ */
+// ****************************************************************************************************************************************************  
+void compareThreadedLikelihood(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int i=0, p=0, t=0, ifonr=0, nThreads=1, nDiff=0;
+  int injectionWF = 0;
+  double maxDlogL=0.0;
+  double *logL  = (double*) malloc(sizeof(double) * threadTestSize);
+  double *logLt = (double*) malloc(sizeof(double) * threadTestSize);
+  struct parSet *par = (struct parSet*) malloc(sizeof(struct parSet) * threadTestSize);
+  
+  gsl_rng *ran = gsl_rng_alloc(gsl_rng_mt19937);
+  gsl_rng_set(ran, run.MCMCseed);
+  for(i=0; i<threadTestSize; i++) {
+    allocParset(&par[i], networkSize);
+    par[i].nPar = run.nMCMCpar;
+    for(p=0; p<run.nMCMCpar; p++) {
+      if(i==0 || run.parFix[p]!=0) {
+        par[i].par[p] = run.parBestVal[p];
+      } else {
+        par[i].par[p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+      }
+    }
+    localPar(&par[i], ifo, networkSize, injectionWF, &run.likePar);
+  }
+  gsl_rng_free(ran);
+  
+#ifdef _OPENMP
+  nThreads = omp_get_max_threads();
+#endif
+  if(nThreads>1 && !waveformCapability(run.mcmcWaveform, wfThreadSafe)) {
+    printf("   Waveform %d is not thread safe (see getWaveformBackend()):  testing a copy of the network on a single thread only.\n", run.mcmcWaveform);
+    if(run.mcmcWaveform>=2 && run.mcmcWaveform<=4) printf("   LAL was built without pthread locks;  configure LAL with --enable-pthread-lock to test it on %d threads.\n", nThreads);
+    nThreads = 1;
+  }
+  printf("   Comparing the likelihoods of %d parameter sets computed on %d thread(s) and serially...\n", threadTestSize, nThreads);
+  for(i=0; i<threadTestSize; i++) logL[i] = netLogLikelihood(&par[i], networkSize, ifo, run.mcmcWaveform, injectionWF, &run.likePar);
+  
+  // One copy of the network per thread:
+  struct interferometer *copies = (struct interferometer*) malloc(sizeof(struct interferometer) * nThreads * networkSize);
+  struct interferometer **threadIfo = (struct interferometer**) malloc(sizeof(struct interferometer*) * nThreads * networkSize);
+  for(t=0; t<nThreads; t++) {
+    for(ifonr=0; ifonr<networkSize; ifonr++) {
+      IFOthreadInit(&copies[t*networkSize+ifonr], ifo[ifonr]);
+      threadIfo[t*networkSize+ifonr] = &copies[t*networkSize+ifonr];
+    }
+  }
+  
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nThreads) private(t)
+#endif
+  {
+    t = 0;
+#ifdef _OPENMP
+    t = omp_get_thread_num();
+#pragma omp for schedule(dynamic)
+#endif
+    for(i=threadTestSize-1; i>=0; i--) {
+      logLt[i] = netLogLikelihood(&par[i], networkSize, threadIfo + t*networkSize, run.mcmcWaveform, injectionWF, &run.likePar);
+    }
+  }
+  
+  for(i=0; i<threadTestSize; i++) {
+    if(memcmp(&logL[i], &logLt[i], sizeof(double)) != 0) {
+      nDiff++;
+      maxDlogL = max(maxDlogL, fabs(logLt[i]-logL[i]));
+    }
+  }
+  if(nDiff==0) {
+    printf("   Threaded - serial, mcmcWaveform %d:  the likelihoods of all %d parameter sets are identical\n\n", run.mcmcWaveform, threadTestSize);
+  } else {
+    fprintf(stderr, "\n\n   ERROR:  compareThreadedLikelihood():  %d of %d likelihoods of mcmcWaveform %d differ between the threaded and serial computations (max |dlog(L)| = %.3g).\n   Aborting...\n\n", 
+            nDiff, threadTestSize, run.mcmcWaveform, maxDlogL);
+    exit(1);
+  }
+  
+  for(t=0; t<nThreads*networkSize; t++) IFOthreadDispose(&copies[t]);
+  free(threadIfo);
+  free(copies);
+  for(i=0; i<threadTestSize; i++) freeParset(&par[i]);
+  free(par);
+  free(logLt);
+  free(logL);
+} // End compareThreadedLikelihood()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Time the overlaps <d|h> and <h|h> computed in two passes with vecOverlap() and in one pass with vecOverlapFused()
+ * 
+ * For each IFO, use the (unnormalised) FFT of the data as the template, and compute both overlaps overlapBenchmarkSize times with 
+ * either method.  Print the number of frequency bins per second and the relative differences between the two results.
+ */
+// ****************************************************************************************************************************************************  
+void benchmarkOverlaps(struct interferometer *ifo[], int networkSize)
+{
+  int i=0, j=0, ifonr=0;
+  double hd=0.0, hh=0.0, hdF=0.0, hhF=0.0, hd1=0.0, hh1=0.0, t2=0.0, tF=0.0, sr=0.0, nBins=0.0;
+  fftw_complex *h = NULL;
+  struct timeval start, end;
+  
+  printf("   Timing the overlaps of the data with itself, %d times per IFO:\n", overlapBenchmarkSize);
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    sr = (double)ifo[ifonr]->samplerate;
+    nBins = (double)ifo[ifonr]->indexRange * (double)overlapBenchmarkSize;
+    h = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * ifo[ifonr]->FTsize);
+    for(j=0; j<ifo[ifonr]->FTsize; j++) h[j] = ifo[ifonr]->raw_dataTrafo[j] * sr;      // Like the FFT of a template in FTout
+    
+    // Two passes, as IFOlogLikelihood() used to do:
+    hd = 0.0;
+    hh = 0.0;
+    gettimeofday(&start, NULL);
+    for(i=0; i<overlapBenchmarkSize; i++) {
+      hd += vecOverlap(ifo[ifonr]->raw_dataTrafo, h, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT) / sr;
+      hh += vecOverlap(h, h, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT) / (sr*sr);
+    }
+    gettimeofday(&end, NULL);
+    t2 = (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    
+    // One pass:
+    hdF = 0.0;
+    hhF = 0.0;
+    gettimeofday(&start, NULL);
+    for(i=0; i<overlapBenchmarkSize; i++) {
+      vecOverlapFused((double*)(h + ifo[ifonr]->lowIndex), ifo[ifonr]->weightedData, ifo[ifonr]->noiseWeight, ifo[ifonr]->indexRange, &hd1, &hh1);
+      hdF += hd1;
+      hhF += hh1;
+    }
+    gettimeofday(&end, NULL);
+    tF = (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    
+    printf("   %-8s %8d bins:  vecOverlap() x2:  %9.3g bins/s,  vecOverlapFused():  %9.3g bins/s  (%.1fx);  relative difference:  %.1e, %.1e\n",
+           ifo[ifonr]->name, ifo[ifonr]->indexRange, nBins/max(t2,1.e-9), nBins/max(tF,1.e-9), t2/max(tF,1.e-9), 
+           fabs(hdF-hd)/max(fabs(hd),1.e-300), fabs(hhF-hh)/max(fabs(hh),1.e-300));
+    fftw_free(h);
+  }
+  printf("\n");
+} // End benchmarkOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Time the full and pruned template FFTs (see templateFFT()) for a range of segment lengths
+ * 
+ * setBandFFT() times the transforms for the segment length of the run only.  Here, for each IFO and segment lengths of 4 to 128 s 
+ * at its sample rate and with its frequency band, time the full FFT and the pruned transforms with n2 = 2, 4, ..., bandFFTmaxSplit 
+ * subsequences with timeTemplateFFT(), on a chirp-like test signal.  Print the times and the relative error of the band of each pruned 
+ * transform w.r.t. the full FFT.
+ */
+// ****************************************************************************************************************************************************  
+void benchmarkTemplateFFT(struct interferometer *ifo[], int networkSize)
+{
+  int i=0, j=0, n2=0, ifonr=0;
+  int segLength[6] = {4,8,16,32,64,128};
+  double t=0.0, tFull=0.0, err=0.0, norm=0.0, f=0.0;
+  struct interferometer tmp;
+  
+  printf("   Timing the full and pruned template FFTs:\n");
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    for(i=0; i<6; i++) {
+      // A copy of the IFO with a segment of segLength[i] seconds:
+      tmp = *ifo[ifonr];
+      tmp.samplesize = segLength[i]*tmp.samplerate;
+      tmp.FTsize = tmp.samplesize/2+1;
+      tmp.lowIndex = (int)ceil(tmp.lowCut*(double)segLength[i]);
+      tmp.highIndex = min((int)floor(tmp.highCut*(double)segLength[i]), tmp.FTsize-1);
+      tmp.indexRange = tmp.highIndex - tmp.lowIndex + 1;
+      tmp.FTin = (double*) fftw_malloc(sizeof(double) * tmp.samplesize);
+      tmp.FTout = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * tmp.FTsize);
+      tmp.FTplan = fftw_plan_dft_r2c_1d(tmp.samplesize, tmp.FTin, tmp.FTout, FFTW_ESTIMATE);
+      tmp.bandFFTn2 = 0;
+      for(j=0; j<tmp.samplesize; j++) {                                                        // Chirp from lowCut to highCut
+        f = tmp.lowCut + (tmp.highCut-tmp.lowCut) * (double)j/(double)tmp.samplesize;
+        tmp.FTin[j] = sin(pi*f*(double)j/(double)tmp.samplerate);
+      }
+      fftw_complex *band = (fftw_complex*) malloc(sizeof(fftw_complex) * tmp.indexRange);
+      
+      tFull = timeTemplateFFT(&tmp);
+      for(j=0; j<tmp.indexRange; j++) band[j] = tmp.FTout[tmp.lowIndex+j];
+      printf("   %-8s %4d s, %8d samples, %7d bins:  full FFT %8.3f ms", ifo[ifonr]->name, segLength[i], tmp.samplesize, tmp.indexRange, tFull*1000.0);
+      
+      for(n2=2; n2<=bandFFTmaxSplit && tmp.samplesize%n2==0; n2*=2) {
+        setBandFFTsplit(&tmp, n2);
+        t = timeTemplateFFT(&tmp);
+        err = 0.0;
+        norm = 0.0;
+        for(j=0; j<tmp.indexRange; j++) {
+          err  += creal((tmp.FTout[tmp.lowIndex+j]-band[j]) * conj(tmp.FTout[tmp.lowIndex+j]-band[j]));
+          norm += creal(band[j]*conj(band[j]));
+        }
+        printf(";  %d: %6.2fx (%.0e)", n2, tFull/max(t,1.e-9), sqrt(err/max(norm,1.e-300)));
+      }
+      printf("\n");
+      
+      setBandFFTsplit(&tmp, 0);
+      fftw_destroy_plan(tmp.FTplan);
+      fftw_free(tmp.FTin);
+      fftw_free(tmp.FTout);
+      free(band);
+    }
+  }
+  printf("   (n2: speed-up of the pruned FFT with n2 subsequences w.r.t. the full FFT, and its relative error)\n\n");
+} // End benchmarkTemplateFFT()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compare the likelihoods from a cached intrinsic template with those computed in full, and time both
+ * 
+ * For a waveform with the wfExtrinsic capability, draw extrinsicTestSize parameter sets as in compareSinglePrecision().  For each, cache the 
+ * intrinsic template (see intrinsicTemplateCache()), draw new values for the free extrinsic parameters from their prior ranges, and compute 
+ * the likelihood with extrinsicLogLikelihood() and with netLogLikelihood().  Report the largest difference, relative to max(1,<h|h>), and the 
+ * number of likelihoods per second of either method.
+ */
+// ****************************************************************************************************************************************************  
+void compareExtrinsicLikelihood(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int i=0, p=0, ifonr=0, nBand=0, nUsed=0;
+  int injectionWF = 0;
+  double hd=0.0, hh=0.0, dlogL=0.0, maxDlogL=0.0, tExtr=0.0, tFull=0.0;
+  struct parSet par;
+  struct timeval start, end;
+  
+  if(!waveformCapability(run.mcmcWaveform, wfExtrinsic)) return;
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    if(ifo[ifonr]->relBinUse==1 || ifo[ifonr]->roqNlin>0) return;                          // Not the likelihood of netLogLikelihood()
+    nBand += ifo[ifonr]->indexRange;
+  }
+  
+  double *cacheDH = (double*) malloc(sizeof(double) * 2 * nBand);
+  double *cacheHH = (double*) malloc(sizeof(double) * networkSize);
+  double *logL = (double*) malloc(sizeof(double) * extrinsicTestSize);
+  double *logLx = (double*) malloc(sizeof(double) * extrinsicTestSize);
+  allocParset(&par, networkSize);
+  par.nPar = run.nMCMCpar;
+  gsl_rng *ran = gsl_rng_alloc(gsl_rng_mt19937);
+  gsl_rng_set(ran, run.MCMCseed);
+  
+  printf("   Comparing the likelihoods from a cached intrinsic template with full computations for %d parameter sets...\n", extrinsicTestSize);
+  for(i=0; i<extrinsicTestSize; i++) {
+    for(p=0; p<run.nMCMCpar; p++) {
+      if(i==0 || run.parFix[p]!=0) {
+        par.par[p] = run.parBestVal[p];
+      } else {
+        par.par[p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+      }
+    }
+    intrinsicTemplateCache(&par, ifo, networkSize, run.mcmcWaveform, &run.likePar, cacheDH, cacheHH);
+    for(p=0; p<run.nMCMCpar; p++) {
+      if(run.parFix[p]==0 && extrinsicParameter(run.parID[p])) par.par[p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+    }
+    localPar(&par, ifo, networkSize, injectionWF, &run.likePar);
+    
+    gettimeofday(&start, NULL);
+    logLx[i] = extrinsicLogLikelihood(&par, ifo, networkSize, run.mcmcWaveform, &run.likePar, cacheDH, cacheHH, &hd, &hh);
+    gettimeofday(&end, NULL);
+    tExtr += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    
+    gettimeofday(&start, NULL);
+    logL[i] = netLogLikelihood(&par, networkSize, ifo, run.mcmcWaveform, injectionWF, &run.likePar);
+    gettimeofday(&end, NULL);
+    tFull += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+    
+    if(!isfinite(logL[i])) continue;
+    dlogL = fabs(logLx[i]-logL[i]) / max(1.0,hh);
+    maxDlogL = max(maxDlogL, dlogL);
+    nUsed++;
+  }
+  
+  printf("   Cached - full, mcmcWaveform %d, %d parameter sets:  max |dlog(L)|/max(1,<h|h>) = %.3g;  %.3g (cached) vs %.3g (full) likelihoods/s\n\n",
+         run.mcmcWaveform, nUsed, maxDlogL, (double)extrinsicTestSize/max(tExtr,1.e-9), (double)extrinsicTestSize/max(tFull,1.e-9));
+  if(maxDlogL > 1.e-8) {
+    fprintf(stderr, "\n ***  Warning:  compareExtrinsicLikelihood():  the likelihoods from the cached intrinsic template differ from the full computation (%.3g) ***\n\n", 
+            maxDlogL);
+  }
+  
+  gsl_rng_free(ran);
+  freeParset(&par);
+  free(logLx);
+  free(logL);
+  free(cacheHH);
+  free(cacheDH);
+} // End compareExtrinsicLikelihood()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compare the blocked Apostolatos template with the scalar reference version, and time both
+ * 
+ * For mcmcWaveform 1, draw apostolatosTestSize parameter sets as in compareExtrinsicLikelihood() and compute the full-rate template of each 
+ * detector with templateApostolatos() and templateApostolatosScalar().  Report the largest difference, relative to the largest sample of the 
+ * reference template, and the number of template samples per second of either version.
+ */
+// ****************************************************************************************************************************************************  
+void compareApostolatosTemplates(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int i=0, p=0, j=0, ifonr=0, nUsed=0, maxSize=0;
+  int injectionWF = 0;
+  double diff=0.0, norm=0.0, maxDiff=0.0, tScalar=0.0, tBlocked=0.0, nSample=0.0;
+  struct likelihoodPar likePar = run.likePar;
+  struct parSet par;
+  struct timeval start, end;
+  
+  if(run.mcmcWaveform!=1) return;
+  likePar.multirateCycles = 0.0;                                                               // Compare the full-rate templates
+  for(ifonr=0; ifonr<networkSize; ifonr++) maxSize = max(maxSize, ifo[ifonr]->samplesize);
+  
+  double *ref = (double*) malloc(sizeof(double) * maxSize);
+  allocParset(&par, networkSize);
+  par.nPar = run.nMCMCpar;
+  gsl_rng *ran = gsl_rng_alloc(gsl_rng_mt19937);
+  gsl_rng_set(ran, run.MCMCseed);
+  
+  printf("   Comparing the blocked and scalar Apostolatos templates for %d parameter sets...\n", apostolatosTestSize);
+  for(i=0; i<apostolatosTestSize; i++) {
+    for(p=0; p<run.nMCMCpar; p++) {
+      if(i==0 || run.parFix[p]!=0) {
+        par.par[p] = run.parBestVal[p];
+      } else {
+        par.par[p] = run.priorBoundLow[p] + gsl_rng_uniform(ran)*(run.priorBoundUp[p]-run.priorBoundLow[p]);
+      }
+    }
+    localPar(&par, ifo, networkSize, injectionWF, &likePar);
+    
+    for(ifonr=0; ifonr<networkSize; ifonr++) {
+      gettimeofday(&start, NULL);
+      templateApostolatosScalar(&par, ifo, ifonr, injectionWF, &likePar);
+      gettimeofday(&end, NULL);
+      tScalar += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+      for(j=0; j<ifo[ifonr]->samplesize; j++) ref[j] = ifo[ifonr]->FTin[j];
+      
+      gettimeofday(&start, NULL);
+      templateApostolatos(&par, ifo, ifonr, injectionWF, &likePar);
+      gettimeofday(&end, NULL);
+      tBlocked += (double)(end.tv_sec-start.tv_sec) + 1.e-6*(double)(end.tv_usec-start.tv_usec);
+      nSample += (double)ifo[ifonr]->samplesize;
+      
+      diff = 0.0;
+      norm = 0.0;
+      for(j=0; j<ifo[ifonr]->samplesize; j++) {
+        diff = max(diff, fabs(ifo[ifonr]->FTin[j]-ref[j]));
+        norm = max(norm, fabs(ref[j]));
+      }
+      if(norm<=0.0) continue;                                                                  // No signal in the band
+      maxDiff = max(maxDiff, diff/norm);
+      nUsed++;
+    }
+  }
+  
+  printf("   Blocked - scalar, %d templates:  max |dh|/max|h| = %.3g;  %.3g (blocked) vs %.3g (scalar) samples/s\n\n",
+         nUsed, maxDiff, nSample/max(tBlocked,1.e-9), nSample/max(tScalar,1.e-9));
+  if(maxDiff > 1.e-10) {
+    fprintf(stderr, "\n ***  Warning:  compareApostolatosTemplates():  the blocked and scalar Apostolatos templates differ (%.3g) ***\n\n", maxDiff);
+  }
+  
+  gsl_rng_free(ran);
+  freeParset(&par);
+  free(ref);
+} // End compareApostolatosTemplates()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> for a single IFO from the template in the band lowIndex..highIndex of ifo->FTout
+ * 
+ * The template is either the FFT of a time-domain template (see templateOverlaps()) or a frequency-domain template
+ * (see waveformTemplateFD()).
+ */
+// ****************************************************************************************************************************************************  
+void bandOverlaps(struct interferometer *ifo, double *overlaphd, double *overlaphh)
+{
+  // Compute the overlaps between waveform and data and between waveform and itself in a single pass.
+  //   The weights set in IFOinit() include the correction of the FFT for the sampling rate of the waveform:
+  vecOverlapFused((double*)(ifo->FTout + ifo->lowIndex), ifo->weightedData, ifo->noiseWeight,
+                  ifo->indexRange, overlaphd, overlaphh);
+  
+} // End bandOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Choose the frequency bins for the relative-binning likelihood
+ * 
+ * Relative binning (Zackay, Dai & Venumadhav 2018) assumes that the ratio of two nearby templates is smooth in frequency, so that
+ * it can be linearly interpolated within a bin.  The bin edges are chosen such that the phase of the terms f^(-5/3), f^(-2/3), f,
+ * f^(5/3) and f^(7/3), each normalised to change by 2 pi over the band, changes by at most epsilon over a bin.  The bins depend on 
+ * the frequency band only;  the summary data around a fiducial template are computed in relativeBinningSummaryData().
+ */
+// ****************************************************************************************************************************************************  
+void setRelativeBins(struct interferometer *ifo, double epsilon)
+{
+  int i=0, j=0, pass=0, nBin=0, lastEdge=0;
+  double gamma[5] = { -5.0/3.0, -2.0/3.0, 1.0, 5.0/3.0, 7.0/3.0 };
+  double fStar=0.0, dPsi=0.0, dPsi0=0.0;
+  double fMin = ifo->bandFreq[0];
+  double fMax = ifo->bandFreq[ifo->indexRange-1];
+  
+  // Count the bins in the first pass and store the edges in the second:
+  for(pass=0; pass<2; pass++) {
+    nBin = 0;
+    lastEdge = ifo->lowIndex;
+    dPsi0 = 0.0;
+    for(j=0; j<ifo->indexRange; j++) {
+      dPsi = 0.0;
+      for(i=0; i<5; i++) {
+        fStar = (gamma[i] > 0.0) ? fMax : fMin;
+        dPsi += tpi * (gamma[i] > 0.0 ? 1.0 : -1.0) * pow(ifo->bandFreq[j]/fStar, gamma[i]);
+      }
+      if(j==0) dPsi0 = dPsi;
+      
+      if(dPsi-dPsi0 > epsilon || j==ifo->indexRange-1) {             // Close the current bin at this frequency
+        if(j+ifo->lowIndex > lastEdge) {
+          nBin += 1;
+          if(pass==1) ifo->relBinEdge[nBin] = j+ifo->lowIndex;
+          lastEdge = j+ifo->lowIndex;
+        }
+        dPsi0 = dPsi;
+      }
+    }
+    
+    if(pass==0) {
+      ifo->relBinN    = nBin;
+      ifo->relBinEdge = (int*)malloc(sizeof(int) * (nBin+1));
+      ifo->relBinFreq = (double*)malloc(sizeof(double) * (nBin+1));
+      ifo->relBinH0   = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (nBin+1));
+      ifo->relBinH    = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (nBin+1));
+      ifo->relBinA0   = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * nBin);
+      ifo->relBinA1   = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * nBin);
+      ifo->relBinB0   = (double*)malloc(sizeof(double) * nBin);
+      ifo->relBinB1   = (double*)malloc(sizeof(double) * nBin);
+      ifo->relBinB2   = (double*)malloc(sizeof(double) * nBin);
+      ifo->relBinEdge[0] = ifo->lowIndex;
+    }
+  }
+  
+  for(i=0; i<=ifo->relBinN; i++) ifo->relBinFreq[i] = ifo->bandFreq[ifo->relBinEdge[i]-ifo->lowIndex];
+  ifo->relBinUse = 0;
+  
+} // End setRelativeBins()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the relative-binning summary data around a fiducial template with parameters par
+ * 
+ * For bin b with left edge f_b, and with d the (weighted) data and h0 the fiducial template:
+ *   A0 = sum d h0*,  A1 = sum d h0* (f-f_b),  B0 = sum |h0|^2,  B1 = sum |h0|^2 (f-f_b),  B2 = sum |h0|^2 (f-f_b)^2.
+ * localPar() must have been called for par.  After this, netLogLikelihood() uses relativeBinningOverlaps() for MCMC templates.
+ */
+// ****************************************************************************************************************************************************  
+void relativeBinningSummaryData(struct parSet *par, int networkSize, struct interferometer *ifo[], int waveformVersion, const struct likelihoodPar *likePar)
+{
+  int ifonr=0, b=0, j=0, k=0, jEnd=0;
+  int injectionWF = 0;                                                          // The fiducial template is an MCMC template
+  double df=0.0, w=0.0, h0h0=0.0;
+  fftw_complex dh0;
+  
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    if(ifo[ifonr]->relBinN<=0) continue;
+    
+    // Compute the fiducial template on the whole band:
+    waveformTemplateFD(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+    
+    for(b=0; b<ifo[ifonr]->relBinN; b++) {
+      ifo[ifonr]->relBinA0[b] = 0.0;
+      ifo[ifonr]->relBinA1[b] = 0.0;
+      ifo[ifonr]->relBinB0[b] = 0.0;
+      ifo[ifonr]->relBinB1[b] = 0.0;
+      ifo[ifonr]->relBinB2[b] = 0.0;
+      
+      jEnd = ifo[ifonr]->relBinEdge[b+1];
+      if(b==ifo[ifonr]->relBinN-1) jEnd += 1;                                  // The last bin includes its right edge
+      for(j=ifo[ifonr]->relBinEdge[b]; j<jEnd; j++) {
+        k    = j - ifo[ifonr]->lowIndex;
+        df   = ifo[ifonr]->bandFreq[k] - ifo[ifonr]->relBinFreq[b];
+        w    = ifo[ifonr]->noiseWeight[2*k];
+        dh0  = ((fftw_complex*)ifo[ifonr]->weightedData)[k] * conj(ifo[ifonr]->FTout[j]);     // weightedData holds (re,im) pairs
+        h0h0 = w * creal(ifo[ifonr]->FTout[j]*conj(ifo[ifonr]->FTout[j]));
+        ifo[ifonr]->relBinA0[b] += dh0;
+        ifo[ifonr]->relBinA1[b] += dh0*df;
+        ifo[ifonr]->relBinB0[b] += h0h0;
+        ifo[ifonr]->relBinB1[b] += h0h0*df;
+        ifo[ifonr]->relBinB2[b] += h0h0*df*df;
+      }
+    }
+    
+    for(b=0; b<=ifo[ifonr]->relBinN; b++) ifo[ifonr]->relBinH0[b] = ifo[ifonr]->FTout[ifo[ifonr]->relBinEdge[b]];
+    ifo[ifonr]->relBinUse = 1;
+  }
+  
+} // End relativeBinningSummaryData()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> for a single IFO with the relative-binning likelihood
+ * 
+ * The template is computed at the bin edges only.  The ratio r = h/h0 with the fiducial template is interpolated linearly within
+ * each bin, r = r_b + s_b (f-f_b), so that <d|h> = Re sum (A0 r_b* + A1 s_b*) and <h|h> = sum (B0 |r_b|^2 + 2 B1 Re(r_b s_b*) + B2 |s_b|^2).
+ */
+// ****************************************************************************************************************************************************  
+void relativeBinningOverlaps(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar, double *overlaphd, double *overlaphh)
+{
+  int b=0;
+  int nBin = ifo[ifonr]->relBinN;
+  fftw_complex *h = ifo[ifonr]->relBinH;
+  fftw_complex r0, r1, s;
+  double hd=0.0, hh=0.0;
+  
+  // Compute the template at the bin edges, and its ratio to the fiducial template:
+  waveformTemplateFDfreq(par, ifo, ifonr, waveformVersion, injectionWF, likePar, ifo[ifonr]->relBinFreq, nBin+1, (double*)h);
+  for(b=0; b<=nBin; b++) {
+    if(cabs(ifo[ifonr]->relBinH0[b]) > 0.0) {
+      h[b] /= ifo[ifonr]->relBinH0[b];
+    } else {
+      h[b] = 0.0;                                                               // Above the cut-off frequency of the fiducial template
+    }
+  }
+  
+  r1 = h[0];
+  for(b=0; b<nBin; b++) {
+    r0 = r1;
+    r1 = h[b+1];
+    s  = (r1-r0) / (ifo[ifonr]->relBinFreq[b+1] - ifo[ifonr]->relBinFreq[b]);
+    hd += creal(ifo[ifonr]->relBinA0[b]*conj(r0) + ifo[ifonr]->relBinA1[b]*conj(s));
+    hh += ifo[ifonr]->relBinB0[b]*creal(r0*conj(r0)) + 2.0*ifo[ifonr]->relBinB1[b]*creal(r0*conj(s)) + ifo[ifonr]->relBinB2[b]*creal(s*conj(s));
+  }
+  
+  *overlaphd = hd;
+  *overlaphh = hh;
+  
+} // End relativeBinningOverlaps()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Cache the intrinsic part of a frequency-domain template for extrinsicLogLikelihood()
+ * 
+ * For a waveform with the wfExtrinsic capability, compute the intrinsic template u(f) of par over the band of each IFO (see 
+ * waveformTemplateIntrinsic()), and store d*(f) u(f) with the weighted data d as (re,im) pairs in cacheDH, for IFO ifonr from offset 
+ * 2 sum_{i<ifonr} indexRange_i, and <u|u> in cacheHH[ifonr].  The band of ifo[]->FTout is used as work space.
+ */
+// ****************************************************************************************************************************************************  
+void intrinsicTemplateCache(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, const struct likelihoodPar *likePar,
+                            double *cacheDH, double *cacheHH)
+{
+  int ifonr=0, j=0;
+  double ur=0.0, ui=0.0, dr=0.0, di=0.0, uu=0.0;
+  double *q = cacheDH;
+  
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    double *u = (double*)(ifo[ifonr]->FTout + ifo[ifonr]->lowIndex);
+    const double *d = ifo[ifonr]->weightedData;
+    const double *w = ifo[ifonr]->noiseWeight;
+    
+    waveformTemplateIntrinsic(par, ifo, ifonr, waveformVersion, likePar, ifo[ifonr]->bandFreq, ifo[ifonr]->indexRange, u);
+    uu = 0.0;
+    for(j=0; j<ifo[ifonr]->indexRange; j++) {
+      ur = u[2*j];
+      ui = u[2*j+1];
+      dr = d[2*j];
+      di = d[2*j+1];
+      q[2*j]   = dr*ur + di*ui;                                                 // d* u
+      q[2*j+1] = dr*ui - di*ur;
+      uu += w[2*j]*(ur*ur + ui*ui);
+    }
+    cacheHH[ifonr] = uu;
+    q += 2*ifo[ifonr]->indexRange;
+  }
+  
+} // End intrinsicTemplateCache()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(Likelihood) for a network of IFOs from a cached intrinsic template, for new values of the extrinsic parameters
+ * 
+ * The template is h(f) = u(f) E exp(-2 pi i f t_c,loc) (see waveformTemplateIntrinsic()), so that <h|h> = |E|^2 <u|u> and 
+ * <d|h> = Re E sum_k d*(f_k) u(f_k) z^(lowIndex+k), with z = exp(-2 pi i t_c,loc/deltaFT).  The sum is evaluated with Horner's rule in z^2,
+ * for the even and odd k separately to hide the latency, without a template, sine or cosine per frequency bin.  cacheDH and cacheHH were filled by intrinsicTemplateCache() for a parameter set with 
+ * the same intrinsic parameters as par;  localPar() must have been called for par.  The network overlaps are returned in overlaphd, overlaphh.
+ */
+// ****************************************************************************************************************************************************  
+double extrinsicLogLikelihood(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, const struct likelihoodPar *likePar,
+                              const double *cacheDH, const double *cacheHH, double *overlaphd, double *overlaphh)
+{
+  int ifonr=0, j=0, n=0;
+  double E[2], zr=0.0, zi=0.0, z2r=0.0, z2i=0.0, sr=0.0, si=0.0, or=0.0, oi=0.0, tmp=0.0, phase=0.0, c=0.0, s=0.0;
+  const double *q = cacheDH;
+  
+  *overlaphd = 0.0;
+  *overlaphh = 0.0;
+  
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    waveformExtrinsicFactor(par, ifo, ifonr, waveformVersion, likePar, E);
+    
+    // sum_k q_k z^k = sum_m q_2m z^2m + z sum_m q_2m+1 z^2m, from the highest frequency down:
+    zr  =  cos(tpi*par->loctc[ifonr]/ifo[ifonr]->deltaFT);
+    zi  = -sin(tpi*par->loctc[ifonr]/ifo[ifonr]->deltaFT);
+    z2r = zr*zr - zi*zi;
+    z2i = 2.0*zr*zi;
+    n   = ifo[ifonr]->indexRange;
+    sr = 0.0;  si = 0.0;                                                        // Even k
+    or = 0.0;  oi = 0.0;                                                        // Odd k
+    if(n%2==1) {
+      sr = q[2*(n-1)];
+      si = q[2*(n-1)+1];
+    }
+    for(j=(n/2)*2-2; j>=0; j-=2) {
+      tmp = sr*z2r - si*z2i + q[2*j];
+      si  = sr*z2i + si*z2r + q[2*j+1];
+      sr  = tmp;
+      tmp = or*z2r - oi*z2i + q[2*j+2];
+      oi  = or*z2i + oi*z2r + q[2*j+3];
+      or  = tmp;
+    }
+    sr += or*zr - oi*zi;
+    si += or*zi + oi*zr;
+    
+    // Times exp(-2 pi i f_low t_c,loc) and E:
+    phase = -tpi*ifo[ifonr]->bandFreq[0]*par->loctc[ifonr];
+    c = cos(phase);
+    s = sin(phase);
+    tmp = sr*c - si*s;
+    si  = sr*s + si*c;
+    sr  = tmp;
+    *overlaphd += E[0]*sr - E[1]*si;
+    *overlaphh += (E[0]*E[0] + E[1]*E[1]) * cacheHH[ifonr];
+    
+    q += 2*ifo[ifonr]->indexRange;
+  }
+  
+  return (*overlaphd - 0.5*(*overlaphh));
+} // End extrinsicLogLikelihood()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Prepare the inverse FFT for the time-marginalised likelihood
+ * 
+ * A shift of the template by dt multiplies h(f) by exp(-2 pi i f dt), hence <d|h> as a function of dt is the inverse Fourier 
+ * transform of the network cross-correlation d(f) h*(f), while <h|h> does not change.  The cross-correlation is zero-padded to 
+ * (at least) 16 times the highest Fourier index used, so that the time shifts are spaced by less than 1/(16 f_high).
+ * All detectors must have the same deltaFT;  the work space is stored in ifo[0].
+ */
+// ****************************************************************************************************************************************************  
+void setTimeMarginalisation(struct interferometer *ifo[], int networkSize, struct runPar run)
+{
+  int ifonr=0, n=1, maxIndex=0;
+  
+  for(ifonr=0; ifonr<networkSize; ifonr++) ifo[ifonr]->tMargN = 0;
+  if(run.marginaliseTime<=0) return;
+  
+  for(ifonr=0; ifonr<networkSize; ifonr++) {
+    if(fabs(ifo[ifonr]->deltaFT - ifo[0]->deltaFT) > 1.e-9*ifo[0]->deltaFT) {
+      fprintf(stderr, "\n\n   ERROR:  marginaliseTime needs the same length of data (%f s vs. %f s) in all detectors.\n   Aborting...\n\n",
+              ifo[ifonr]->deltaFT, ifo[0]->deltaFT);
+      exit(1);
+    }
+    if(ifo[ifonr]->highIndex > maxIndex) maxIndex = ifo[ifonr]->highIndex;
+  }
+  
+  while(n < 16*(maxIndex+1)) n *= 2;
+  
+  ifo[0]->tMargN    = n;
+  ifo[0]->tMargIn   = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * n);
+  ifo[0]->tMargOut  = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * n);
+  ifo[0]->tMargPlan = fftw_plan_dft_1d(n, ifo[0]->tMargIn, ifo[0]->tMargOut, FFTW_BACKWARD, FFTW_ESTIMATE);
+  for(n=0; n<ifo[0]->tMargN; n++) ifo[0]->tMargIn[n] = 0.0;
+  
+  // The time shifts wrap around after deltaFT:
+  if(run.tMargUp-run.tMargLow > 0.5*ifo[0]->deltaFT) {
+    fprintf(stderr, "\n ***  Warning:  the prior range of t_c (%.3f s) is more than half the length of the data (%.3f s) ***\n\n",
+            run.tMargUp-run.tMargLow, ifo[0]->deltaFT);
+  }
+  
+  if(run.beVerbose>=1) printf("   Time-marginalised likelihood:  %d time shifts of %.3g ms over %.3f s.\n",
+                              ifo[0]->tMargN, 1000.0*ifo[0]->deltaFT/(double)ifo[0]->tMargN, run.tMargUp-run.tMargLow);
+  
+} // End setTimeMarginalisation()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Add the cross-correlation d h* of IFO ifonr to the network cross-correlation for the time-marginalised likelihood
+ * 
+ * The template must be in the band of ifo[ifonr]->FTout.
+ */
+// ****************************************************************************************************************************************************  
+void addTimeCorrelation(struct interferometer *ifo[], int ifonr)
+{
+  int j=0, k=0;
+  fftw_complex *data = (fftw_complex*)ifo[ifonr]->weightedData;               // weightedData holds (re,im) pairs
+  fftw_complex *corr = ifo[0]->tMargIn;
+  
+  for(j=ifo[ifonr]->lowIndex; j<=ifo[ifonr]->highIndex; j++) {
+    k = j - ifo[ifonr]->lowIndex;
+    corr[j] += data[k] * conj(ifo[ifonr]->FTout[j]);
+  }
+  
+} // End addTimeCorrelation()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the range of time shifts nLow..nUp (in units of deltaFT/tMargN) that covers the prior range of t_c
+ */
+// ****************************************************************************************************************************************************  
+void timeShiftRange(struct parSet *par, struct interferometer *ifo, const struct likelihoodPar *likePar, int *nLow, int *nUp)
+{
+  double tc0 = par->par[likePar->parRevID[11]];
+  double dt = ifo->deltaFT/(double)ifo->tMargN;
+  
+  *nLow = (int)ceil((likePar->tMargLow - tc0)/dt);
+  *nUp  = (int)floor((likePar->tMargUp - tc0)/dt);
+  if(*nUp < *nLow) *nUp = *nLow;
+  
+} // End timeShiftRange()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(Likelihood) marginalised or maximised over t_c from the network cross-correlation
+ * 
+ * One inverse FFT gives <d|h> for all time shifts.  For marginaliseTime=1 the likelihood is averaged over the shifts within the 
+ * prior range of t_c (a flat prior), for marginaliseTime=2 the maximum is returned.
+ */
+// ****************************************************************************************************************************************************  
+double timeMarginalisedLogLikelihood(struct parSet *par, struct interferometer *ifo[], const struct likelihoodPar *likePar, double overlaphh)
+{
+  int n=0, m=0, nLow=0, nUp=0;
+  int N = ifo[0]->tMargN;
+  double hd=0.0, maxhd=-1.e30, sum=0.0;
+  
+  fftw_execute_dft(ifo[0]->tMargPlan, ifo[0]->tMargIn, ifo[0]->tMargOut);
+  timeShiftRange(par, ifo[0], likePar, &nLow, &nUp);
+  
+  for(n=nLow; n<=nUp; n++) {
+    m = ((n%N)+N)%N;                                                           // Negative shifts wrap around
+    hd = creal(ifo[0]->tMargOut[m]);
+    if(hd > maxhd) maxhd = hd;
+  }
+  
+  if(likePar->marginaliseTime==2) return (maxhd - 0.5*overlaphh);
+  
+  for(n=nLow; n<=nUp; n++) {
+    m = ((n%N)+N)%N;
+    sum += exp(creal(ifo[0]->tMargOut[m]) - maxhd);
+  }
+  
+  return (maxhd + log(sum/(double)(nUp-nLow+1)) - 0.5*overlaphh);
+  
+} // End timeMarginalisedLogLikelihood()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the imaginary part of sum d h* over the band of a single IFO;  the real part is <d|h>
+ * 
+ * The template must be in the band of ifo->FTout.  A change of the phase at coalescence phi_c by dphi multiplies h by 
+ * exp(i dphi), so that <d|h>(phi_c + dphi) = Re(exp(-i dphi) sum d h*).
+ */
+// ****************************************************************************************************************************************************  
+double bandOverlapImag(struct interferometer *ifo)
+{
+  int j=0, k=0;
+  double hdImag=0.0;
+  const double *data = ifo->weightedData;                                       // weightedData holds (re,im) pairs
+  
+  for(j=ifo->lowIndex; j<=ifo->highIndex; j++) {
+    k = j - ifo->lowIndex;
+    hdImag += data[2*k+1]*creal(ifo->FTout[j]) - data[2*k]*cimag(ifo->FTout[j]);
+  }
+  
+  return hdImag;
+  
+} // End bandOverlapImag()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the luminosity distance (Mpc) of the MCMC template with parameters par
+ */
+// ****************************************************************************************************************************************************  
+double templateDistance(struct parSet *par, const struct likelihoodPar *likePar)
+{
+  if(likePar->mcmcParUse[22]) return exp(par->par[likePar->parRevID[22]]);                    // 22: log(d_L) -> d_L
+  if(likePar->mcmcParUse[21]) return exp(log(par->par[likePar->parRevID[21]])/3.0);           // 21: (d_L)^3 -> d_L
+  return 1.0;
+} // End templateDistance()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return log(I_0(x)), with I_0 the modified Bessel function of the first kind, without overflow for large x
+ */
+// ****************************************************************************************************************************************************  
+double logBesselI0(double x)
+{
+  return x + log(gsl_sf_bessel_I0_scaled(x));
+} // End logBesselI0()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the log(Likelihood) marginalised over phi_c and/or d_L from the network overlaps of the reference template
+ * 
+ * With Z = sum d h* (complex) and H = <h|h> for the reference template at distance d0, a template at phase phi_c + dphi and 
+ * distance d has <d|h> = (d0/d) Re(Z exp(-i m dphi)) and <h|h> = (d0/d)^2 H, with m the phase factor of the waveform (see 
+ * getWaveformBackend()).  For a flat prior in phi_c over 2 pi, m dphi covers m full periods, so that the phase integral gives 
+ * I_0(|Z| d0/d) for any m;  m only matters when phi_c is drawn, in drawPhaseDistance().  The distance integral is a sum over the lookup table set up in setLikelihoodPar(), which includes the prior.
+ * The phase integral needs a waveform with the wfPhaseFactor capability, which readParameterInputfile() enforces.
+ */
+// ****************************************************************************************************************************************************  
+double phaseDistMarginalisedLogLikelihood(struct parSet *par, const struct likelihoodPar *likePar, double overlaphd, double overlaphdImag, double overlaphh)
+{
+  int i=0;
+  int margPhase = (likePar->marginalisePhaseDist!=2);
+  double absZ = sqrt(overlaphd*overlaphd + overlaphdImag*overlaphdImag);
+  double d0=0.0, rho=0.0, logL=0.0, maxLogL=-1.e30, sum=0.0;
+  
+  if(likePar->marginalisePhaseDist<2) return (logBesselI0(absZ) - 0.5*overlaphh);
+  
+  // Sum over the distance table with a running log-sum-exp:
+  d0 = templateDistance(par, likePar);
+  for(i=0; i<likePar->distMargN; i++) {
+    rho = d0/likePar->distMargD[i];
+    logL = (margPhase ? logBesselI0(rho*absZ) : rho*overlaphd) - 0.5*rho*rho*overlaphh + likePar->distMargLogW[i];
+    if(logL > maxLogL) {
+      sum = sum*exp(maxLogL-logL) + 1.0;
+      maxLogL = logL;
+    } else {
+      sum += exp(logL-maxLogL);
+    }
+  }
+  
+  return (maxLogL + log(sum));
+  
+} // End phaseDistMarginalisedLogLikelihood()
 // ****************************************************************************************************************************************************  
 
 
@@ -135,7 +1273,7 @@ double IFOlogLikelihood(struct parSet *par, struct interferometer *ifo[], int if
  * \brief Compute the SNR of the waveform with a given parameter set for a single IFO
  */
 // ****************************************************************************************************************************************************  
-double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run)
+double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
 // SNR of signal corresponding to parameter set, w.r.t. i-th interferometer's noise.
 // (see SNR definition in Christensen/Meyer/Libson (2004), p.323)
 {
@@ -143,15 +1281,20 @@ double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int
  // int tLength;
  // int j=0;
   
-  // Fill ifo[ifonr]->FTin with time-domain template:
-  waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, run);
-
-  // Window template, FTwindow is a Tukey window:
-  //for(j=0; j<ifo[ifonr]->samplesize; ++j)
-  //  ifo[ifonr]->FTin[j] *= ifo[ifonr]->FTwindow[j];
-  
-  // Execute Fourier transform of signal template:
-  fftw_execute(ifo[ifonr]->FTplan);
+  if(frequencyDomainTemplate(waveformVersion)) {
+    // Fill the band of ifo[ifonr]->FTout with the frequency-domain template:
+    waveformTemplateFD(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+  } else {
+    // Fill ifo[ifonr]->FTin with time-domain template:
+    waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+    
+    // Window template, FTwindow is a Tukey window:
+    //for(j=0; j<ifo[ifonr]->samplesize; ++j)
+    //  ifo[ifonr]->FTin[j] *= ifo[ifonr]->FTwindow[j];
+    
+    // Execute Fourier transform of signal template, for the band only:
+    templateFFT(ifo[ifonr]);
+  }
   
   // Compute the overlap between waveform and itself:
   double overlaphh = vecOverlap(ifo[ifonr]->FTout,
@@ -179,10 +1322,11 @@ double signalToNoiseRatio(struct parSet *par, struct interferometer *ifo[], int
  * \brief Compute match between waveforms with parameter sets par1 and par2
  */
 // ****************************************************************************************************************************************************  
-double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer *ifo[], int networkSize, struct runPar run)
+double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer *ifo[], int networkSize, const struct likelihoodPar *likePar)
 {
   double overlap11=0.0, overlap12=0.0, overlap22=0.0;
   int ifonr;
+  size_t scratchMark=0;
   fftw_complex *FFT1=NULL, *FFT2=NULL; 
   
   
@@ -201,22 +1345,21 @@ double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, str
   
   
   for(ifonr=0; ifonr<networkSize; ifonr++){
-    FFT1 = fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
-    FFT2 = fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
+    scratchMark = ifo[ifonr]->scratchUsed;                                      // Take FFT1,2 from the scratch arena of the IFO
+    FFT1 = (fftw_complex*)scratchAlloc(ifo[ifonr], sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
+    FFT2 = (fftw_complex*)scratchAlloc(ifo[ifonr], sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
     
-    signalFFT(FFT1, par1, ifo, ifonr, waveformVersion1, injectionWF1, run);
-    signalFFT(FFT2, par2, ifo, ifonr, waveformVersion2, injectionWF2, run);
+    signalFFT(FFT1, par1, ifo, ifonr, waveformVersion1, injectionWF1, likePar);
+    signalFFT(FFT2, par2, ifo, ifonr, waveformVersion2, injectionWF2, likePar);
     
     overlap11 += vecOverlap(FFT1, FFT1, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
     overlap12 += vecOverlap(FFT1, FFT2, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
     overlap22 += vecOverlap(FFT2, FFT2, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
+    ifo[ifonr]->scratchUsed = scratchMark;
   }
   
   double match = overlap12/sqrt(overlap11*overlap22);
   
-  free(FFT1);
-  free(FFT2);
-  
   return match;
   
 } // End of parMatch()
@@ -232,15 +1375,16 @@ double parMatch(struct parSet* par1, int waveformVersion1, int injectionWF1, str
  * \brief Compute frequency-domain overlap of waveform of given parameters with raw data
  */
 // ****************************************************************************************************************************************************  
-double overlapWithData(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run)
+double overlapWithData(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
 {
-  fftw_complex *FFTwaveform = fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
-  signalFFT(FFTwaveform, par, ifo, ifonr, waveformVersion, injectionWF, run);
+  size_t scratchMark = ifo[ifonr]->scratchUsed;                                 // Take FFTwaveform from the scratch arena of the IFO
+  fftw_complex *FFTwaveform = (fftw_complex*)scratchAlloc(ifo[ifonr], sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
+  signalFFT(FFTwaveform, par, ifo, ifonr, waveformVersion, injectionWF, likePar);
   
   double overlap = vecOverlap(ifo[ifonr]->raw_dataTrafo, FFTwaveform, ifo[ifonr]->noisePSD, 
                               ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
   
-  free(FFTwaveform);
+  ifo[ifonr]->scratchUsed = scratchMark;
   return overlap;
 } // End of overlapWithData()
 // ****************************************************************************************************************************************************  
@@ -254,21 +1398,21 @@ double overlapWithData(struct parSet *par, struct interferometer *ifo[], int ifo
  * \brief Compute the overlap in the frequency domain between two waveforms with parameter sets par1 and par2
  */
 // ****************************************************************************************************************************************************  
-double parOverlap(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer* ifo[], int ifonr, struct runPar run)
+double parOverlap(struct parSet* par1, int waveformVersion1, int injectionWF1, struct parSet* par2, int waveformVersion2, int injectionWF2, struct interferometer* ifo[], int ifonr, const struct likelihoodPar *likePar)
 {
   double overlap = 0.0;
-  fftw_complex *FFT1 = fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
-  fftw_complex *FFT2 = fftw_malloc(sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
+  size_t scratchMark = ifo[ifonr]->scratchUsed;                                 // Take FFT1,2 from the scratch arena of the IFO
+  fftw_complex *FFT1 = (fftw_complex*)scratchAlloc(ifo[ifonr], sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
+  fftw_complex *FFT2 = (fftw_complex*)scratchAlloc(ifo[ifonr], sizeof(fftw_complex) * (ifo[ifonr]->FTsize));
   
   // Get waveforms, FFT them and store them in FFT1,2
-  signalFFT(FFT1, par1, ifo, ifonr, waveformVersion1, injectionWF1, run);
-  signalFFT(FFT2, par2, ifo, ifonr, waveformVersion2, injectionWF2, run);
+  signalFFT(FFT1, par1, ifo, ifonr, waveformVersion1, injectionWF1, likePar);
+  signalFFT(FFT2, par2, ifo, ifonr, waveformVersion2, injectionWF2, likePar);
   
   // Compute the overlap between the vectors FFT1,2, between index i1 and i2:
   overlap = vecOverlap(FFT1, FFT2, ifo[ifonr]->noisePSD, ifo[ifonr]->lowIndex, ifo[ifonr]->highIndex, ifo[ifonr]->deltaFT);
   
-  fftw_free(FFT1);
-  fftw_free(FFT2);
+  ifo[ifonr]->scratchUsed = scratchMark;
   
   return overlap;
   
@@ -303,12 +1447,149 @@ double vecOverlap(fftw_complex *vec1, fftw_complex *vec2, double * noise, int j_
 
 
 
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> of a template with the data in a single pass
+ *
+ * h, weightedData and weight are n complex numbers, stored as interleaved (re,im) doubles.  The weights and weighted data
+ * are set up in IFOinit(), so that the sums reduce to real dot products over 2n elements:
+ *   <d|h> = sum weightedData*h,   <h|h> = sum weight*h*h.
+ * SSE2 and AVX2 versions are used when the compiler supports them, with a scalar loop for the remaining elements.
+ */
+// ****************************************************************************************************************************************************  
+void vecOverlapFused(const double *h, const double *weightedData, const double *weight, int n, double *overlaphd, double *overlaphh)
+{
+  int k=0, n2=2*n;
+  double hd=0.0, hh=0.0;
+
+#if defined(__AVX2__)
+  double sum[4];
+  __m256d vh, vhd0=_mm256_setzero_pd(), vhh0=_mm256_setzero_pd(), vhd1=_mm256_setzero_pd(), vhh1=_mm256_setzero_pd();
+
+  // Two independent accumulators to hide the latency of the additions:
+  for(k=0; k<=n2-8; k+=8) {
+    vh   = _mm256_loadu_pd(h+k);
+    vhd0 = _mm256_add_pd(vhd0, _mm256_mul_pd(vh, _mm256_loadu_pd(weightedData+k)));
+    vhh0 = _mm256_add_pd(vhh0, _mm256_mul_pd(_mm256_mul_pd(vh,vh), _mm256_loadu_pd(weight+k)));
+    vh   = _mm256_loadu_pd(h+k+4);
+    vhd1 = _mm256_add_pd(vhd1, _mm256_mul_pd(vh, _mm256_loadu_pd(weightedData+k+4)));
+    vhh1 = _mm256_add_pd(vhh1, _mm256_mul_pd(_mm256_mul_pd(vh,vh), _mm256_loadu_pd(weight+k+4)));
+  }
+  _mm256_storeu_pd(sum, _mm256_add_pd(vhd0,vhd1));
+  hd = (sum[0]+sum[1]) + (sum[2]+sum[3]);
+  _mm256_storeu_pd(sum, _mm256_add_pd(vhh0,vhh1));
+  hh = (sum[0]+sum[1]) + (sum[2]+sum[3]);
+
+#elif defined(__SSE2__)
+  double sum[2];
+  __m128d vh, vhd0=_mm_setzero_pd(), vhh0=_mm_setzero_pd(), vhd1=_mm_setzero_pd(), vhh1=_mm_setzero_pd();
+
+  // Two independent accumulators to hide the latency of the additions:
+  for(k=0; k<=n2-4; k+=4) {
+    vh   = _mm_loadu_pd(h+k);
+    vhd0 = _mm_add_pd(vhd0, _mm_mul_pd(vh, _mm_loadu_pd(weightedData+k)));
+    vhh0 = _mm_add_pd(vhh0, _mm_mul_pd(_mm_mul_pd(vh,vh), _mm_loadu_pd(weight+k)));
+    vh   = _mm_loadu_pd(h+k+2);
+    vhd1 = _mm_add_pd(vhd1, _mm_mul_pd(vh, _mm_loadu_pd(weightedData+k+2)));
+    vhh1 = _mm_add_pd(vhh1, _mm_mul_pd(_mm_mul_pd(vh,vh), _mm_loadu_pd(weight+k+2)));
+  }
+  _mm_storeu_pd(sum, _mm_add_pd(vhd0,vhd1));
+  hd = sum[0]+sum[1];
+  _mm_storeu_pd(sum, _mm_add_pd(vhh0,vhh1));
+  hh = sum[0]+sum[1];
+#endif
+
+  // Scalar version, or the remaining elements of the vectorised versions:
+  for(; k<n2; ++k) {
+    hd += weightedData[k]*h[k];
+    hh += weight[k]*h[k]*h[k];
+  }
+
+  *overlaphd = hd;
+  *overlaphh = hh;
+
+} // End of vecOverlapFused()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the overlaps <d|h> and <h|h> of a single-precision template with the data in a single pass
+ *
+ * As vecOverlapFused(), for float arrays.  The products are computed in single precision and accumulated in double precision.
+ */
+// ****************************************************************************************************************************************************  
+void vecOverlapFusedFloat(const float *h, const float *weightedData, const float *weight, int n, double *overlaphd, double *overlaphh)
+{
+  int k=0, n2=2*n;
+  double hd=0.0, hh=0.0;
+
+#if defined(__AVX2__)
+  double sum[4];
+  __m256  vh, vhd, vhh;
+  __m256d shd0=_mm256_setzero_pd(), shh0=_mm256_setzero_pd(), shd1=_mm256_setzero_pd(), shh1=_mm256_setzero_pd();
+
+  // Eight products per iteration, widened to double in two halves:
+  for(k=0; k<=n2-8; k+=8) {
+    vh   = _mm256_loadu_ps(h+k);
+    vhd  = _mm256_mul_ps(vh, _mm256_loadu_ps(weightedData+k));
+    vhh  = _mm256_mul_ps(_mm256_mul_ps(vh,vh), _mm256_loadu_ps(weight+k));
+    shd0 = _mm256_add_pd(shd0, _mm256_cvtps_pd(_mm256_castps256_ps128(vhd)));
+    shd1 = _mm256_add_pd(shd1, _mm256_cvtps_pd(_mm256_extractf128_ps(vhd,1)));
+    shh0 = _mm256_add_pd(shh0, _mm256_cvtps_pd(_mm256_castps256_ps128(vhh)));
+    shh1 = _mm256_add_pd(shh1, _mm256_cvtps_pd(_mm256_extractf128_ps(vhh,1)));
+  }
+  _mm256_storeu_pd(sum, _mm256_add_pd(shd0,shd1));
+  hd = (sum[0]+sum[1]) + (sum[2]+sum[3]);
+  _mm256_storeu_pd(sum, _mm256_add_pd(shh0,shh1));
+  hh = (sum[0]+sum[1]) + (sum[2]+sum[3]);
+
+#elif defined(__SSE2__)
+  double sum[2];
+  __m128  vh, vhd, vhh;
+  __m128d shd0=_mm_setzero_pd(), shh0=_mm_setzero_pd(), shd1=_mm_setzero_pd(), shh1=_mm_setzero_pd();
+
+  // Four products per iteration, widened to double in two halves:
+  for(k=0; k<=n2-4; k+=4) {
+    vh   = _mm_loadu_ps(h+k);
+    vhd  = _mm_mul_ps(vh, _mm_loadu_ps(weightedData+k));
+    vhh  = _mm_mul_ps(_mm_mul_ps(vh,vh), _mm_loadu_ps(weight+k));
+    shd0 = _mm_add_pd(shd0, _mm_cvtps_pd(vhd));
+    shd1 = _mm_add_pd(shd1, _mm_cvtps_pd(_mm_movehl_ps(vhd,vhd)));
+    shh0 = _mm_add_pd(shh0, _mm_cvtps_pd(vhh));
+    shh1 = _mm_add_pd(shh1, _mm_cvtps_pd(_mm_movehl_ps(vhh,vhh)));
+  }
+  _mm_storeu_pd(sum, _mm_add_pd(shd0,shd1));
+  hd = sum[0]+sum[1];
+  _mm_storeu_pd(sum, _mm_add_pd(shh0,shh1));
+  hh = sum[0]+sum[1];
+#endif
+
+  // Scalar version, or the remaining elements of the vectorised versions:
+  for(; k<n2; ++k) {
+    hd += (double)(weightedData[k]*h[k]);
+    hh += (double)(weight[k]*h[k]*h[k]);
+  }
+
+  *overlaphd = hd;
+  *overlaphh = hh;
+
+} // End of vecOverlapFusedFloat()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
 // ****************************************************************************************************************************************************  
 /**
  * \brief Compute the FFT of a waveform with given parameter set
  */
 // ****************************************************************************************************************************************************  
-void signalFFT(fftw_complex* FFTout, struct parSet* par, struct interferometer* ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run)
+void signalFFT(fftw_complex* FFTout, struct parSet* par, struct interferometer* ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
 {
   //int tStart, tEnd;
   //int tLength;
@@ -320,14 +1601,21 @@ void signalFFT(fftw_complex* FFTout, struct parSet* par, struct interferometer*
   
   //printf("  signalFFT:  %i  %i\n", waveformVersion, injectionWF);
   
-  // Fill ifo[i]->FTin with time-domain template:
-  waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, run);
-  
-  // Window template, FTwindow is a Tukey window:
-  //for(j=0; j<ifo[ifonr]->samplesize; ++j) ifo[ifonr]->FTin[j] *= ifo[ifonr]->FTwindow[j];
-  
-  // Execute Fourier transform of signal template:
-  fftw_execute(ifo[ifonr]->FTplan);
+  if(frequencyDomainTemplate(waveformVersion)) {
+    // Fill the band of ifo[ifonr]->FTout with the frequency-domain template, and set the rest of the spectrum to zero:
+    waveformTemplateFD(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+    for(j=0; j<ifo[ifonr]->lowIndex; j++) ifo[ifonr]->FTout[j] = 0.0;
+    for(j=ifo[ifonr]->highIndex+1; j<ifo[ifonr]->FTsize; j++) ifo[ifonr]->FTout[j] = 0.0;
+  } else {
+    // Fill ifo[i]->FTin with time-domain template:
+    waveformTemplate(par, ifo, ifonr, waveformVersion, injectionWF, likePar);
+    
+    // Window template, FTwindow is a Tukey window:
+    //for(j=0; j<ifo[ifonr]->samplesize; ++j) ifo[ifonr]->FTin[j] *= ifo[ifonr]->FTwindow[j];
+    
+    // Execute Fourier transform of signal template:
+    fftw_execute_dft_r2c(ifo[ifonr]->FTplan, ifo[ifonr]->FTin, ifo[ifonr]->FTout);
+  }
   
   for(j=0; j<ifo[ifonr]->FTsize; j++) FFTout[j] = ifo[ifonr]->FTout[j]/((double)ifo[ifonr]->samplerate);
   
@@ -342,27 +1630,35 @@ void signalFFT(fftw_complex* FFTout, struct parSet* par, struct interferometer*
  * \todo Add support for two different waveform families
  */
 // ****************************************************************************************************************************************************  
-double matchBetweenParameterArrayAndTrueParameters(double * pararray, struct interferometer *ifo[], struct MCMCvariables mcmc, struct runPar run)
+double matchBetweenParameterArrayAndTrueParameters(double * pararray, struct interferometer *ifo[], const struct MCMCvariables *mcmc, const struct likelihoodPar *likePar)
 {
   struct parSet par, injectPar;
   int i=0;
   int injectionWF = 1;                                     // Call localPar or parMatch with the injection template
   int mcmcWF = 0;                                          // Call localPar or parMatch with the MCMC template
-  for(i=0;i<mcmc.nMCMCpar;i++) {
+  double match = 0.0;
+  for(i=0;i<mcmc->nMCMCpar;i++) {
     par.par[i] = pararray[i];
   }
-  allocParset(&par,mcmc.networkSize);
-  localPar(&par, ifo, mcmc.networkSize, mcmcWF, run);  // Call localPar for an MCMC template
+  
+  // The local parameters are kept in the scratch arena of ifo[0], and must stay there until parMatch() has used them:
+  size_t scratchMark = ifo[0]->scratchUsed;
+  par.loctc         = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  par.localti       = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  par.locazi        = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  injectPar.loctc   = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  injectPar.localti = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  injectPar.locazi  = (double*)scratchAlloc(ifo[0], sizeof(double)*mcmc->networkSize);
+  localPar(&par, ifo, mcmc->networkSize, mcmcWF, likePar);  // Call localPar for an MCMC template
   
   //Get the injection parameters:
-  getInjectionParameters(&injectPar, mcmc.nInjectPar, mcmc.injParVal);
-  allocParset(&injectPar,mcmc.networkSize);
-  localPar(&injectPar, ifo, mcmc.networkSize, injectionWF, run);  // Call localPar for an injection template
+  getInjectionParameters(&injectPar, mcmc->nInjectPar, mcmc->injParVal);
+  localPar(&injectPar, ifo, mcmc->networkSize, injectionWF, likePar);  // Call localPar for an injection template
   
-  freeParset(&par);
-  freeParset(&injectPar);
+  match = parMatch(&injectPar, mcmc->injectionWaveform, injectionWF, &par, mcmc->mcmcWaveform, mcmcWF, ifo, mcmc->networkSize, likePar);
   
-  return parMatch(&injectPar, mcmc.injectionWaveform, injectionWF, &par, mcmc.mcmcWaveform, mcmcWF, ifo, mcmc.networkSize, run);
+  ifo[0]->scratchUsed = scratchMark;
+  return match;
 } // End of matchBetweenParameterArrayAndTrueParameters()
 // ****************************************************************************************************************************************************  
 
@@ -373,7 +1669,7 @@ double matchBetweenParameterArrayAndTrueParameters(double * pararray, struct int
  */
 // ****************************************************************************************************************************************************  
 
-double logLikelihood_nine(struct parSet *par, int waveformVersion, int injectionWF, struct runPar run)
+double logLikelihood_nine(struct parSet *par, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
 {
   double result=0.0;
   double sumsq=0.0;
@@ -386,11 +1682,11 @@ double logLikelihood_nine(struct parSet *par, int waveformVersion, int injection
   waveformVersion = waveformVersion;  // Suppress 'never referenced' warnings from icc
   injectionWF = injectionWF;          // Suppress 'never referenced' warnings from icc
   
-  for(i=0;i<run.nMCMCpar;i++){
-    x[i]= par->par[run.parRevID[185+i]];
+  for(i=0;i<likePar->nMCMCpar;i++){
+    x[i]= par->par[likePar->parRevID[185+i]];
   }
   
-  for(i=0;i<run.nMCMCpar;i++){
+  for(i=0;i<likePar->nMCMCpar;i++){
     sumsq+=(x[i]-xmax)*(x[i]-xmax)/(2*deltax);
     //norm+=-0.91893853320468-log(sqrt(deltax));
   }
@@ -423,7 +1719,7 @@ double logLikelihood_nine(struct parSet *par, int waveformVersion, int injection
   j2 = ifo[ifonr]->highIndex;
   
   // Compute the FFTed signal for the default parameter set FFT0
-  signalFFT(FFT0, par, ifo, ifonr, waveformVersion, injectionWF, run);
+  signalFFT(FFT0, par, ifo, ifonr, waveformVersion, injectionWF, likePar);
   
   for(ip=0;ip<nParameters;ip++) {
   // Change parameter ip with dx
@@ -433,7 +1729,7 @@ double logLikelihood_nine(struct parSet *par, int waveformVersion, int injection
   arr2par(pars,&par1);  // Put the changed parameter set into struct par1
   
   // Compute the FFTed signal for this parameter set FFT1
-  signalFFT(par1, ifo, networkSize, ifonr, FFT1, waveformVersion, injectionWF, run);
+  signalFFT(par1, ifo, networkSize, ifonr, FFT1, waveformVersion, injectionWF, likePar);
   
   // Compute the partial derivative to parameter ip
   for(j=j1;j<=j2;j++) {
@@ -39,79 +39,422 @@
 
 
 
+// Registry of the waveform backends, by waveformVersion.  The analytic likelihood (waveformVersion 9) has no waveform and is not listed.
+//   Apostolatos and TaylorF2 have wfPhaseFactor with m=1, since phi_c is the phase offset of their single GW harmonic;  LALnonSpinning 
+//   with m=2, since it is a dominant-harmonic template and phi_c its orbital phase.  The phase of the other LAL templates (precession, 
+//   higher harmonics) is not an overall factor.  LAL12, LAL15 and LALnonSpinning are thread safe if LAL is (wfLALThreadSafe):
+static const struct waveformBackend waveformBackends[] = {
+  {1, "Apostolatos",         wfDistanceScaling | wfThreadSafe | wfSupport | wfMultirate | wfPhaseFactor,                         1, templateApostolatos,         NULL,             NULL,               NULL,                      NULL},
+  {2, "LAL12",               wfDistanceScaling | wfSupport | wfLALThreadSafe,                                                    0, templateLAL12,               NULL,             NULL,               NULL,                      NULL},
+  {3, "LAL15",               wfDistanceScaling | wfSupport | wfPolarisations | wfTaper | wfLALThreadSafe,                        0, templateLAL15,               NULL,             templateLALnetwork, NULL,                      NULL},
+  {4, "LALnonSpinning",      wfDistanceScaling | wfSupport | wfPolarisations | wfTaper | wfLALThreadSafe | wfPhaseFactor,        2, templateLALnonSpinning,      NULL,             templateLALnetwork, NULL,                      NULL},
+  {5, "LALPhenSpinTaylorRD", wfDistanceScaling | wfSupport,                                                                      0, templateLALPhenSpinTaylorRD, NULL,             NULL,               NULL,                      NULL},
+  {6, "TaylorF2",            wfFrequencyDomain | wfDistanceScaling | wfThreadSafe | wfExtrinsic | wfPhaseFactor,                 1, NULL,                        templateTaylorF2, NULL,               templateTaylorF2intrinsic, templateTaylorF2extrinsic}
+};
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Look up the backend of a waveform in the registry
+ * 
+ * Return NULL if waveformVersion has no backend.  LAL allocates and reports errors through its own (global) state, which is 
+ * protected by pthread locks only if LAL was configured with --enable-pthread-lock.  The LAL backends are flagged thread safe 
+ * in that case only (SPINSPIRAL_LAL_THREADSAFE, set by CMake);  LALPhenSpinTaylorRD never is.
+ */
+// ****************************************************************************************************************************************************  
+const struct waveformBackend *getWaveformBackend(int waveformVersion)
+{
+  int i=0;
+  for(i=0; i<(int)(sizeof(waveformBackends)/sizeof(waveformBackends[0])); i++) {
+    if(waveformBackends[i].version == waveformVersion) return &waveformBackends[i];
+  }
+  return NULL;
+} // End of getWaveformBackend()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine whether the backend of waveformVersion has all the capabilities in flags (wfFrequencyDomain, ...);  0 if it has no backend
+ */
+// ****************************************************************************************************************************************************  
+int waveformCapability(int waveformVersion, int flags)
+{
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  if(backend==NULL) return 0;
+  return ((backend->flags & flags) == flags);
+} // End of waveformCapability()
+// ****************************************************************************************************************************************************  
+
+
+
 // ****************************************************************************************************************************************************  
 /**
  * \brief Compute an inspiral waveform
  * 
  * Compute an inspiral waveform template.
- * waveformVersion determines the template to use.
+ * waveformVersion determines the template to use, through its backend (see getWaveformBackend()).
  * injectionWF indicates whether this is an injection waveform (1) or not (0).
  */
 // ****************************************************************************************************************************************************  
-void waveformTemplate(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, struct runPar run)
+void waveformTemplate(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
+{
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  
+  if(backend==NULL) {
+    fprintf(stderr,"\n\n   ERROR:  waveformTemplate(): waveformVersion %i not defined!\n\n",waveformVersion);
+    exit(1);
+  }
+  if(backend->templateTD==NULL) {
+    fprintf(stderr,"\n\n   ERROR:  waveformTemplate(): waveformVersion %i is a frequency-domain template, use waveformTemplateFD()!\n\n",waveformVersion);
+    exit(1);
+  }
+  
+  backend->templateTD(par, ifo, ifonr, injectionWF, likePar);    // Fill ifo[ifonr]->FTin
+  if(!(backend->flags & wfSupport)) ifo[ifonr]->tStart = -1;     // Support unknown
+  if(backend->flags & wfTaper) taperTemplate(ifo[ifonr], likePar);  // Window the template, excluding the zero padding
+  
+} // End of waveformTemplate()
+// ****************************************************************************************************************************************************  
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute an inspiral waveform for all detectors in the network at once
+ * 
+ * For waveforms where h_+ and h_x do not depend on the detector, compute the polarisations once and project them onto each detector,
+ * rather than calling waveformTemplate() for every IFO.  Fills ifo[i]->FTin for i=0..networkSize-1.
+ * Only call this when networkTemplateAllowed() returns 1.
+ */
+// ****************************************************************************************************************************************************  
+void networkWaveformTemplate(struct parSet *par, struct interferometer *ifo[], int networkSize, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
+{
+  int ifonr=0;
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  
+  if(backend!=NULL && backend->templateNetwork!=NULL) {
+    backend->templateNetwork(par, ifo, networkSize, waveformVersion, injectionWF, likePar);  // Compute h_+,h_x once, apply F_+,F_x and the time delay per IFO
+    for(ifonr=0; ifonr<networkSize; ifonr++) {
+      if(!(backend->flags & wfSupport)) ifo[ifonr]->tStart = -1;
+      if(backend->flags & wfTaper) taperTemplate(ifo[ifonr], likePar);
+    }
+  } else {
+    fprintf(stderr,"\n\n   ERROR:  networkWaveformTemplate(): waveformVersion %i not supported!\n\n",waveformVersion);
+    exit(1);
+  }
+  
+} // End of networkWaveformTemplate()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine whether networkWaveformTemplate() can be used
+ * 
+ * This is the case for the waveforms with the wfPolarisations capability (the LAL waveforms 3 and 4), whose h_+,h_x depend on the 
+ * detector only through the cut-off frequencies, the sampling rate and the sample size.  These must then be the same for all IFOs.
+ */
+// ****************************************************************************************************************************************************  
+int networkTemplateAllowed(struct interferometer *ifo[], int networkSize, int waveformVersion)
+{
+  int ifonr=0;
+  
+  if(networkSize<2) return 0;
+  if(!waveformCapability(waveformVersion, wfPolarisations)) return 0;
+  
+  for(ifonr=1; ifonr<networkSize; ifonr++) {
+    if(ifo[ifonr]->lowCut     != ifo[0]->lowCut     ||
+       ifo[ifonr]->highCut    != ifo[0]->highCut    ||
+       ifo[ifonr]->samplerate != ifo[0]->samplerate ||
+       ifo[ifonr]->samplesize != ifo[0]->samplesize) return 0;
+  }
+  
+  return 1;
+} // End of networkTemplateAllowed()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute an inspiral waveform directly in the frequency domain
+ * 
+ * Fill ifo[ifonr]->FTout[lowIndex..highIndex] with the template, in the same units as the (unnormalised) FFT of a time-domain
+ * template in ifo[ifonr]->FTin.  No time-domain template or FFT is computed, and the bins outside the band are not touched.
+ * Only call this when frequencyDomainTemplate() returns 1.
+ */
+// ****************************************************************************************************************************************************  
+void waveformTemplateFD(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar)
+{
+  waveformTemplateFDfreq(par, ifo, ifonr, waveformVersion, injectionWF, likePar,
+                         ifo[ifonr]->bandFreq, ifo[ifonr]->indexRange, (double*)(ifo[ifonr]->FTout + ifo[ifonr]->lowIndex));
+  
+} // End of waveformTemplateFD()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute an inspiral waveform in the frequency domain, at a given list of frequencies
+ * 
+ * Store the template at the nFreq frequencies freq[] in h, as (re,im) pairs, in the units of waveformTemplateFD().
+ * This is used by waveformTemplateFD() for the whole band, and by the relative-binning likelihood for the bin edges.
+ */
+// ****************************************************************************************************************************************************  
+void waveformTemplateFDfreq(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, int injectionWF, const struct likelihoodPar *likePar,
+                            const double *freq, int nFreq, double *h)
+{
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  
+  if(backend!=NULL && backend->templateFD!=NULL) {
+    backend->templateFD(par, ifo, ifonr, injectionWF, likePar, freq, nFreq, h);
+  } else {
+    fprintf(stderr,"\n\n   ERROR:  waveformTemplateFDfreq(): waveformVersion %i is not a frequency-domain template!\n\n",waveformVersion);
+    exit(1);
+  }
+  
+} // End of waveformTemplateFDfreq()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine whether waveformVersion is computed in the frequency domain, by waveformTemplateFD()
+ */
+// ****************************************************************************************************************************************************  
+int frequencyDomainTemplate(int waveformVersion)
+{
+  return waveformCapability(waveformVersion, wfFrequencyDomain);
+} // End of frequencyDomainTemplate()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the intrinsic part u(f) of a frequency-domain template, at a given list of frequencies
+ * 
+ * For the waveforms with the wfExtrinsic capability, the template factorises as h(f) = u(f) E exp(-2 pi i f t_c,loc), where u depends on
+ * the intrinsic parameters only and E on the extrinsic parameters (see extrinsicParameter() and waveformExtrinsicFactor()).
+ * Store u at the nFreq frequencies freq[] in h, as (re,im) pairs, in the units of waveformTemplateFD().  MCMC templates only.
+ */
+// ****************************************************************************************************************************************************  
+void waveformTemplateIntrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, const struct likelihoodPar *likePar,
+                               const double *freq, int nFreq, double *h)
+{
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  
+  if(backend!=NULL && backend->templateIntrinsic!=NULL) {
+    backend->templateIntrinsic(par, ifo, ifonr, 0, likePar, freq, nFreq, h);
+  } else {
+    fprintf(stderr,"\n\n   ERROR:  waveformTemplateIntrinsic(): waveformVersion %i does not factorise into intrinsic and extrinsic parts!\n\n",waveformVersion);
+    exit(1);
+  }
+  
+} // End of waveformTemplateIntrinsic()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the complex factor E of the extrinsic parameters of a frequency-domain template, as (re,im) in factor
+ * 
+ * See waveformTemplateIntrinsic().  localPar() must have been called for par, for the local coalescence time.  MCMC templates only.
+ */
+// ****************************************************************************************************************************************************  
+void waveformExtrinsicFactor(struct parSet *par, struct interferometer *ifo[], int ifonr, int waveformVersion, const struct likelihoodPar *likePar, double *factor)
+{
+  const struct waveformBackend *backend = getWaveformBackend(waveformVersion);
+  
+  if(backend!=NULL && backend->extrinsicFactor!=NULL) {
+    backend->extrinsicFactor(par, ifo, ifonr, 0, likePar, factor);
+  } else {
+    fprintf(stderr,"\n\n   ERROR:  waveformExtrinsicFactor(): waveformVersion %i does not factorise into intrinsic and extrinsic parts!\n\n",waveformVersion);
+    exit(1);
+  }
+  
+} // End of waveformExtrinsicFactor()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Determine whether the parameter with ID parID is extrinsic, i.e. whether the intrinsic part of a wfExtrinsic template is independent of it
+ * 
+ * These are t_c, the distance, the sky position, phi_c, the inclination and the polarisation angle.
+ */
+// ****************************************************************************************************************************************************  
+int extrinsicParameter(int parID)
+{
+  return (parID==11 || parID==21 || parID==22 || parID==31 || parID==32 || parID==41 || parID==51 || parID==52);
+} // End of extrinsicParameter()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Zero the time-domain template in ifo->FTin outside the samples tStart..tEnd and record this support
+ * 
+ * Only the samples of the previous support that fall outside the new one are zeroed, since the rest of FTin is zero already.
+ * If the previous support is unknown (ifo->tStart<0, e.g. after FTin was used for the data in dataFT()), the whole of FTin is zeroed.
+ * Use tStart=0, tEnd=-1 for an empty template.
+ */
+// ****************************************************************************************************************************************************  
+void setTemplateSupport(struct interferometer *ifo, int tStart, int tEnd)
+{
+  int j=0;
+  int empty = (tEnd<tStart);
+  int oldStart = ifo->tStart, oldEnd = ifo->tEnd;
+  
+  if(oldStart<0) {                                                                       // Unknown: zero everything
+    oldStart = 0;
+    oldEnd = ifo->samplesize-1;
+  }
+  if(empty) {                                                                            // Empty: zero the whole old support
+    tStart = oldEnd+1;
+    tEnd = oldEnd;
+  }
+  
+  for(j=oldStart; j<=oldEnd && j<tStart; j++) ifo->FTin[j] = 0.0;
+  for(j=max(oldStart,tEnd+1); j<=oldEnd; j++) ifo->FTin[j] = 0.0;
+  
+  ifo->tStart = empty ? 0  : tStart;
+  ifo->tEnd   = empty ? -1 : tEnd;
+  
+} // End of setTemplateSupport()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Copy a time-domain template of length ifo->samplesize into ifo->FTin and record its support
+ * 
+ * The support is the stretch from the first to the last non-zero sample, as used by taperTemplate().  Only the support is copied;
+ * the zero padding around it is cleared by setTemplateSupport().
+ */
+// ****************************************************************************************************************************************************  
+void copyTemplate(struct interferometer *ifo, const double *wave)
 {
   int j=0;
-  int tStart, tEnd;     // Start and end of templatea
+  int tStart=0, tEnd=ifo->samplesize-1;
+  
+  while(tStart<=tEnd && wave[tStart] == 0.0) tStart++;
+  while(tEnd>=tStart && wave[tEnd] == 0.0) tEnd--;
+  
+  setTemplateSupport(ifo, tStart, tEnd);
+  for(j=tStart; j<=tEnd; j++) ifo->FTin[j] = wave[j];
+  
+} // End of copyTemplate()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Apply a modified Tukey window to the time-domain template in ifo->FTin
+ * 
+ * Window the non-zero part of the template only, from ifo->tStart to ifo->tEnd as set by the template routine.  If the support is
+ * unknown, determine the start and end of the template (excluding the zero padding) from FTin.  The window is 1 between its two 
+ * edges, so only the edges are multiplied, with the tables from taperWindow().
+ */
+// ****************************************************************************************************************************************************  
+void taperTemplate(struct interferometer *ifo, const struct likelihoodPar *likePar)
+{
+  int j=0, slot=0;
+  int tStart, tEnd;     // Start and end of template
   int tLength;          // Template length
-  //CHECK: test - remove this
-  /*
-    int i=0;
-    printf("\n\n\n*** waveformTemplate(): %i %i  ", waveformVersion, injectionWF);
-    for(i=0;i<par->nPar;i++) {
-    printf(" %i:%6.3lf", i, par->par[i]);
-    }
-    printf("\n");
-  */
-  if(waveformVersion==1) {
-    templateApostolatos(par, ifo, ifonr, injectionWF, run);  // Apostolatos 12-parameter template
-  } else if(waveformVersion==2) {
-    templateLAL12(par, ifo, ifonr, injectionWF, run);  // LAL 12-parameter template
-  } else if(waveformVersion==3) {
-    templateLAL15(par, ifo, ifonr, injectionWF, run);  // LAL 15-parameter template
-
-    // Determine template start and end (exclude 0 padding):
+  
+  // Determine template start and end (exclude 0 padding), if the template routine did not:
+  if(ifo->tStart<0) {
     j = 0;
-    while( ifo[ifonr]->FTin[j] == 0 )
+    while( j<ifo->samplesize && ifo->FTin[j] == 0 )
       j++;
+    if(j==ifo->samplesize) return;  // Empty template, e.g. because LAL failed to compute it
     tStart = j;
-
-    j = ifo[ifonr]->samplesize-1;
-    while( ifo[ifonr]->FTin[j] == 0 )
+    
+    j = ifo->samplesize-1;
+    while( ifo->FTin[j] == 0 )
       j--;
     tEnd = j;
-    tLength = tEnd - tStart;
+  } else {
+    tStart = ifo->tStart;
+    tEnd   = ifo->tEnd;
+    if(tEnd<tStart) return;         // Empty template
+  }
+  tLength = tEnd - tStart;
+  
+  // Window template edges (not padding):
+  slot = taperWindow(ifo, tLength, likePar);
+  double *win = ifo->taperWin[slot];
+  double *FTrise = ifo->FTin + tStart;
+  double *FTfall = ifo->FTin + tEnd+1 - ifo->taperFall[slot];
+  for(j=0; j<ifo->taperRise[slot]; j++) FTrise[j] *= win[j];
+  win += ifo->taperRise[slot];
+  for(j=0; j<ifo->taperFall[slot]; j++) FTfall[j] *= win[j];
+  
+} // End of taperTemplate()
+// ****************************************************************************************************************************************************  
+
 
-    // Window template (not padding):
-    for( j=tStart; j<=tEnd; j++)
-      ifo[ifonr]->FTin[j] *= modifiedTukeyWindow(j-tStart, tLength, run.tukey1, run.tukey2);
 
-  } else if(waveformVersion==4) {
-    templateLALnonSpinning(par, ifo, ifonr, injectionWF, run);  // LAL non-spinning template
-    
-    // Determine template start and end (exclude 0 padding):
-    j = 0;
-    while( ifo[ifonr]->FTin[j] == 0 )
-      j++;
-    tStart = j;
 
-    j = ifo[ifonr]->samplesize-1;
-    while( ifo[ifonr]->FTin[j] == 0 )
-      j--;
-    tEnd = j;
-    tLength = tEnd - tStart;
 
-    // Window template (not padding):
-    for( j=tStart; j<=tEnd; j++)
-      ifo[ifonr]->FTin[j] *= modifiedTukeyWindow(j-tStart, tLength, run.tukey1, run.tukey2);
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Return the slot in the taper-window cache of ifo that holds the modified Tukey window for template length N
+ * 
+ * The cache holds the rising and falling edges of the window (see modifiedTukeyWindow()) for the taperCacheSize template lengths 
+ * used last.  On a miss, the oldest slot is refilled;  the cache is emptied when the Tukey parameters in likePar change.
+ * The tables are allocated by setScratch().
+ */
+// ****************************************************************************************************************************************************  
+int taperWindow(struct interferometer *ifo, int N, const struct likelihoodPar *likePar)
+{
+  int j=0, slot=0, nRise=0, nFall=0;
   
-  } else if(waveformVersion==5) {
-	templateLALPhenSpinTaylorRD(par, ifo, ifonr, injectionWF, run);  // LAL PhenSpinTaylorRD template
-  } else {
-    fprintf(stderr,"\n\n   ERROR:  waveformTemplate(): waveformVersion %i not defined!\n\n",waveformVersion);
-    exit(1);
+  if(ifo->taperTukey1 != likePar->tukey1 || ifo->taperTukey2 != likePar->tukey2) {
+    for(slot=0; slot<taperCacheSize; slot++) ifo->taperN[slot] = -1;
+    ifo->taperTukey1 = likePar->tukey1;
+    ifo->taperTukey2 = likePar->tukey2;
   }
   
-} // End of waveformTemplate()
+  for(slot=0; slot<taperCacheSize; slot++) {
+    if(ifo->taperN[slot]==N) return slot;
+  }
+  
+  // Samples j=0..N where the window differs from 1:
+  while(nRise<=N && ((double)nRise) < (likePar->tukey1 * (((double)N) / 2.0))) nRise++;
+  while(N-nFall>=nRise && ((double)(N-nFall)) > (((double)N)*(1.0-(likePar->tukey2/2.0)))) nFall++;
+  
+  slot = ifo->taperNext;
+  ifo->taperNext = (ifo->taperNext+1) % taperCacheSize;
+  if(nRise+nFall > ifo->taperCap[slot]) {                           // Only if the Tukey parameters differ from those given to setScratch()
+    ifo->taperWin[slot] = (double*)realloc(ifo->taperWin[slot], sizeof(double)*(nRise+nFall));
+    ifo->taperCap[slot] = nRise+nFall;
+  }
+  for(j=0; j<nRise; j++) ifo->taperWin[slot][j] = modifiedTukeyWindow(j, N, likePar->tukey1, likePar->tukey2);
+  for(j=0; j<nFall; j++) ifo->taperWin[slot][nRise+j] = modifiedTukeyWindow(N+1-nFall+j, N, likePar->tukey1, likePar->tukey2);
+  ifo->taperN[slot] = N;
+  ifo->taperRise[slot] = nRise;
+  ifo->taperFall[slot] = nFall;
+  
+  return slot;
+} // End of taperWindow()
 // ****************************************************************************************************************************************************  
 
 
@@ -126,45 +469,424 @@ void waveformTemplate(struct parSet *par, struct interferometer *ifo[], int ifon
  * 
  * Compute a spinning, 'simple-precession' template in restricted 1.5PN order with 1 spin (Apostolatos et al., 1994, PhRvD..49.6274A).
  * The output vector ifo[ifonr]->FTin is of length ifo[ifonr]->samplesize,  starting at 'tstart'(?) and with resolution ifo[ifonr]->samplerate.
+ * 
+ * This is a blocked version of templateApostolatosScalar(), which is kept as the reference.  A first, cheap pass over the samples
+ * computes the orbital frequency and finds the samples where the template is non-zero, with the same termination criteria.  The
+ * second pass processes those samples in blocks of apoBlockSize, with one loop per step, so that the compiler can vectorise the 
+ * arithmetic and (with a vector maths library) the remaining transcendental functions.  The vector algebra with the constant 
+ * vectors is reduced to dot products computed once per template, the powers of tau use square roots, and the polarisation angle
+ * uses sin(2 atan(a/b)) = 2ab/(a^2+b^2).  The results agree with the scalar version to rounding errors (see compareApostolatosTemplates()).
  */
 // ****************************************************************************************************************************************************  
-void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, struct runPar run)
+void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
 {
   
   double pMc=0.0,pEta=0.0,pTc=0.0,pSpin1=0.0,pSpCosTh1=0.0,pRA=0.0,pSinDec=0.0,pPhase=0.0,pSinThJ0=0.0,pPhiJ0=0.0,pSpPhi1=0.0;
   double pLongi=0.0,pDl=0.0; //,pLogDl=0.0;
   
   if(injectionWF==1) {                                               // Then this is an injection waveform template:
-    pMc       = par->par[run.injRevID[61]];                                           // 61: Mc
-    pEta      = par->par[run.injRevID[62]];                                           // 62: eta
-    pTc       = par->par[run.injRevID[11]];                                           // 11: t_c
-    if(run.injParUse[21]) pDl = exp(log(par->par[run.injRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
-    if(run.injParUse[22]) pDl = exp(par->par[run.injRevID[22]]);                      // 22: log(d_L) -> d_L
-    //pLogDl    = par->par[run.injRevID[22]];                                           // 22: log(d_L) 
-    pSpin1    = par->par[run.injRevID[71]];                                           // 71: a_spin1
-    pSpCosTh1 = par->par[run.injRevID[72]];                                           // 72: cos(theta_spin1)
-    pRA       = par->par[run.injRevID[31]];                                           // 31: RA
-    pSinDec   = par->par[run.injRevID[32]];                                           // 32: sin(Dec)
-    pPhase    = par->par[run.injRevID[41]];                                           // 41: phi_c
-    pSinThJ0  = par->par[run.injRevID[53]];                                           // 53: sin(theta_J0)
-    pPhiJ0    = par->par[run.injRevID[54]];                                           // 54: phi_J0
-    pSpPhi1   = par->par[run.injRevID[73]];                                           // 73: phi_spin1    
+    pMc       = par->par[likePar->injRevID[61]];                                           // 61: Mc
+    pEta      = par->par[likePar->injRevID[62]];                                           // 62: eta
+    pTc       = par->par[likePar->injRevID[11]];                                           // 11: t_c
+    if(likePar->injParUse[21]) pDl = exp(log(par->par[likePar->injRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
+    if(likePar->injParUse[22]) pDl = exp(par->par[likePar->injRevID[22]]);                      // 22: log(d_L) -> d_L
+    //pLogDl    = par->par[likePar->injRevID[22]];                                           // 22: log(d_L) 
+    pSpin1    = par->par[likePar->injRevID[71]];                                           // 71: a_spin1
+    pSpCosTh1 = par->par[likePar->injRevID[72]];                                           // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->injRevID[31]];                                           // 31: RA
+    pSinDec   = par->par[likePar->injRevID[32]];                                           // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                           // 41: phi_c
+    pSinThJ0  = par->par[likePar->injRevID[53]];                                           // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->injRevID[54]];                                           // 54: phi_J0
+    pSpPhi1   = par->par[likePar->injRevID[73]];                                           // 73: phi_spin1    
     
   } else {                                                           // Then this is an MCMC waveform template:
-    pMc       = par->par[run.parRevID[61]];                                           // 61: Mc
-    pEta      = par->par[run.parRevID[62]];                                           // 62: eta
-    pTc       = par->par[run.parRevID[11]];                                           // 11: t_c
-    if(run.mcmcParUse[21]) pDl = exp(log(par->par[run.parRevID[21]]/3.0));             // 21: (d_L)^3 -> d_L
-    if(run.mcmcParUse[22]) pDl = exp(par->par[run.parRevID[22]]);                      // 22: log(d_L) -> d_L
-    //pLogDl    = par->par[run.parRevID[22]];                                           // 22: log(d_L) 
-    pSpin1    = par->par[run.parRevID[71]];                                           // 71: a_spin1            
-    pSpCosTh1 = par->par[run.parRevID[72]];                                           // 72: cos(theta_spin1)
-    pRA       = par->par[run.parRevID[31]];                                           // 31: RA
-    pSinDec   = par->par[run.parRevID[32]];                                           // 32: sin(Dec)     
-    pPhase    = par->par[run.parRevID[41]];                                           // 41: phi_c           
-    pSinThJ0  = par->par[run.parRevID[53]];                                           // 53: sin(theta_J0)
-    pPhiJ0    = par->par[run.parRevID[54]];                                           // 54: phi_J0          
-    pSpPhi1   = par->par[run.parRevID[73]];                                           // 73: phi_spin1    
+    pMc       = par->par[likePar->parRevID[61]];                                           // 61: Mc
+    pEta      = par->par[likePar->parRevID[62]];                                           // 62: eta
+    pTc       = par->par[likePar->parRevID[11]];                                           // 11: t_c
+    if(likePar->mcmcParUse[21]) pDl = exp(log(par->par[likePar->parRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
+    if(likePar->mcmcParUse[22]) pDl = exp(par->par[likePar->parRevID[22]]);                      // 22: log(d_L) -> d_L
+    //pLogDl    = par->par[likePar->parRevID[22]];                                           // 22: log(d_L) 
+    pSpin1    = par->par[likePar->parRevID[71]];                                           // 71: a_spin1            
+    pSpCosTh1 = par->par[likePar->parRevID[72]];                                           // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->parRevID[31]];                                           // 31: RA
+    pSinDec   = par->par[likePar->parRevID[32]];                                           // 32: sin(Dec)     
+    pPhase    = par->par[likePar->parRevID[41]];                                           // 41: phi_c           
+    pSinThJ0  = par->par[likePar->parRevID[53]];                                           // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->parRevID[54]];                                           // 54: phi_J0          
+    pSpPhi1   = par->par[likePar->parRevID[73]];                                           // 73: phi_spin1    
+  }
+  
+  pLongi    = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);   // RA -> 'lon'
+  
+  
+  int i=0, k=0, i0=0, n=0, i1=-1, i2=-1, i2a=0, terminate=0;
+  double Mc=0.0, m1=0.0, m2=0.0, Mtot=0.0, mu=0.0, spin=0.0;
+  double localtc    = par->loctc[ifonr];
+  double altitude   = par->localti[ifonr];
+  double azimuth    = par->locazi[ifonr];
+  double samplerate = (double)ifo[ifonr]->samplerate;
+  double inversesamplerate = 1.0/samplerate;
+  int length        = ifo[ifonr]->samplesize;
+  double *FTin      = ifo[ifonr]->FTin;
+  
+  double n_z[3] = {0.0,0.0,1.0};                                                                                         // North in global coordinates
+  double normalvec[3];
+  for(i=0;i<3;i++) normalvec[i] = ifo[ifonr]->normalvec[i];                                                              // Detector position normal vector = local zenith vector z'
+  double D_L = pDl*Mpcs;                                                                                                 // Source luminosity distance, in seconds
+  double coslati = sqrt(1.0-pSinDec*pSinDec);
+  double n_N[3] = { cos(pLongi)*coslati , sin(pLongi)*coslati , pSinDec };                                               // n_N: Position unit vector = N^
+  
+  double sthJ0   = pSinThJ0;                                                                                             // n_J0: 'total' AM unit vector, J0^  (almost equal to the real J, see Eq.15)
+  double cthJ0   = sqrt(1.0 - sthJ0*sthJ0);
+  double n_J0[3] = { cos(pPhiJ0)*cthJ0 , sin(pPhiJ0)*cthJ0 , sthJ0 };                                                    // Here, theta_Jo is a latitude-like angle like Dec (-pi/2-pi/2).
+  
+  par->NdJ = dotProduct(n_N,n_J0);                                                                                       // Inclination of J_0; only for printing purposes
+  
+  //Get individual masses from Mch and eta:
+  Mc = pMc*M0;                                                                                                           // Chirp mass in seconds
+  McEta2masses(Mc, pEta, &m1, &m2);                                                                                      //Mc,eta->M1,M2; accepts 0.25<eta<0.50
+  Mtot = m1+m2;
+  if(pEta>0.25) pEta = 0.5 - pEta;
+  mu = m1*m2/Mtot;                                                                                                       // Eq.16b
+  spin = pSpin1*m1*m1;
+  
+  double beta = 1.0/12.0*(113.0*(m1*m1)/(Mtot*Mtot) + 75.0*pEta)*pSpCosTh1*spin/(m1*m1);                                 // Eq.20
+  double cst1 = 743.0/336.0 + 11.0/4.0*pEta;
+  double cst2 = (4.0*pi-beta);
+  double cst5 = spin*sqrt(1.0-pSpCosTh1*pSpCosTh1);
+  
+  // Constant vectors for Eq.41e and Eq.12, see templateApostolatosScalar():
+  double cvec1[3], cvec2[3], cvec3[3], zxN[3];
+  for(i=0;i<3;i++) cvec1[i] = (n_z[i] - n_J0[i]*sthJ0)/cthJ0;                                                           //cvec1 = (n_z - J0^*cos(theta_J0))/sin(theta_J0)
+  crossProduct(n_J0,n_z,cvec2);
+  for(i=0;i<3;i++) cvec2[i] /= cthJ0;                                                                                   //cvec2 = (J0^ x z^) / sin(theta_J0)
+  for(i=0;i<3;i++) cvec3[i] = normalvec[i] - n_N[i]*dotProduct(normalvec,n_N);                                         //cvec3 = z^' - N^(z^'.N^)
+  crossProduct(normalvec,n_N,zxN);                                                                                       //zxN = z^' x N^, so that N^.(n_L x z^') = n_L.zxN
+  
+  // Eq.59: n_L = J0^ cos(lambda_L) + sin(lambda_L) (cvec1 cos(alpha) + cvec2 sin(alpha)), hence every dot product of n_L with a constant 
+  //   vector v is cos(lambda_L) J0^.v + sin(lambda_L) (cvec1.v cos(alpha) + cvec2.v sin(alpha)):
+  double JdN = dotProduct(n_J0,n_N),  c1dN = dotProduct(cvec1,n_N),  c2dN = dotProduct(cvec2,n_N);
+  double Jd3 = dotProduct(n_J0,cvec3), c1d3 = dotProduct(cvec1,cvec3), c2d3 = dotProduct(cvec2,cvec3);
+  double JdZ = dotProduct(n_J0,zxN),  c1dZ = dotProduct(cvec1,zxN),  c2dZ = dotProduct(cvec2,zxN);
+  
+  //Construct Eq.8ab, needed for F+,Fx
+  double cosalti   = cos(altitude);
+  double cst6  = 0.5*(1.0+cosalti*cosalti)*cos(2.0*azimuth);
+  double cst7  = cosalti*sin(2.0*azimuth);
+  
+  double omega_low  = pi*ifo[ifonr]->lowCut;   //30 or 40 Hz, translated from f_gw to omega_orb
+  double omega_high = pi*ifo[ifonr]->highCut;  //1600 Hz, translated from f_gw to omega_orb
+  
+  // Constants in the sample loop:
+  double tauFac = pEta/(5.0*Mtot);
+  double omgFac = 1.0/(8.0*Mtot);
+  double phiFac = 2.0/pEta;
+  double m1m2   = m1*m2;
+  double Mtot23 = exp(2.0*c3rd*log(Mtot));
+  double x1     = mu*Mtot;
+  double alpFac = 5.0/(96.0*x1*x1*x1) * (1.0+0.75*m2/m1);
+  double alpSpin = 3.0*pSpCosTh1*spin*spin*spin*(1.0-pSpCosTh1*pSpCosTh1);
+  double hAmp   = 2.0*exp(5.0*c3rd*log(Mc))/D_L;
+  
+  
+  // First pass:  find the samples where the template is non-zero, with the termination criteria of templateApostolatosScalar().
+  //   Clear the previous template first;  the samples outside its support are zero already:
+  double t=0.0, tau18=0.0, tau_18=0.0, tau_38=0.0, omega_orb=0.0, oldomega=-1.e30;
+  setTemplateSupport(ifo[ifonr], 0, -1);
+  for(i=0; i<length; ++i){
+    t = localtc - ((double)i)*inversesamplerate;                                                                        // (time to t_c) = "(t_c-t)" in (4.17)
+    if(t<0.0) {
+      if(terminate==0) terminate = 1;
+    } else {
+      tau18  = sqrt(sqrt(sqrt(tauFac*t)));                                                                               //tau^(1/8)
+      tau_18 = 1.0/tau18;
+      tau_38 = tau_18*tau_18*tau_18;
+      omega_orb = omgFac * (tau_38 + 0.125*cst1*tau_38*tau_18*tau_18 - 0.075*cst2*tau_38*tau_38);                        // Orbital frequency
+    }
+    
+    if((omega_orb>=omega_low) && (terminate==0)) {
+      if(omega_orb < oldomega || omega_orb >= omega_high){                                                             // Frequency starts decreasing, or higher than highCut
+        if(omega_orb < oldomega) terminate = 2;
+        if(omega_orb >= omega_high) terminate = 3;
+      } else {
+        if(i1<0) i1 = i;
+        i2 = i;
+        oldomega = omega_orb;
+        FTin[i] = 1.0;                                                                                                   // Mark the sample for the second pass
+      }
+    }
+  }
+  if(i1<0) return;                                                                                                       // No signal in the band
+  ifo[ifonr]->tStart = i1;
+  ifo[ifonr]->tEnd   = i2;
+  
+  
+  // Multirate:  compute the slowly varying amplitudes (including the precession) at knots likePar->multirateCycles GW cycles apart, 
+  //   ending at i2, and interpolate them with cubic splines (MCMC templates only, see setMultirateTemplate()).  Near the ends of the 
+  //   template, where the natural splines are least accurate and the frequency changes fastest, the knots are placed closer together:
+  int multirate = (injectionWF==0 && likePar->multirateCycles>0.0 && i2-i1>=8);
+  int nPoint = i2-i1+1, nKnot=0, step=0;
+  if(multirate) {
+    for(i=i1, nKnot=1; i<i2; nKnot++) {                                                                                // Count the knots
+      tau_18 = 1.0/sqrt(sqrt(sqrt(tauFac*(localtc - ((double)i)*inversesamplerate))));
+      tau_38 = tau_18*tau_18*tau_18;
+      omega_orb = omgFac * (tau_38 + 0.125*cst1*tau_38*tau_18*tau_18 - 0.075*cst2*tau_38*tau_38);
+      step = (int)(likePar->multirateCycles*samplerate*pi/omega_orb);                                                  // pi/omega_orb = 1/f_gw
+      step = max(min(step, min(1+(i-i1)/4, 1+(i2-i)/4)), 1);                                                            // Denser towards both ends
+      i = min(i+step, i2);
+    }
+    nPoint = nKnot;
+  }
+  
+  // The work space below is taken from the scratch arena of the IFO, and released on return:
+  size_t scratchMark = ifo[ifonr]->scratchUsed;
+  int *knot = NULL;
+  double *kLdotN=NULL, *kPolA=NULL, *kPolB=NULL, *kTaperx=NULL;
+  if(multirate) {
+    knot    = (int*)scratchAlloc(ifo[ifonr], sizeof(int)*nKnot);
+    kLdotN  = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+    kPolA   = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+    kPolB   = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+    kTaperx = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+    for(i=i1, k=0; k<nKnot; k++) {
+      knot[k] = i;
+      tau_18 = 1.0/sqrt(sqrt(sqrt(tauFac*(localtc - ((double)i)*inversesamplerate))));
+      tau_38 = tau_18*tau_18*tau_18;
+      omega_orb = omgFac * (tau_38 + 0.125*cst1*tau_38*tau_18*tau_18 - 0.075*cst2*tau_38*tau_38);
+      step = (int)(likePar->multirateCycles*samplerate*pi/omega_orb);
+      step = max(min(step, min(1+(i-i1)/4, 1+(i2-i)/4)), 1);
+      i = min(i+step, i2);
+    }
+  }
+  
+  
+  // Second pass, in blocks of samples (full rate) or knots (multirate):
+  double *taperx = multirate ? NULL : (double*)scratchAlloc(ifo[ifonr], sizeof(double)*(i2-i1+1));
+  double tau28[apoBlockSize], tau38[apoBlockSize], tau58[apoBlockSize], omg[apoBlockSize], phi_gw[apoBlockSize];
+  double l_L[apoBlockSize], g[apoBlockSize], cst4[apoBlockSize], asinhArg[apoBlockSize], alpha[apoBlockSize];
+  double cosAlpha[apoBlockSize], sinAlpha[apoBlockSize], cosPhi[apoBlockSize], sinPhi[apoBlockSize];
+  double x=0.0, slamL=0.0, clamL=0.0, LdotN=0.0, polA=0.0, polB=0.0, sin2polar=0.0, cos2polar=0.0, x3=0.0, Aplus=0.0, Across=0.0;
+  
+  for(i0=0; i0<nPoint; i0+=apoBlockSize) {
+    n = min(apoBlockSize, nPoint-i0);
+    
+    // Powers of tau, orbital frequency and GW phase:
+    for(k=0; k<n; k++) {
+      t         = localtc - ((double)(multirate ? knot[i0+k] : i1+i0+k))*inversesamplerate;
+      tau18     = sqrt(sqrt(sqrt(tauFac*t)));
+      tau28[k]  = tau18*tau18;
+      tau38[k]  = tau28[k]*tau18;
+      tau58[k]  = tau28[k]*tau38[k];
+      tau_18    = 1.0/tau18;
+      tau_38    = tau_18*tau_18*tau_18;
+      omg[k]    = omgFac * (tau_38 + 0.125*cst1*tau_38*tau_18*tau_18 - 0.075*cst2*tau_38*tau_38);
+      phi_gw[k] = pPhase - phiFac * (tau58[k] + 0.625*c3rd*cst1*tau38[k] - 0.1875*cst2*tau28[k]);                   // GW phase, see templateApostolatosScalar()
+    }
+    
+    // (Mtot*w)^(1/3), for the orbital A.M. and v_orb^2:
+    for(k=0; k<n; k++) l_L[k] = cbrt(Mtot*omg[k]);
+    
+    for(k=0; k<n; k++) {
+      if(multirate) {
+        kTaperx[i0+k] = l_L[k]*l_L[k];
+      } else {
+        taperx[i0+k] = l_L[k]*l_L[k];                                                                                   // x := (Mtot*w)^(2/3)  =  v_orb^2
+      }
+      omg[k]    = l_L[k]*l_L[k]/Mtot23;                                                                                 //w^(2/3)
+      l_L[k]    = m1m2/l_L[k];                                                                                          // Orbital A.M.
+      x         = spin/l_L[k];                                                                                          //Y = |S|/|L|, Eq.43
+      g[k]      = sqrt(1.0 + 2.0*pSpCosTh1*x + x*x);                                                                   //G, Eq.46
+      cst4[k]   = l_L[k] + pSpCosTh1*spin;
+      asinhArg[k] = cst4[k]/cst5;
+    }
+    
+    for(k=0; k<n; k++) asinhArg[k] = asinh(asinhArg[k]);
+    
+    for(k=0; k<n; k++) {
+      x = g[k]*l_L[k];
+      alpha[k] = pSpPhi1 - alpFac * (2.0*x*x*x - 3.0*pSpCosTh1*spin*cst4[k]*x - alpSpin*asinhArg[k]);                 //Eq.47
+    }
+    
+    for(k=0; k<n; k++) cosAlpha[k] = cos(alpha[k]);
+    for(k=0; k<n; k++) sinAlpha[k] = sin(alpha[k]);
+    if(!multirate) {
+      for(k=0; k<n; k++) cosPhi[k] = cos(phi_gw[k]);
+      for(k=0; k<n; k++) sinPhi[k] = sin(phi_gw[k]);
+    }
+    
+    // Orientation, polarisation and the amplitudes of cos(phi_gw) and sin(phi_gw) in the detector signal:
+    for(k=0; k<n; k++) {
+      slamL = cst5/(l_L[k]*g[k]);                                                                                       //sin(lambda_L), Eq.48a
+      clamL = cst4[k]/(l_L[k]*g[k]);                                                                                    //cos(lambda_L), Eq.48b
+      
+      LdotN = clamL*JdN + slamL*(c1dN*cosAlpha[k] + c2dN*sinAlpha[k]);                                                  //L^.N^
+      polA  = clamL*Jd3 + slamL*(c1d3*cosAlpha[k] + c2d3*sinAlpha[k]);                                                  //L^.cvec3
+      polB  = clamL*JdZ + slamL*(c1dZ*cosAlpha[k] + c2dZ*sinAlpha[k]);                                                  //N^.(L^ x z^')
+      
+      if(multirate) {                                                                                                   // The polarisation has kinks, so interpolate its arguments
+        kLdotN[i0+k] = LdotN;
+        kPolA[i0+k]  = polA;
+        kPolB[i0+k]  = polB;
+        continue;
+      }
+      
+      sin2polar = (polA*polA+polB*polB > 0.0) ? 2.0*polA*polB/(polA*polA+polB*polB) : 0.0;                            //sin(2 atan(polA/polB)), Eq.12 of Vecchio
+      cos2polar = sqrt(1.0-sin2polar*sin2polar);
+      
+      x3     = hAmp*omg[k];
+      Aplus  =      x3 * (cst6*cos2polar + cst7*sin2polar) * (1.0 + LdotN*LdotN);                                       //F+ h+ / cos(phi_gw)
+      Across = -2.0*x3 * (-cst6*sin2polar + cst7*cos2polar) * LdotN;                                                    //Fx hx / sin(phi_gw)
+      
+      if(FTin[i1+i0+k] > 0.0) FTin[i1+i0+k] = Aplus*cosPhi[k] + Across*sinPhi[k];
+    }
+  }
+  
+  
+  //Apply tapering at the end of the template;  the taper is exactly 1 for 100(taperx-taperx[i2a]) < -20:
+  i2a = i2 - (int)ceil(2.0*samplerate*pi/oldomega);                                                                     //pi/omega_orb = 1/f_gw = P_gw.  *samplerate: number of points in last GW cycle
+  if(!multirate) {
+    x = (i2a>=i1) ? taperx[i2a-i1] : 0.0;
+    for(i=i1;i<=i2;i++) {
+      if(taperx[i-i1]-x > -0.2) FTin[i] *= 0.5*(1.0 - tanh(100.0*(taperx[i-i1]-x)));
+    }
+    ifo[ifonr]->scratchUsed = scratchMark;
+    return;
+  }
+  
+  x = 0.0;
+  if(i2a>=i1) {
+    tau_18 = 1.0/sqrt(sqrt(sqrt(tauFac*(localtc - ((double)i2a)*inversesamplerate))));
+    tau_38 = tau_18*tau_18*tau_18;
+    x = cbrt(Mtot*omgFac * (tau_38 + 0.125*cst1*tau_38*tau_18*tau_18 - 0.075*cst2*tau_38*tau_38));
+    x = x*x;
+  }
+  
+  // Multirate:  interpolate L^.N^, the arguments of the polarisation angle and v_orb^2 onto the samples with natural cubic splines.
+  //   The phase is computed exactly, since it needs only square roots:
+  double *d2LdotN    = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+  double *d2PolA     = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+  double *d2PolB     = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+  double *d2Taperx   = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+  double *splineWork = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*nKnot);
+  cubicSplineSetup(knot, kLdotN, nKnot, d2LdotN, splineWork);
+  cubicSplineSetup(knot, kPolA, nKnot, d2PolA, splineWork);
+  cubicSplineSetup(knot, kPolB, nKnot, d2PolB, splineWork);
+  cubicSplineSetup(knot, kTaperx, nKnot, d2Taperx, splineWork);
+  
+  double h=0.0, a=0.0, b=0.0, ca=0.0, cb=0.0, phi=0.0, tx=0.0;
+  for(k=0; k<nKnot-1; k++) {
+    h = (double)(knot[k+1]-knot[k]);
+    for(i=knot[k]; i<knot[k+1] || (k==nKnot-2 && i==i2); i++) {
+      if(FTin[i] <= 0.0) continue;                                                                                       // Not marked in the first pass
+      a  = (double)(knot[k+1]-i)/h;
+      b  = 1.0-a;
+      ca = (a*a*a-a)*h*h/6.0;
+      cb = (b*b*b-b)*h*h/6.0;
+      tau18  = sqrt(sqrt(sqrt(tauFac*(localtc - ((double)i)*inversesamplerate))));
+      tau28[0] = tau18*tau18;
+      tau38[0] = tau28[0]*tau18;
+      phi    = pPhase - phiFac * (tau28[0]*tau38[0] + 0.625*c3rd*cst1*tau38[0] - 0.1875*cst2*tau28[0]);           // GW phase
+      LdotN  = a*kLdotN[k]  + b*kLdotN[k+1]  + ca*d2LdotN[k]  + cb*d2LdotN[k+1];
+      polA   = a*kPolA[k]   + b*kPolA[k+1]   + ca*d2PolA[k]   + cb*d2PolA[k+1];
+      polB   = a*kPolB[k]   + b*kPolB[k+1]   + ca*d2PolB[k]   + cb*d2PolB[k+1];
+      tx     = a*kTaperx[k] + b*kTaperx[k+1] + ca*d2Taperx[k] + cb*d2Taperx[k+1];
+      
+      sin2polar = (polA*polA+polB*polB > 0.0) ? 2.0*polA*polB/(polA*polA+polB*polB) : 0.0;
+      cos2polar = sqrt(1.0-sin2polar*sin2polar);
+      x3     = hAmp*tx/Mtot23;                                                                                          //h_0 w^(2/3)
+      Aplus  =      x3 * (cst6*cos2polar + cst7*sin2polar) * (1.0 + LdotN*LdotN);
+      Across = -2.0*x3 * (-cst6*sin2polar + cst7*cos2polar) * LdotN;
+      FTin[i] = Aplus*cos(phi) + Across*sin(phi);
+      if(tx-x > -0.2) FTin[i] *= 0.5*(1.0 - tanh(100.0*(tx-x)));
+    }
+  }
+  
+  ifo[ifonr]->scratchUsed = scratchMark;
+} // End of templateApostolatos()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the second derivatives of a natural cubic spline through the points (x[i],y[i]), i=0..n-1
+ * 
+ * x must be strictly increasing (here: sample indices).  work must have room for n doubles.  The spline between x[k] and x[k+1]
+ * is then y = a y[k] + b y[k+1] + ((a^3-a) y2[k] + (b^3-b) y2[k+1]) h^2/6, with h = x[k+1]-x[k] and a = (x[k+1]-x)/h = 1-b.
+ */
+// ****************************************************************************************************************************************************  
+void cubicSplineSetup(const int *x, const double *y, int n, double *y2, double *work)
+{
+  int i=0;
+  double sig=0.0, p=0.0;
+  
+  y2[0] = 0.0;
+  work[0] = 0.0;
+  for(i=1; i<n-1; i++) {                                                                                                // Tridiagonal system, forward sweep
+    sig = (double)(x[i]-x[i-1]) / (double)(x[i+1]-x[i-1]);
+    p = sig*y2[i-1] + 2.0;
+    y2[i] = (sig-1.0)/p;
+    work[i] = (y[i+1]-y[i])/(double)(x[i+1]-x[i]) - (y[i]-y[i-1])/(double)(x[i]-x[i-1]);
+    work[i] = (6.0*work[i]/(double)(x[i+1]-x[i-1]) - sig*work[i-1])/p;
+  }
+  y2[n-1] = 0.0;
+  for(i=n-2; i>=0; i--) y2[i] = y2[i]*y2[i+1] + work[i];                                                              // Back substitution
+  
+} // End of cubicSplineSetup()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute an Apostolatos, 12-parameter, single spin, simple-precession waveform - scalar reference version
+ * 
+ * Compute a spinning, 'simple-precession' template in restricted 1.5PN order with 1 spin (Apostolatos et al., 1994, PhRvD..49.6274A).
+ * The output vector ifo[ifonr]->FTin is of length ifo[ifonr]->samplesize,  starting at 'tstart'(?) and with resolution ifo[ifonr]->samplerate.
+ * This is the original, sample-by-sample version, kept as the reference for templateApostolatos();  see compareApostolatosTemplates().
+ */
+// ****************************************************************************************************************************************************  
+void templateApostolatosScalar(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar)
+{
+  
+  double pMc=0.0,pEta=0.0,pTc=0.0,pSpin1=0.0,pSpCosTh1=0.0,pRA=0.0,pSinDec=0.0,pPhase=0.0,pSinThJ0=0.0,pPhiJ0=0.0,pSpPhi1=0.0;
+  double pLongi=0.0,pDl=0.0; //,pLogDl=0.0;
+  
+  if(injectionWF==1) {                                               // Then this is an injection waveform template:
+    pMc       = par->par[likePar->injRevID[61]];                                           // 61: Mc
+    pEta      = par->par[likePar->injRevID[62]];                                           // 62: eta
+    pTc       = par->par[likePar->injRevID[11]];                                           // 11: t_c
+    if(likePar->injParUse[21]) pDl = exp(log(par->par[likePar->injRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
+    if(likePar->injParUse[22]) pDl = exp(par->par[likePar->injRevID[22]]);                      // 22: log(d_L) -> d_L
+    //pLogDl    = par->par[likePar->injRevID[22]];                                           // 22: log(d_L) 
+    pSpin1    = par->par[likePar->injRevID[71]];                                           // 71: a_spin1
+    pSpCosTh1 = par->par[likePar->injRevID[72]];                                           // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->injRevID[31]];                                           // 31: RA
+    pSinDec   = par->par[likePar->injRevID[32]];                                           // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                           // 41: phi_c
+    pSinThJ0  = par->par[likePar->injRevID[53]];                                           // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->injRevID[54]];                                           // 54: phi_J0
+    pSpPhi1   = par->par[likePar->injRevID[73]];                                           // 73: phi_spin1    
+    
+  } else {                                                           // Then this is an MCMC waveform template:
+    pMc       = par->par[likePar->parRevID[61]];                                           // 61: Mc
+    pEta      = par->par[likePar->parRevID[62]];                                           // 62: eta
+    pTc       = par->par[likePar->parRevID[11]];                                           // 11: t_c
+    if(likePar->mcmcParUse[21]) pDl = exp(log(par->par[likePar->parRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
+    if(likePar->mcmcParUse[22]) pDl = exp(par->par[likePar->parRevID[22]]);                      // 22: log(d_L) -> d_L
+    //pLogDl    = par->par[likePar->parRevID[22]];                                           // 22: log(d_L) 
+    pSpin1    = par->par[likePar->parRevID[71]];                                           // 71: a_spin1            
+    pSpCosTh1 = par->par[likePar->parRevID[72]];                                           // 72: cos(theta_spin1)
+    pRA       = par->par[likePar->parRevID[31]];                                           // 31: RA
+    pSinDec   = par->par[likePar->parRevID[32]];                                           // 32: sin(Dec)     
+    pPhase    = par->par[likePar->parRevID[41]];                                           // 41: phi_c           
+    pSinThJ0  = par->par[likePar->parRevID[53]];                                           // 53: sin(theta_J0)
+    pPhiJ0    = par->par[likePar->parRevID[54]];                                           // 54: phi_J0          
+    pSpPhi1   = par->par[likePar->parRevID[73]];                                           // 73: phi_spin1    
   }
   
   pLongi    = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);   // RA -> 'lon'
@@ -195,7 +917,7 @@ void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int i
   }
   
   //for(i=0;i<100;i++) {
-  // printf("  %5i  %5i  %5i  %5i  %s\n",i,run.parDef[i],run.mcmcParUse[i],run.injParUse[i],run.parAbrev[i]);
+  // printf("  %5i  %5i  %5i\n",i,likePar->mcmcParUse[i],likePar->injParUse[i]);
   //}
   
   localtc    = par->loctc[ifonr];
@@ -289,13 +1011,16 @@ void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int i
   double omega_orb=0.0,l_L=0.0,Y=0.0,Gsq=0.0,g=0.0,slamL=0.0,clamL=0.0,LdotN=0.0;
   double hplus=0.0,hcross=0.0,locpolar=0.0,sin2polar=0.0,cos2polar=0.0,Fplus=0.0,Fcross=0.0;
   double cst4=0.0,x1=0.0,x2=0.0,x3=0.0;
-  double taperx[length],omegas[length];
+  size_t scratchMark = ifo[ifonr]->scratchUsed;
+  double *taperx = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*length);
+  double *omegas = (double*)scratchAlloc(ifo[ifonr], sizeof(double)*length);
   for(i=0;i<length;i++) {
     taperx[i] = 0.0;
     omegas[i] = 0.0;
   }
   
   // Fill ifo[ifonr]->FTin with time-domain template:
+  ifo[ifonr]->tStart = -1;                      // All samples are written;  the support is not recorded
   for(i=0; i<length; ++i){
     // Determine time left until coalescence, "(t_c-t)" in (4.17)/(11):
     t = localtc - ((double)i)*inversesamplerate;  // (time to t_c) = "(t_c-t)" in (4.17)
@@ -427,7 +1152,261 @@ void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int i
     ifo[ifonr]->FTin[i] *= 0.5*(1.0 - tanh(100.0*(taperx[i]-taperx[i2a])));  //Taper end of template
   }
   
-} // End of templateApostolatos()
+  ifo[ifonr]->scratchUsed = scratchMark;
+} // End of templateApostolatosScalar()
+// ****************************************************************************************************************************************************  
+
+
+
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute a non-spinning stationary-phase (TaylorF2) template in the frequency domain
+ * 
+ * Uses the same 9 parameters as the LAL non-spinning template (waveformVersion 4), with either d_L^3 or log(d_L) and Mc or Mc^(1/6).
+ * The phase is computed up to the pN order of the template (at most 3.5 pN), the amplitude at Newtonian order.  The template 
+ * is cut off at the ISCO frequency or at highCut, whichever is lower.  The result is multiplied by the sampling rate, so that it
+ * matches the FFT of a time-domain template in FTout;  see waveformTemplateFD().
+ * The template is computed at the nFreq frequencies freq[] and stored in h as (re,im) pairs.
+ */
+// ****************************************************************************************************************************************************  
+void templateTaylorF2(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                      const double *freq, int nFreq, double *h)
+{
+  double pMc=0.0,pEta=0.0,pTc=0.0,pDl=0.0,pRA=0.0,pSinDec=0.0,pPhase=0.0,pCosI=0.0,pPsi=0.0,PNorder=0.0;
+  
+  if(injectionWF==1) {                                               // Then this is an injection waveform template
+    pTc       = par->par[likePar->injRevID[11]];                                            // 11: t_c
+    if(likePar->injParUse[21]) pDl = exp(log(par->par[likePar->injRevID[21]])/3.0);             // 21: (d_L)^3 -> d_L
+    if(likePar->injParUse[22]) pDl = exp(par->par[likePar->injRevID[22]]);                      // 22: log(d_L) -> d_L
+    if(likePar->injParUse[61]) pMc = par->par[likePar->injRevID[61]];                           // 61: Mc
+    if(likePar->injParUse[65]) pMc = pow(par->par[likePar->injRevID[65]],6);                    // 65: Mc^(1/6) -> Mc
+    pEta      = par->par[likePar->injRevID[62]];                                            // 62: eta
+    pRA       = par->par[likePar->injRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->injRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->injRevID[51]];                                            // 51: cos(inclination)
+    pPsi      = par->par[likePar->injRevID[52]];                                            // 52: psi: polarisation angle
+    PNorder   = likePar->injectionPNorder;                                                  // Post-Newtonian order
+  } else {                                                           // Then this is an MCMC waveform template
+    pTc       = par->par[likePar->parRevID[11]];                                            // 11: t_c
+    if(likePar->mcmcParUse[21]) pDl = exp(log(par->par[likePar->parRevID[21]])/3.0);            // 21: (d_L)^3 -> d_L
+    if(likePar->mcmcParUse[22]) pDl = exp(par->par[likePar->parRevID[22]]);                     // 22: log(d_L) -> d_L
+    if(likePar->mcmcParUse[61]) pMc = par->par[likePar->parRevID[61]];                          // 61: Mc
+    if(likePar->mcmcParUse[65]) pMc = pow(par->par[likePar->parRevID[65]],6);                   // 65: Mc^(1/6) -> Mc
+    pEta      = par->par[likePar->parRevID[62]];                                            // 62: eta
+    pRA       = par->par[likePar->parRevID[31]];                                            // 31: RA
+    pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)
+    pPhase    = par->par[likePar->parRevID[41]];                                            // 41: phi_c - GW phase at coalescence
+    pCosI     = par->par[likePar->parRevID[51]];                                            // 51: cos(inclination)
+    pPsi      = par->par[likePar->parRevID[52]];                                            // 52: psi: polarisation angle
+    PNorder   = likePar->mcmcPNorder;                                                       // Post-Newtonian order
+  }
+  
+  double pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);                              // RA -> 'lon'
+  if(pEta>0.25) pEta = 0.5 - pEta;
+  
+  // Detector response to h_+ = A(f)(1+cos^2 i)/2 e^(-i Psi),  h_x = A(f) i cos(i) e^(-i Psi):
+  double respRe=0.0, respIm=0.0;
+  taylorF2response(ifo[ifonr], pLongi, pSinDec, pPsi, pCosI, &respRe, &respIm);
+  
+  
+  // Masses, amplitude and cut-off frequency, in seconds:
+  double Mc   = pMc*M0;
+  double Mtot = Mc*pow(pEta,-0.6);
+  double D_L  = pDl*Mpcs;
+  double amp  = sqrt(5.0/24.0) * pow(pi,-2.0*c3rd) * pow(Mc,5.0/6.0) / D_L * (double)ifo[ifonr]->samplerate;   // Times samplerate: FFT units
+  double fISCO = 1.0/(pow(6.0,1.5)*pi*Mtot);
+  double fHigh = min(fISCO, ifo[ifonr]->highCut);
+  
+  // Phase coefficients, Psi(f) = 2 pi f t_c - phi_c - pi/4 + 3/(128 eta v^5) sum_k (a_k + b_k log(v)) v^k,  v = (pi Mtot f)^(1/3):
+  double a[8];
+  taylorF2phaseCoefficients(pEta, PNorder, a);
+  double a2=a[0],a3=a[1],a4=a[2],a5=a[3],b5=a[4],a6=a[5],b6=a[6],a7=a[7];
+  
+  double cst1 = 3.0/(128.0*pEta);
+  double cbrtPiM = cbrt(pi*Mtot);
+  double tc = par->loctc[ifonr];                                                            // Local coalescence time, w.r.t. FTstart
+  double phi0 = pPhase + 0.25*pi;
+  
+  
+  // Compute the frequency-domain template, stored as (re,im) pairs:
+  int j=0;
+  double f=0.0,f13=0.0,v=0.0,v2=0.0,logv=0.0,Psi=0.0,Af=0.0,cosPsi=0.0,sinPsi=0.0;
+  for(j=0; j<nFreq; j++) {
+    f = freq[j];
+    if(f>fHigh) {
+      h[2*j] = 0.0;
+      h[2*j+1] = 0.0;
+      continue;
+    }
+    f13  = cbrt(f);
+    v    = cbrtPiM*f13;
+    v2   = v*v;
+    logv = log(v);
+    Psi  = tpi*f*tc - phi0 + cst1/(v2*v2*v) * 
+      (1.0 + v2*(a2 + v*(a3 + v*(a4 + v*((a5+b5*logv) + v*((a6+b6*logv) + v*a7))))));
+    Af   = amp/(f*sqrt(f13));                                                               // A f^(-7/6)
+    cosPsi = cos(Psi);
+    sinPsi = sin(Psi);
+    h[2*j]   = Af*(respRe*cosPsi + respIm*sinPsi);                                         // A(f) (respRe + i respIm) e^(-i Psi)
+    h[2*j+1] = Af*(respIm*cosPsi - respRe*sinPsi);
+  }
+  
+} // End of templateTaylorF2()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the response of detector ifo to the TaylorF2 polarisations, h_+ = (1+cos^2 i)/2 A e^(-i Psi) and h_x = i cos(i) A e^(-i Psi)
+ * 
+ * Project the polarisation axes X,Y of the wave onto the detector arms (as XLALComputeDetAMResponse() does in LAL) to get F_+ and F_x, 
+ * and return F_+ (1+cos^2 i)/2 + i F_x cos(i) in respRe, respIm.
+ */
+// ****************************************************************************************************************************************************  
+void taylorF2response(struct interferometer *ifo, double pLongi, double pSinDec, double pPsi, double pCosI, double *respRe, double *respIm)
+{
+  int i=0;
+  double cosDec = sqrt(1.0-pSinDec*pSinDec);
+  double east[3]  = { -sin(pLongi),        cos(pLongi),        0.0    };                // Unit vectors East and North at the source position on the sky
+  double north[3] = { -cos(pLongi)*pSinDec, -sin(pLongi)*pSinDec, cosDec };
+  double X[3], Y[3];
+  for(i=0;i<3;i++) {
+    X[i] = -cos(pPsi)*east[i] + sin(pPsi)*north[i];
+    Y[i] =  sin(pPsi)*east[i] + cos(pPsi)*north[i];
+  }
+  double rX = dotProduct(ifo->rightvec,X), rY = dotProduct(ifo->rightvec,Y);
+  double lX = dotProduct(ifo->leftvec,X),  lY = dotProduct(ifo->leftvec,Y);
+  double Fplus  = 0.5*(rX*rX - lX*lX - rY*rY + lY*lY);
+  double Fcross = rX*rY - lX*lY;
+  
+  *respRe = Fplus*0.5*(1.0+pCosI*pCosI);
+  *respIm = Fcross*pCosI;
+} // End of taylorF2response()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the coefficients a2,a3,a4,a5,b5,a6,b6,a7 of the TaylorF2 phase (see templateTaylorF2()) in a[0..7], up to pN order PNorder
+ */
+// ****************************************************************************************************************************************************  
+void taylorF2phaseCoefficients(double pEta, double PNorder, double *a)
+{
+  int i=0;
+  double eta2 = pEta*pEta, eta3 = eta2*pEta;
+  for(i=0;i<8;i++) a[i] = 0.0;
+  if(PNorder>=1.0) a[0] = 3715.0/756.0 + 55.0/9.0*pEta;
+  if(PNorder>=1.5) a[1] = -16.0*pi;
+  if(PNorder>=2.0) a[2] = 15293365.0/508032.0 + 27145.0/504.0*pEta + 3085.0/72.0*eta2;
+  if(PNorder>=2.5) {
+    a[3] = pi*(38645.0/756.0 - 65.0/9.0*pEta) * (1.0 + 1.5*log(6.0));                      // 1 - 3 log(v_ISCO)
+    a[4] = pi*(38645.0/756.0 - 65.0/9.0*pEta) * 3.0;
+  }
+  if(PNorder>=3.0) {
+    a[5] = 11583231236531.0/4694215680.0 - 640.0/3.0*pi*pi - 6848.0/21.0*(0.5772156649015329 + log(4.0))   // Euler's gamma
+      + (-15737765635.0/3048192.0 + 2255.0/12.0*pi*pi)*pEta + 76055.0/1728.0*eta2 - 127825.0/1296.0*eta3;
+    a[6] = -6848.0/21.0;
+  }
+  if(PNorder>=3.5) a[7] = pi*(77096675.0/254016.0 + 378515.0/1512.0*pEta - 74045.0/756.0*eta2);
+} // End of taylorF2phaseCoefficients()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the intrinsic part u(f) of a TaylorF2 template, which depends on Mc and eta only
+ * 
+ * The template of templateTaylorF2() factorises as h(f) = u(f) E exp(-2 pi i f t_c,loc), with E the complex factor of 
+ * templateTaylorF2extrinsic().  u(f) is the template for d_L = 1 Mpc, phi_c = 0, t_c,loc = 0 and a unit detector response;  it is computed 
+ * at the nFreq frequencies freq[] and stored in h as (re,im) pairs.  Always an MCMC template (injectionWF is ignored).
+ */
+// ****************************************************************************************************************************************************  
+void templateTaylorF2intrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar,
+                               const double *freq, int nFreq, double *h)
+{
+  double pMc=0.0,pEta=0.0,PNorder=0.0;
+  (void)injectionWF;
+  
+  if(likePar->mcmcParUse[61]) pMc = par->par[likePar->parRevID[61]];                            // 61: Mc
+  if(likePar->mcmcParUse[65]) pMc = pow(par->par[likePar->parRevID[65]],6);                     // 65: Mc^(1/6) -> Mc
+  pEta      = par->par[likePar->parRevID[62]];                                              // 62: eta
+  PNorder   = likePar->mcmcPNorder;                                                         // Post-Newtonian order
+  if(pEta>0.25) pEta = 0.5 - pEta;
+  
+  double Mc   = pMc*M0;
+  double Mtot = Mc*pow(pEta,-0.6);
+  double amp  = sqrt(5.0/24.0) * pow(pi,-2.0*c3rd) * pow(Mc,5.0/6.0) / Mpcs * (double)ifo[ifonr]->samplerate;     // d_L = 1 Mpc
+  double fISCO = 1.0/(pow(6.0,1.5)*pi*Mtot);
+  double fHigh = min(fISCO, ifo[ifonr]->highCut);
+  
+  double a[8];
+  taylorF2phaseCoefficients(pEta, PNorder, a);
+  double a2=a[0],a3=a[1],a4=a[2],a5=a[3],b5=a[4],a6=a[5],b6=a[6],a7=a[7];
+  double cst1 = 3.0/(128.0*pEta);
+  double cbrtPiM = cbrt(pi*Mtot);
+  
+  int j=0;
+  double f=0.0,f13=0.0,v=0.0,v2=0.0,logv=0.0,Psi=0.0,Af=0.0;
+  for(j=0; j<nFreq; j++) {
+    f = freq[j];
+    if(f>fHigh) {
+      h[2*j] = 0.0;
+      h[2*j+1] = 0.0;
+      continue;
+    }
+    f13  = cbrt(f);
+    v    = cbrtPiM*f13;
+    v2   = v*v;
+    logv = log(v);
+    Psi  = -0.25*pi + cst1/(v2*v2*v) * 
+      (1.0 + v2*(a2 + v*(a3 + v*(a4 + v*((a5+b5*logv) + v*((a6+b6*logv) + v*a7))))));
+    Af   = amp/(f*sqrt(f13));
+    h[2*j]   =  Af*cos(Psi);                                                                // A(f) e^(-i Psi)
+    h[2*j+1] = -Af*sin(Psi);
+  }
+  
+} // End of templateTaylorF2intrinsic()
+// ****************************************************************************************************************************************************  
+
+
+
+// ****************************************************************************************************************************************************  
+/**
+ * \brief Compute the complex factor E of the extrinsic parameters of a TaylorF2 template
+ * 
+ * E = (F_+ (1+cos^2 i)/2 + i F_x cos(i)) exp(i phi_c) / (d_L/Mpc), stored as (re,im) in factor;  see templateTaylorF2intrinsic().
+ * localPar() must have been called for par, since the full template needs exp(-2 pi i f t_c,loc) as well.  Always an MCMC template.
+ */
+// ****************************************************************************************************************************************************  
+void templateTaylorF2extrinsic(struct parSet *par, struct interferometer *ifo[], int ifonr, int injectionWF, const struct likelihoodPar *likePar, double *factor)
+{
+  double pTc=0.0,pDl=0.0,pRA=0.0,pSinDec=0.0,pPhase=0.0,pCosI=0.0,pPsi=0.0;
+  double respRe=0.0, respIm=0.0;
+  (void)injectionWF;
+  
+  pTc       = par->par[likePar->parRevID[11]];                                              // 11: t_c
+  if(likePar->mcmcParUse[21]) pDl = exp(log(par->par[likePar->parRevID[21]])/3.0);              // 21: (d_L)^3 -> d_L
+  if(likePar->mcmcParUse[22]) pDl = exp(par->par[likePar->parRevID[22]]);                       // 22: log(d_L) -> d_L
+  pRA       = par->par[likePar->parRevID[31]];                                              // 31: RA
+  pSinDec   = par->par[likePar->parRevID[32]];                                              // 32: sin(Dec)
+  pPhase    = par->par[likePar->parRevID[41]];                                              // 41: phi_c - GW phase at coalescence
+  pCosI     = par->par[likePar->parRevID[51]];                                              // 51: cos(inclination)
+  pPsi      = par->par[likePar->parRevID[52]];                                              // 52: psi: polarisation angle
+  
+  double pLongi = fmod(longitude(pRA, GMST(pTc)) + mtpi, tpi);                              // RA -> 'lon'
+  taylorF2response(ifo[ifonr], pLongi, pSinDec, pPsi, pCosI, &respRe, &respIm);
+  
+  factor[0] = (respRe*cos(pPhase) - respIm*sin(pPhase)) / pDl;
+  factor[1] = (respRe*sin(pPhase) + respIm*cos(pPhase)) / pDl;
+  
+} // End of templateTaylorF2extrinsic()
 // ****************************************************************************************************************************************************  
 
 
@@ -450,7 +1429,7 @@ void templateApostolatos(struct parSet *par, struct interferometer *ifo[], int i
  *    ifo   :  pointer to interferometer data (struct)
  */
 // ****************************************************************************************************************************************************  
-void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize, int injectionWF, struct runPar run)
+void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize, int injectionWF, const struct likelihoodPar *likePar)
 {
 	if(networkSize!=0){ 
   int ifonr=0,j=0;
@@ -458,13 +1437,13 @@ void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize,
   
   double pTc=0.0,pLongi=0.0,pSinDec=0.0;
   if(injectionWF==1) {                                                               // Then this is for an injection waveform template
-    pTc       = par->par[run.injRevID[11]];                                            // 11: Tc
-    pLongi    = fmod(longitude(par->par[run.injRevID[31]], GMST(pTc)) + mtpi, tpi);    // 31: RA;  RA -> 'longitude'
-    pSinDec   = par->par[run.injRevID[32]];                                            // 32: sin(Dec)
+    pTc       = par->par[likePar->injRevID[11]];                                            // 11: Tc
+    pLongi    = fmod(longitude(par->par[likePar->injRevID[31]], GMST(pTc)) + mtpi, tpi);    // 31: RA;  RA -> 'longitude'
+    pSinDec   = par->par[likePar->injRevID[32]];                                            // 32: sin(Dec)
   } else {                                                                           // Then this is for an MCMC waveform template
-    pTc       = par->par[run.parRevID[11]];                                            // 11: Tc
-    pLongi    = fmod(longitude(par->par[run.parRevID[31]], GMST(pTc)) + mtpi, tpi);    // 31: RA;  RA -> 'longitude'
-    pSinDec   = par->par[run.parRevID[32]];                                            // 32: sin(Dec)
+    pTc       = par->par[likePar->parRevID[11]];                                            // 11: Tc
+    pLongi    = fmod(longitude(par->par[likePar->parRevID[31]], GMST(pTc)) + mtpi, tpi);    // 31: RA;  RA -> 'longitude'
+    pSinDec   = par->par[likePar->parRevID[32]];                                            // 32: sin(Dec)
   }
   
   
@@ -472,7 +1451,7 @@ void localPar(struct parSet *par, struct interferometer *ifo[], int networkSize,
   coord2vec(pSinDec, pLongi, lineofsight);
   for(ifonr=0; ifonr<networkSize; ifonr++) {
     scalprod1 =  ifo[ifonr]->positionvec[0]*lineofsight[0]  +  ifo[ifonr]->positionvec[1]*lineofsight[1]  +  ifo[ifonr]->positionvec[2]*lineofsight[2];  // Project line of sight onto positionvec, scalprod1 is in units of metres
-    delay = scalprod1 / c;                                         // Time delay (wrt geocentre) in seconds
+    delay = scalprod1 / cLight;                                    // Time delay (wrt geocentre) in seconds
     par->loctc[ifonr] = ((pTc - ifo[ifonr]->FTstart) - delay);
   }
   